@@ -0,0 +1,341 @@
+/*
+    Interpreter benchmarks for the bundled Duktape build.
+
+    Each workload is a script defining a `run()` function. The script is compiled
+    once, after which `run()` is called repeatedly until the time budget is spent.
+    Results are written to stdout as one JSON object per line so that runs of
+    different Duktape configurations can be collected and compared by tooling.
+
+    Besides the micro-benchmarks below, every `.js` file in the workloads directory
+    is run as well. That corpus holds larger, self-checking programs (Richards,
+    DeltaBlue, JSON, regexps, log scanning, strings, sorting, numeric kernels, typed
+    array copies, UTF-8 text coding and message routing) that are closer to real
+    scripts. Each heap is given a counting allocator, so the peak number of bytes a
+    workload had allocated is reported next to its throughput.
+
+    Usage: squarepine_duktape_interpreter_benchmarks [--filter <substring>] [--seconds <budget>]
+                                                     [--workloads <directory>]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "duktape.h"
+
+namespace
+{
+    //==============================================================================
+    struct Workload final
+    {
+        std::string name, source;
+    };
+
+    const Workload microWorkloads[] =
+    {
+        {
+            "integer-loop",
+            R"JS(
+                function run() {
+                    var sum = 0;
+                    for (var i = 0; i < 1000000; i++) {
+                        sum = (sum + i * 3) % 1000003;
+                    }
+                    return sum;
+                }
+            )JS"
+        },
+        {
+            "bit-manipulation",
+            R"JS(
+                function popcount(x) {
+                    x = x - ((x >>> 1) & 0x55555555);
+                    x = (x & 0x33333333) + ((x >>> 2) & 0x33333333);
+                    return (((x + (x >>> 4)) & 0x0f0f0f0f) * 0x01010101) >>> 24;
+                }
+
+                function run() {
+                    var state = 2463534242, bits = 0;
+                    for (var i = 0; i < 200000; i++) {
+                        state ^= state << 13;
+                        state ^= state >>> 17;
+                        state ^= state << 5;
+                        bits += popcount(state >>> 0);
+                    }
+                    return bits;
+                }
+            )JS"
+        },
+        {
+            "array-indexing",
+            R"JS(
+                function run() {
+                    var n = 100000, sieve = new Array(n), count = 0;
+                    for (var i = 0; i < n; i++) {
+                        sieve[i] = 1;
+                    }
+                    for (var p = 2; p * p < n; p++) {
+                        if (sieve[p]) {
+                            for (var j = p * p; j < n; j += p) {
+                                sieve[j] = 0;
+                            }
+                        }
+                    }
+                    for (var k = 2; k < n; k++) {
+                        count += sieve[k];
+                    }
+                    return count;
+                }
+            )JS"
+        },
+        {
+            "float-loop",
+            R"JS(
+                function run() {
+                    var acc = 0.5;
+                    for (var i = 0; i < 500000; i++) {
+                        acc = acc * 1.0000001 + 0.25 / (i + 1);
+                    }
+                    return acc;
+                }
+            )JS"
+        }
+    };
+
+    /** Adds a workload for every `.js` file in a directory, in name order. */
+    void addCorpusWorkloads (std::vector<Workload>& workloads, const char* directory)
+    {
+        std::error_code error;
+        std::vector<std::filesystem::path> files;
+
+        for (const auto& entry : std::filesystem::directory_iterator (directory, error))
+            if (entry.is_regular_file() && entry.path().extension() == ".js")
+                files.push_back (entry.path());
+
+        if (error)
+            std::fprintf (stderr, "Couldn't read the workloads in %s: %s\n", directory, error.message().c_str());
+
+        std::sort (files.begin(), files.end());
+
+        for (const auto& file : files)
+        {
+            std::ifstream stream (file, std::ios::binary);
+            std::ostringstream source;
+            source << stream.rdbuf();
+
+            workloads.push_back ({ file.stem().string(), source.str() });
+        }
+    }
+
+    //==============================================================================
+    /** Wraps malloc so that each heap's current and peak allocated sizes are known.
+        Every block is prefixed with its size, padded to keep the payload aligned.
+    */
+    struct HeapUsage final
+    {
+        size_t current = 0, peak = 0;
+
+        static constexpr size_t headerSize = alignof (std::max_align_t);
+        static_assert (headerSize >= sizeof (size_t), "The header must fit a size");
+
+        static size_t getSize (void* ptr)
+        {
+            size_t size = 0;
+            std::memcpy (&size, static_cast<char*> (ptr) - headerSize, sizeof (size));
+            return size;
+        }
+
+        void* track (void* block, size_t size)
+        {
+            if (block == nullptr)
+                return nullptr;
+
+            std::memcpy (block, &size, sizeof (size));
+            current += size;
+            peak = std::max (peak, current);
+            return static_cast<char*> (block) + headerSize;
+        }
+
+        static void* allocate (void* udata, duk_size_t size)
+        {
+            return static_cast<HeapUsage*> (udata)->track (std::malloc (size + headerSize), size);
+        }
+
+        static void* reallocate (void* udata, void* ptr, duk_size_t size)
+        {
+            if (ptr == nullptr)
+                return allocate (udata, size);
+
+            auto& usage = *static_cast<HeapUsage*> (udata);
+            const auto oldSize = getSize (ptr);
+            auto* block = std::realloc (static_cast<char*> (ptr) - headerSize, size + headerSize);
+
+            if (block == nullptr)
+                return nullptr;
+
+            usage.current -= oldSize;
+            return usage.track (block, size);
+        }
+
+        static void release (void* udata, void* ptr)
+        {
+            if (ptr == nullptr)
+                return;
+
+            static_cast<HeapUsage*> (udata)->current -= getSize (ptr);
+            std::free (static_cast<char*> (ptr) - headerSize);
+        }
+    };
+
+    //==============================================================================
+    /** Names the Duktape options this executable was built with, e.g. "fastint+propcache". */
+    std::string getConfigurationName()
+    {
+        std::string name;
+
+        const auto addOption = [&name] (const char* option)
+        {
+            name += (name.empty() ? "" : "+") + std::string (option);
+        };
+
+        (void) addOption; // Unused when none of the options are on
+
+       #if defined (DUK_USE_FASTINT)
+        addOption ("fastint");
+       #endif
+       #if defined (DUK_USE_JSON_STRINGIFY_FASTPATH)
+        addOption ("jsonfastpath");
+       #endif
+       #if defined (DUK_USE_EXEC_PROPCACHE_SIZE)
+        addOption ("propcache");
+       #endif
+       #if defined (DUK_USE_EXEC_COMPUTED_GOTO)
+        addOption ("computedgoto");
+       #endif
+       #if SQUAREPINE_DUKTAPE_OPTIMIZE_BYTECODE
+        addOption ("optimized");
+       #endif
+
+        return name.empty() ? "default" : name;
+    }
+
+    double getMillisecondsSince (std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now() - start).count();
+    }
+
+    /** Runs a single workload, writing its result line.
+
+        @returns false if the workload failed to compile or threw.
+    */
+    bool runWorkload (const Workload& workload, double secondsBudget)
+    {
+        HeapUsage heapUsage;
+        auto* context = duk_create_heap (HeapUsage::allocate, HeapUsage::reallocate, HeapUsage::release, &heapUsage, nullptr);
+
+       #if SQUAREPINE_DUKTAPE_OPTIMIZE_BYTECODE
+        const duk_uint_t compileFlags = DUK_COMPILE_OPTIMIZE;
+       #else
+        const duk_uint_t compileFlags = 0;
+       #endif
+
+        if (duk_pcompile_lstring (context, compileFlags, workload.source.data(), workload.source.size()) != DUK_EXEC_SUCCESS
+            || duk_pcall (context, 0) != DUK_EXEC_SUCCESS)
+        {
+            std::fprintf (stderr, "%s: %s\n", workload.name.c_str(), duk_safe_to_string (context, -1));
+            duk_destroy_heap (context);
+            return false;
+        }
+
+        duk_pop (context);
+
+        const auto callRun = [context, &workload] (std::string& result)
+        {
+            duk_get_global_string (context, "run");
+
+            if (duk_pcall (context, 0) != DUK_EXEC_SUCCESS)
+            {
+                std::fprintf (stderr, "%s: %s\n", workload.name.c_str(), duk_safe_to_string (context, -1));
+                duk_pop (context);
+                return false;
+            }
+
+            result = duk_safe_to_string (context, -1);
+            duk_pop (context);
+            return true;
+        };
+
+        // One untimed warm-up pass to populate the string table and caches.
+        std::string result;
+        if (! callRun (result))
+        {
+            duk_destroy_heap (context);
+            return false;
+        }
+
+        const auto budgetMs = secondsBudget * 1000.0;
+        const auto start = std::chrono::steady_clock::now();
+        int iterations = 0;
+
+        do
+        {
+            if (! callRun (result))
+            {
+                duk_destroy_heap (context);
+                return false;
+            }
+
+            ++iterations;
+        }
+        while (iterations < 3 || getMillisecondsSince (start) < budgetMs);
+
+        const auto elapsedMs = getMillisecondsSince (start);
+
+        std::printf ("{\"configuration\":\"%s\",\"workload\":\"%s\",\"iterations\":%d,"
+                     "\"msPerIteration\":%.4f,\"opsPerSecond\":%.3f,\"peakHeapBytes\":%zu,\"result\":\"%s\"}\n",
+                     getConfigurationName().c_str(), workload.name.c_str(), iterations,
+                     elapsedMs / iterations, iterations * 1000.0 / elapsedMs, heapUsage.peak, result.c_str());
+        std::fflush (stdout);
+
+        duk_destroy_heap (context);
+        return true;
+    }
+}
+
+//==============================================================================
+int main (int argc, char** argv)
+{
+    const char* filter = nullptr;
+    const char* workloadsDirectory = SQUAREPINE_BENCHMARK_WORKLOADS_DIR;
+    double secondsBudget = 1.0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp (argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (std::strcmp (argv[i], "--seconds") == 0 && i + 1 < argc)
+            secondsBudget = std::atof (argv[++i]);
+        else if (std::strcmp (argv[i], "--workloads") == 0 && i + 1 < argc)
+            workloadsDirectory = argv[++i];
+    }
+
+    std::vector<Workload> workloads (std::begin (microWorkloads), std::end (microWorkloads));
+    addCorpusWorkloads (workloads, workloadsDirectory);
+
+    int failures = 0;
+
+    for (const auto& workload : workloads)
+        if (filter == nullptr || workload.name.find (filter) != std::string::npos)
+            if (! runWorkload (workload, secondsBudget))
+                ++failures;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,341 @@
+/*
+    Module benchmarks for the ECMAScriptEngine wrapper.
+
+    Unlike the interpreter benchmarks, these go through the JUCE facing API, so they
+    include the cost of marshalling vars, dispatching native callbacks, managing timers
+    and creating heaps. Each benchmark runs its operation repeatedly until the time
+    budget is spent. Results are written to stdout as one JSON object per line so that
+    runs of different versions of the module can be collected and compared by tooling.
+
+    Usage: squarepine_duktape_module_benchmarks [--filter <substring>] [--seconds <budget>]
+*/
+
+#include <squarepine_duktape/squarepine_duktape.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace juce;
+using duktape::ECMAScriptEngine;
+
+namespace
+{
+    //==============================================================================
+    struct Benchmark final
+    {
+        const char* name;
+
+        /** Prepares the engine, untimed. */
+        std::function<void (ECMAScriptEngine&)> setUp;
+
+        /** Runs one timed iteration, returning a small value that is checked between versions. */
+        std::function<var (ECMAScriptEngine&)> run;
+    };
+
+    //==============================================================================
+    String createLargeScript (bool shouldRun)
+    {
+        String script;
+
+        for (int i = 0; i < 500; ++i)
+        {
+            script << "function f" << i << " (a, b) {\n"
+                   << "    var s = a + b + " << i << ";\n"
+                   << "    for (var j = 0; j < 4; j++) { s = (s * 31 + j) % 1000003; }\n"
+                   << "    return { value: s, name: \"f" << i << "\", list: [a, b, s] };\n"
+                   << "}\n";
+        }
+
+        if (shouldRun)
+        {
+            script << "var total = 0;\n";
+
+            for (int i = 0; i < 500; ++i)
+                script << "total += f" << i << " (" << i << ", 1).value;\n";
+
+            script << "total;\n";
+        }
+        else
+        {
+            script << "0;\n";
+        }
+
+        return script;
+    }
+
+    var createFlatObject()
+    {
+        DynamicObject::Ptr object = new DynamicObject();
+
+        for (int i = 0; i < 20; ++i)
+            object->setProperty ("property" + String (i), i % 2 == 0 ? var (i * 1.5) : var ("value" + String (i)));
+
+        return object.get();
+    }
+
+    var createNestedObject (int depth)
+    {
+        DynamicObject::Ptr object = new DynamicObject();
+        object->setProperty ("depth", depth);
+        object->setProperty ("name", "level" + String (depth));
+
+        if (depth > 0)
+        {
+            Array<var> children;
+
+            for (int i = 0; i < 3; ++i)
+                children.add (createNestedObject (depth - 1));
+
+            object->setProperty ("children", children);
+        }
+
+        return object.get();
+    }
+
+    var createLargeArray()
+    {
+        Array<var> array;
+        array.ensureStorageAllocated (10000);
+
+        for (int i = 0; i < 10000; ++i)
+            array.add (i * 0.5);
+
+        return array;
+    }
+
+    var createLargeObject()
+    {
+        DynamicObject::Ptr object = new DynamicObject();
+
+        for (int i = 0; i < 1000; ++i)
+            object->setProperty ("key" + String (i), i);
+
+        return object.get();
+    }
+
+    var getSize (const var& value)
+    {
+        if (const auto* array = value.getArray())
+            return array->size();
+
+        if (auto* object = value.getDynamicObject())
+            return object->getProperties().size();
+
+        return value;
+    }
+
+    //==============================================================================
+    const std::vector<Benchmark>& getBenchmarks()
+    {
+        static const auto largeScript = createLargeScript (true);
+        static const auto largeDefinitions = createLargeScript (false);
+        static const auto flatObject = createFlatObject();
+        static const auto nestedObject = createNestedObject (4);
+        static const auto largeArray = createLargeArray();
+        static const auto largeObject = createLargeObject();
+
+        const auto defineIdentity = [] (ECMAScriptEngine& engine)
+        {
+            engine.evaluate ("function identity (value) { return value; }");
+        };
+
+        static const std::vector<Benchmark> benchmarks =
+        {
+            //==============================================================================
+            { "evaluate-small", nullptr, [] (ECMAScriptEngine& engine)
+            {
+                return engine.evaluate ("1 + 2 * 3");
+            }},
+            { "evaluate-large", nullptr, [] (ECMAScriptEngine& engine)
+            {
+                return engine.evaluate (largeScript);
+            }},
+            { "compile-small", nullptr, [] (ECMAScriptEngine& engine)
+            {
+                return engine.evaluate ("(function (a, b) { return { sum: a + b, product: a * b }; }); 0");
+            }},
+            { "compile-large", nullptr, [] (ECMAScriptEngine& engine)
+            {
+                return engine.evaluate (largeDefinitions);
+            }},
+
+            //==============================================================================
+            { "invoke-no-arguments", [] (ECMAScriptEngine& engine) { engine.evaluate ("function noop() {}"); },
+              [] (ECMAScriptEngine& engine)
+            {
+                return engine.invoke ("noop");
+            }},
+            { "invoke-number-arguments", [] (ECMAScriptEngine& engine) { engine.evaluate ("function add (a, b, c) { return a + b + c; }"); },
+              [] (ECMAScriptEngine& engine)
+            {
+                return engine.invoke ("add", 1, 2.5, 3);
+            }},
+
+            //==============================================================================
+            { "marshal-flat-object", defineIdentity, [] (ECMAScriptEngine& engine)
+            {
+                return getSize (engine.invoke ("identity", flatObject));
+            }},
+            { "marshal-nested-object", defineIdentity, [] (ECMAScriptEngine& engine)
+            {
+                return getSize (engine.invoke ("identity", nestedObject));
+            }},
+            { "marshal-large-array", defineIdentity, [] (ECMAScriptEngine& engine)
+            {
+                return getSize (engine.invoke ("identity", largeArray));
+            }},
+            { "marshal-large-object", defineIdentity, [] (ECMAScriptEngine& engine)
+            {
+                return getSize (engine.invoke ("identity", largeObject));
+            }},
+            { "marshal-large-array-from-script", nullptr, [] (ECMAScriptEngine& engine)
+            {
+                return getSize (engine.evaluate ("var a = []; for (var i = 0; i < 10000; i++) a.push(i * 0.5); a"));
+            }},
+
+            //==============================================================================
+            { "native-callback-persistent",
+              [] (ECMAScriptEngine& engine)
+              {
+                  engine.registerNativeMethod ("nativeAdd", [] (const var::NativeFunctionArgs& args)
+                  {
+                      return var ((double) args.arguments[0] + (double) args.arguments[1]);
+                  });
+
+                  engine.evaluate ("function callNative() { var s = 0; for (var i = 0; i < 1000; i++) s = nativeAdd (s, i); return s; }");
+              },
+              [] (ECMAScriptEngine& engine)
+            {
+                return engine.invoke ("callNative");
+            }},
+            { "native-callback-temporary",
+              [] (ECMAScriptEngine& engine)
+              {
+                  engine.evaluate ("function callTwice (f) { return f (1) + f (2); }");
+              },
+              [] (ECMAScriptEngine& engine)
+            {
+                const var callback (var::NativeFunction ([] (const var::NativeFunctionArgs& args)
+                {
+                    return var ((int) args.arguments[0] * 2);
+                }));
+
+                return engine.invoke ("callTwice", callback);
+            }},
+
+            //==============================================================================
+            { "timer-churn", nullptr, [] (ECMAScriptEngine& engine)
+            {
+                return engine.evaluate ("var n = 0; for (var i = 0; i < 100; i++) { clearTimeout (setTimeout (function() {}, 1000)); n++; } n");
+            }},
+
+            //==============================================================================
+            { "json-roundtrip", [] (ECMAScriptEngine& engine) { engine.registerNativeProperty ("nested", nestedObject); },
+              [] (ECMAScriptEngine& engine)
+            {
+                return engine.evaluate ("JSON.parse (JSON.stringify (nested)).children.length");
+            }},
+            { "regexp", nullptr, [] (ECMAScriptEngine& engine)
+            {
+                return engine.evaluate ("var m = 0, re = /([a-z]+)-(\\d+)/g, s = 'alpha-1 beta-22 gamma-333 delta-4444 '; "
+                                        "for (var i = 0; i < 50; i++) { re.lastIndex = 0; while (re.exec (s)) m++; } m");
+            }},
+
+            //==============================================================================
+            { "engine-create", nullptr, [] (ECMAScriptEngine&)
+            {
+                ECMAScriptEngine engine;
+                return engine.evaluate ("1");
+            }},
+            { "engine-reset", nullptr, [] (ECMAScriptEngine& engine)
+            {
+                engine.reset();
+                return var (0);
+            }}
+        };
+
+        return benchmarks;
+    }
+
+    //==============================================================================
+    double getMillisecondsSince (int64 startTicks)
+    {
+        return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTicks) * 1000.0;
+    }
+
+    /** Runs a single benchmark on a fresh engine, writing its result line.
+
+        @returns false if the benchmark threw.
+    */
+    bool runBenchmark (const Benchmark& benchmark, double secondsBudget)
+    {
+        try
+        {
+            ECMAScriptEngine engine;
+
+            if (benchmark.setUp != nullptr)
+                benchmark.setUp (engine);
+
+            // One untimed warm-up pass to populate the string table and caches.
+            auto result = benchmark.run (engine);
+
+            const auto budgetMs = secondsBudget * 1000.0;
+            const auto startTicks = Time::getHighResolutionTicks();
+            int iterations = 0;
+
+            do
+            {
+                result = benchmark.run (engine);
+                ++iterations;
+            }
+            while (iterations < 3 || getMillisecondsSince (startTicks) < budgetMs);
+
+            const auto elapsedMs = getMillisecondsSince (startTicks);
+
+            DynamicObject::Ptr line = new DynamicObject();
+            line->setProperty ("configuration", SQUAREPINE_DUKTAPE_USE_FASTINT ? "fastint" : "default");
+            line->setProperty ("benchmark", benchmark.name);
+            line->setProperty ("iterations", iterations);
+            line->setProperty ("msPerIteration", elapsedMs / iterations);
+            line->setProperty ("opsPerSecond", iterations * 1000.0 / elapsedMs);
+            line->setProperty ("result", result.toString());
+
+            std::printf ("%s\n", JSON::toString (line.get(), true).toRawUTF8());
+            std::fflush (stdout);
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            std::fprintf (stderr, "%s: %s\n", benchmark.name, e.what());
+            return false;
+        }
+    }
+}
+
+//==============================================================================
+int main (int argc, char** argv)
+{
+    // Timers need a message manager, even though the message loop is never run
+    const ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const char* filter = nullptr;
+    double secondsBudget = 1.0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp (argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (std::strcmp (argv[i], "--seconds") == 0 && i + 1 < argc)
+            secondsBudget = std::atof (argv[++i]);
+    }
+
+    int failures = 0;
+
+    for (const auto& benchmark : getBenchmarks())
+        if (filter == nullptr || std::strstr (benchmark.name, filter) != nullptr)
+            if (! runBenchmark (benchmark, secondsBudget))
+                ++failures;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,281 @@
+// Message routing: a switch over 128 numeric message ids and one over 96
+// message names, like the dispatch loops of plugin and UI message handlers.
+// A few ids and names are unknown to the router and go to the default.
+
+var total = 0, count = 0;
+
+function routeId(id, arg) {
+  switch (id) {
+    case 0: total += arg; break;
+    case 1: total -= arg; break;
+    case 2: total ^= arg; break;
+    case 3: total += arg * 2; break;
+    case 4: count++; break;
+    case 5: total = (total + arg) % 1000003; break;
+    case 6: total += arg; break;
+    case 7: total -= arg; break;
+    case 8: total ^= arg; break;
+    case 9: total += arg * 2; break;
+    case 10: count++; break;
+    case 11: total = (total + arg) % 1000003; break;
+    case 12: total += arg; break;
+    case 13: total -= arg; break;
+    case 14: total ^= arg; break;
+    case 15: total += arg * 2; break;
+    case 16: count++; break;
+    case 17: total = (total + arg) % 1000003; break;
+    case 18: total += arg; break;
+    case 19: total -= arg; break;
+    case 20: total ^= arg; break;
+    case 21: total += arg * 2; break;
+    case 22: count++; break;
+    case 23: total = (total + arg) % 1000003; break;
+    case 24: total += arg; break;
+    case 25: total -= arg; break;
+    case 26: total ^= arg; break;
+    case 27: total += arg * 2; break;
+    case 28: count++; break;
+    case 29: total = (total + arg) % 1000003; break;
+    case 30: total += arg; break;
+    case 31: total -= arg; break;
+    case 32: total ^= arg; break;
+    case 33: total += arg * 2; break;
+    case 34: count++; break;
+    case 35: total = (total + arg) % 1000003; break;
+    case 36: total += arg; break;
+    case 37: total -= arg; break;
+    case 38: total ^= arg; break;
+    case 39: total += arg * 2; break;
+    case 40: count++; break;
+    case 41: total = (total + arg) % 1000003; break;
+    case 42: total += arg; break;
+    case 43: total -= arg; break;
+    case 44: total ^= arg; break;
+    case 45: total += arg * 2; break;
+    case 46: count++; break;
+    case 47: total = (total + arg) % 1000003; break;
+    case 48: total += arg; break;
+    case 49: total -= arg; break;
+    case 50: total ^= arg; break;
+    case 51: total += arg * 2; break;
+    case 52: count++; break;
+    case 53: total = (total + arg) % 1000003; break;
+    case 54: total += arg; break;
+    case 55: total -= arg; break;
+    case 56: total ^= arg; break;
+    case 57: total += arg * 2; break;
+    case 58: count++; break;
+    case 59: total = (total + arg) % 1000003; break;
+    case 60: total += arg; break;
+    case 61: total -= arg; break;
+    case 62: total ^= arg; break;
+    case 63: total += arg * 2; break;
+    case 64: count++; break;
+    case 65: total = (total + arg) % 1000003; break;
+    case 66: total += arg; break;
+    case 67: total -= arg; break;
+    case 68: total ^= arg; break;
+    case 69: total += arg * 2; break;
+    case 70: count++; break;
+    case 71: total = (total + arg) % 1000003; break;
+    case 72: total += arg; break;
+    case 73: total -= arg; break;
+    case 74: total ^= arg; break;
+    case 75: total += arg * 2; break;
+    case 76: count++; break;
+    case 77: total = (total + arg) % 1000003; break;
+    case 78: total += arg; break;
+    case 79: total -= arg; break;
+    case 80: total ^= arg; break;
+    case 81: total += arg * 2; break;
+    case 82: count++; break;
+    case 83: total = (total + arg) % 1000003; break;
+    case 84: total += arg; break;
+    case 85: total -= arg; break;
+    case 86: total ^= arg; break;
+    case 87: total += arg * 2; break;
+    case 88: count++; break;
+    case 89: total = (total + arg) % 1000003; break;
+    case 90: total += arg; break;
+    case 91: total -= arg; break;
+    case 92: total ^= arg; break;
+    case 93: total += arg * 2; break;
+    case 94: count++; break;
+    case 95: total = (total + arg) % 1000003; break;
+    case 96: total += arg; break;
+    case 97: total -= arg; break;
+    case 98: total ^= arg; break;
+    case 99: total += arg * 2; break;
+    case 100: count++; break;
+    case 101: total = (total + arg) % 1000003; break;
+    case 102: total += arg; break;
+    case 103: total -= arg; break;
+    case 104: total ^= arg; break;
+    case 105: total += arg * 2; break;
+    case 106: count++; break;
+    case 107: total = (total + arg) % 1000003; break;
+    case 108: total += arg; break;
+    case 109: total -= arg; break;
+    case 110: total ^= arg; break;
+    case 111: total += arg * 2; break;
+    case 112: count++; break;
+    case 113: total = (total + arg) % 1000003; break;
+    case 114: total += arg; break;
+    case 115: total -= arg; break;
+    case 116: total ^= arg; break;
+    case 117: total += arg * 2; break;
+    case 118: count++; break;
+    case 119: total = (total + arg) % 1000003; break;
+    case 120: total += arg; break;
+    case 121: total -= arg; break;
+    case 122: total ^= arg; break;
+    case 123: total += arg * 2; break;
+    case 124: count++; break;
+    case 125: total = (total + arg) % 1000003; break;
+    case 126: total += arg; break;
+    case 127: total -= arg; break;
+    default: count--;
+  }
+}
+
+function routeName(name, arg) {
+  switch (name) {
+    case "param.set0": total += arg; break;
+    case "note.get0": total = (total + arg) % 1000003; break;
+    case "transport.begin0": count++; break;
+    case "view.end0": total += arg * 2; break;
+    case "preset.set0": total ^= arg; break;
+    case "midi.get0": total -= arg; break;
+    case "param.begin1": total += arg; break;
+    case "note.end1": total = (total + arg) % 1000003; break;
+    case "transport.set1": count++; break;
+    case "view.get1": total += arg * 2; break;
+    case "preset.begin1": total ^= arg; break;
+    case "midi.end1": total -= arg; break;
+    case "param.set2": total += arg; break;
+    case "note.get2": total = (total + arg) % 1000003; break;
+    case "transport.begin2": count++; break;
+    case "view.end2": total += arg * 2; break;
+    case "preset.set2": total ^= arg; break;
+    case "midi.get2": total -= arg; break;
+    case "param.begin3": total += arg; break;
+    case "note.end3": total = (total + arg) % 1000003; break;
+    case "transport.set3": count++; break;
+    case "view.get3": total += arg * 2; break;
+    case "preset.begin3": total ^= arg; break;
+    case "midi.end3": total -= arg; break;
+    case "param.set4": total += arg; break;
+    case "note.get4": total = (total + arg) % 1000003; break;
+    case "transport.begin4": count++; break;
+    case "view.end4": total += arg * 2; break;
+    case "preset.set4": total ^= arg; break;
+    case "midi.get4": total -= arg; break;
+    case "param.begin5": total += arg; break;
+    case "note.end5": total = (total + arg) % 1000003; break;
+    case "transport.set5": count++; break;
+    case "view.get5": total += arg * 2; break;
+    case "preset.begin5": total ^= arg; break;
+    case "midi.end5": total -= arg; break;
+    case "param.set6": total += arg; break;
+    case "note.get6": total = (total + arg) % 1000003; break;
+    case "transport.begin6": count++; break;
+    case "view.end6": total += arg * 2; break;
+    case "preset.set6": total ^= arg; break;
+    case "midi.get6": total -= arg; break;
+    case "param.begin7": total += arg; break;
+    case "note.end7": total = (total + arg) % 1000003; break;
+    case "transport.set7": count++; break;
+    case "view.get7": total += arg * 2; break;
+    case "preset.begin7": total ^= arg; break;
+    case "midi.end7": total -= arg; break;
+    case "param.set8": total += arg; break;
+    case "note.get8": total = (total + arg) % 1000003; break;
+    case "transport.begin8": count++; break;
+    case "view.end8": total += arg * 2; break;
+    case "preset.set8": total ^= arg; break;
+    case "midi.get8": total -= arg; break;
+    case "param.begin9": total += arg; break;
+    case "note.end9": total = (total + arg) % 1000003; break;
+    case "transport.set9": count++; break;
+    case "view.get9": total += arg * 2; break;
+    case "preset.begin9": total ^= arg; break;
+    case "midi.end9": total -= arg; break;
+    case "param.set10": total += arg; break;
+    case "note.get10": total = (total + arg) % 1000003; break;
+    case "transport.begin10": count++; break;
+    case "view.end10": total += arg * 2; break;
+    case "preset.set10": total ^= arg; break;
+    case "midi.get10": total -= arg; break;
+    case "param.begin11": total += arg; break;
+    case "note.end11": total = (total + arg) % 1000003; break;
+    case "transport.set11": count++; break;
+    case "view.get11": total += arg * 2; break;
+    case "preset.begin11": total ^= arg; break;
+    case "midi.end11": total -= arg; break;
+    case "param.set12": total += arg; break;
+    case "note.get12": total = (total + arg) % 1000003; break;
+    case "transport.begin12": count++; break;
+    case "view.end12": total += arg * 2; break;
+    case "preset.set12": total ^= arg; break;
+    case "midi.get12": total -= arg; break;
+    case "param.begin13": total += arg; break;
+    case "note.end13": total = (total + arg) % 1000003; break;
+    case "transport.set13": count++; break;
+    case "view.get13": total += arg * 2; break;
+    case "preset.begin13": total ^= arg; break;
+    case "midi.end13": total -= arg; break;
+    case "param.set14": total += arg; break;
+    case "note.get14": total = (total + arg) % 1000003; break;
+    case "transport.begin14": count++; break;
+    case "view.end14": total += arg * 2; break;
+    case "preset.set14": total ^= arg; break;
+    case "midi.get14": total -= arg; break;
+    case "param.begin15": total += arg; break;
+    case "note.end15": total = (total + arg) % 1000003; break;
+    case "transport.set15": count++; break;
+    case "view.get15": total += arg * 2; break;
+    case "preset.begin15": total ^= arg; break;
+    case "midi.end15": total -= arg; break;
+    default: count--;
+  }
+}
+
+var names = ["param.set0", "note.get0", "transport.begin0", "view.end0",
+  "preset.set0", "midi.get0", "param.begin1", "note.end1",
+  "transport.set1", "view.get1", "preset.begin1", "midi.end1",
+  "param.set2", "note.get2", "transport.begin2", "view.end2",
+  "preset.set2", "midi.get2", "param.begin3", "note.end3",
+  "transport.set3", "view.get3", "preset.begin3", "midi.end3",
+  "param.set4", "note.get4", "transport.begin4", "view.end4",
+  "preset.set4", "midi.get4", "param.begin5", "note.end5",
+  "transport.set5", "view.get5", "preset.begin5", "midi.end5",
+  "param.set6", "note.get6", "transport.begin6", "view.end6",
+  "preset.set6", "midi.get6", "param.begin7", "note.end7",
+  "transport.set7", "view.get7", "preset.begin7", "midi.end7",
+  "param.set8", "note.get8", "transport.begin8", "view.end8",
+  "preset.set8", "midi.get8", "param.begin9", "note.end9",
+  "transport.set9", "view.get9", "preset.begin9", "midi.end9",
+  "param.set10", "note.get10", "transport.begin10", "view.end10",
+  "preset.set10", "midi.get10", "param.begin11", "note.end11",
+  "transport.set11", "view.get11", "preset.begin11", "midi.end11",
+  "param.set12", "note.get12", "transport.begin12", "view.end12",
+  "preset.set12", "midi.get12", "param.begin13", "note.end13",
+  "transport.set13", "view.get13", "preset.begin13", "midi.end13",
+  "param.set14", "note.get14", "transport.begin14", "view.end14",
+  "preset.set14", "midi.get14", "param.begin15", "note.end15",
+  "transport.set15", "view.get15", "preset.begin15", "midi.end15", "unknown"];
+
+function run() {
+  total = 0;
+  count = 0;
+
+  for (var i = 0; i < 40000; i++) {
+    routeId((i * 37) % 131, i & 255);
+    routeName(names[(i * 13) % names.length], i & 255);
+  }
+
+  if (count < 0)
+    throw new Error("Too many unrouted messages: " + count);
+
+  return total + count;
+}
@@ -0,0 +1,39 @@
+// JSON round trip: serialises and parses a document of nested records,
+// similar to a configuration or an API response.
+
+function createDocument() {
+  var tags = ["alpha", "beta", "gamma", "delta", "epsilon"];
+  var items = [];
+
+  for (var i = 0; i < 200; i++) {
+    items.push({
+      id: i,
+      name: "item-" + i,
+      price: i * 1.25,
+      enabled: (i % 3) != 0,
+      tags: [tags[i % 5], tags[(i * 7) % 5]],
+      dimensions: { width: i % 17, height: i % 23, depth: 0.5 + i },
+      notes: i % 10 == 0 ? null : "Line one\nLine \"two\" é"
+    });
+  }
+
+  return { version: 3, title: "Inventory", items: items };
+}
+
+var doc = createDocument();
+
+function run() {
+  var text = JSON.stringify(doc);
+  var parsed = JSON.parse(text);
+  var pretty = JSON.stringify(parsed, null, 2);
+  var reparsed = JSON.parse(pretty);
+
+  var total = 0;
+  for (var i = 0; i < reparsed.items.length; i++)
+    total += reparsed.items[i].dimensions.width;
+
+  if (reparsed.items.length != doc.items.length)
+    throw new Error("JSON round trip lost items");
+
+  return text.length + total;
+}
@@ -0,0 +1,41 @@
+// Log scanning with string methods only: splitting a long log into lines and
+// fields, searching for markers with indexOf() and includes(), and masking
+// values with a string pattern replace().
+
+var levels = ["INFO", "DEBUG", "WARN", "ERROR"];
+var lines = [];
+
+for (var i = 0; i < 2000; i++) {
+  lines.push("2024-03-" + (10 + i % 20) + "T12:" + (10 + i % 50) + ":00Z | " + levels[(i * 7) % 4] +
+             " | worker-" + (i % 16) + " | request id=" + (i * 7919 % 100000) +
+             " took " + (i % 300) + "ms user=alice@example.com path=/api/v1/items/" + i);
+}
+
+var log = lines.join("\n");
+
+function run() {
+  var rows = log.split("\n");
+  var errors = 0, slow = 0, workers = 0, position = 0, masked = 0;
+
+  for (var i = 0; i < rows.length; i++) {
+    var fields = rows[i].split(" | ");
+
+    if (fields[1] === "ERROR")
+      errors++;
+    if (fields[2].indexOf("worker-1") === 0)
+      workers++;
+    if (rows[i].includes(" took 29"))
+      slow++;
+
+    if (rows[i].replace("alice@example.com", "<user>").indexOf("<user>") > 0)
+      masked++;
+  }
+
+  while ((position = log.indexOf("path=/api/v1/items/19", position)) >= 0)
+    position += 21, workers++;
+
+  if (rows.length !== 2000 || masked !== rows.length)
+    throw new Error("Bad split: " + rows.length + " rows, " + masked + " masked");
+
+  return errors * 1000000 + slow * 1000 + workers;
+}
@@ -0,0 +1,78 @@
+// Numeric kernels: dense matrix multiplication, an n-body step and a
+// Mandelbrot escape count, exercising double arithmetic and array access.
+
+function createMatrix(n, offset) {
+  var m = new Array(n * n);
+  for (var i = 0; i < n * n; i++)
+    m[i] = ((i * 7 + offset) % 11) / 10;
+  return m;
+}
+
+var N = 32;
+var a = createMatrix(N, 1), b = createMatrix(N, 3);
+
+function multiply(a, b, n) {
+  var c = new Array(n * n);
+  for (var i = 0; i < n; i++) {
+    for (var j = 0; j < n; j++) {
+      var sum = 0;
+      for (var k = 0; k < n; k++)
+        sum += a[i * n + k] * b[k * n + j];
+      c[i * n + j] = sum;
+    }
+  }
+  return c;
+}
+
+function createBodies() {
+  var bodies = [];
+  for (var i = 0; i < 5; i++)
+    bodies.push({ x: i, y: i * 0.5, z: -i, vx: 0, vy: 0.1 * i, vz: 0, mass: 1 + i });
+  return bodies;
+}
+
+function advance(bodies, dt) {
+  for (var i = 0; i < bodies.length; i++) {
+    var bi = bodies[i];
+    for (var j = i + 1; j < bodies.length; j++) {
+      var bj = bodies[j];
+      var dx = bi.x - bj.x, dy = bi.y - bj.y, dz = bi.z - bj.z;
+      var d2 = dx * dx + dy * dy + dz * dz + 0.01;
+      var mag = dt / (d2 * Math.sqrt(d2));
+      bi.vx -= dx * bj.mass * mag; bi.vy -= dy * bj.mass * mag; bi.vz -= dz * bj.mass * mag;
+      bj.vx += dx * bi.mass * mag; bj.vy += dy * bi.mass * mag; bj.vz += dz * bi.mass * mag;
+    }
+  }
+  for (var i = 0; i < bodies.length; i++) {
+    var body = bodies[i];
+    body.x += dt * body.vx; body.y += dt * body.vy; body.z += dt * body.vz;
+  }
+}
+
+function mandelbrot(size, maxIterations) {
+  var inside = 0;
+  for (var py = 0; py < size; py++) {
+    for (var px = 0; px < size; px++) {
+      var cr = 2.5 * px / size - 2, ci = 2 * py / size - 1;
+      var zr = 0, zi = 0, n = 0;
+      while (n < maxIterations && zr * zr + zi * zi < 4) {
+        var t = zr * zr - zi * zi + cr;
+        zi = 2 * zr * zi + ci;
+        zr = t;
+        n++;
+      }
+      if (n == maxIterations) inside++;
+    }
+  }
+  return inside;
+}
+
+function run() {
+  var c = multiply(a, b, N);
+
+  var bodies = createBodies();
+  for (var i = 0; i < 200; i++)
+    advance(bodies, 0.01);
+
+  return Math.round(c[0] * 1000) + Math.round(bodies[0].x * 1000) + mandelbrot(48, 64);
+}
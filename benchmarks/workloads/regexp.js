@@ -0,0 +1,39 @@
+// Regexp-heavy parsing: tokenises and extracts fields from a synthetic log
+// in the common HTTP server format.
+
+function createLog() {
+  var methods = ["GET", "POST", "PUT", "DELETE"];
+  var paths = ["/index.html", "/api/v1/items", "/api/v1/items/42", "/static/app.js", "/login?next=%2Fhome"];
+  var lines = [];
+
+  for (var i = 0; i < 300; i++) {
+    lines.push("10.0." + (i % 256) + "." + ((i * 7) % 256)
+      + " - user" + (i % 13) + " [18/Oct/2026:12:" + (10 + i % 50) + ":" + (10 + i % 49) + " +0000] \""
+      + methods[i % 4] + " " + paths[i % 5] + " HTTP/1.1\" " + (i % 7 == 0 ? 404 : 200)
+      + " " + (100 + i * 13) + " \"Mozilla/5.0 (X11; Linux x86_64)\"");
+  }
+
+  return lines.join("\n");
+}
+
+var log = createLog();
+var linePattern = /^(\S+) \S+ (\S+) \[([^\]]+)\] "(\w+) ([^ "]+) HTTP\/[\d.]+" (\d{3}) (\d+) "([^"]*)"$/;
+var apiPattern = /^\/api\/v(\d+)\/(\w+)(?:\/(\d+))?/;
+
+function run() {
+  var lines = log.split(/\r?\n/);
+  var bytes = 0, errors = 0, apiCalls = 0;
+
+  for (var i = 0; i < lines.length; i++) {
+    var m = linePattern.exec(lines[i]);
+    if (m == null)
+      throw new Error("Unparsed line: " + lines[i]);
+
+    bytes += parseInt(m[7], 10);
+    if (m[6] != "200") errors++;
+    if (apiPattern.test(m[5])) apiCalls++;
+  }
+
+  var words = log.replace(/[^A-Za-z]+/g, " ").match(/\b[a-z]{4,}\b/gi);
+  return bytes + errors + apiCalls + words.length;
+}
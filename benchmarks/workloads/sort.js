@@ -0,0 +1,33 @@
+// Array sorting: numbers with a comparator and with the default (string)
+// ordering, strings, and records by key, all from a deterministic pseudo
+// random source.
+
+var seed = 49734321;
+
+function random() {
+  // Park-Miller minimal standard generator
+  seed = (seed * 16807) % 2147483647;
+  return seed;
+}
+
+var numbers = [], strings = [], records = [];
+
+for (var i = 0; i < 2000; i++) {
+  numbers.push(random() % 100000);
+  strings.push("key" + (random() % 5000));
+  records.push({ group: random() % 10, order: i });
+}
+
+function run() {
+  var n = numbers.slice().sort(function (a, b) { return a - b; });
+  var d = numbers.slice().sort();
+  var s = strings.slice().sort();
+  var r = records.slice().sort(function (a, b) { return a.group - b.group || a.order - b.order; });
+
+  for (var i = 1; i < n.length; i++) {
+    if (n[i - 1] > n[i] || String(d[i - 1]) > String(d[i]) || s[i - 1] > s[i] || r[i - 1].group > r[i].group)
+      throw new Error("Array not sorted at " + i);
+  }
+
+  return n[0] + n[n.length - 1] + d[0] + s[0].length + r[0].order;
+}
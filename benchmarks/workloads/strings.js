@@ -0,0 +1,33 @@
+// String building: concatenation, joins, case conversion, slicing and
+// character access, as used by templating and formatting code.
+
+function pad(value, width) {
+  var s = "" + value;
+  while (s.length < width) s = " " + s;
+  return s;
+}
+
+function run() {
+  var out = "";
+  for (var i = 0; i < 500; i++)
+    out += "<li class=\"row-" + (i & 1 ? "odd" : "even") + "\">" + pad(i, 5) + "</li>\n";
+
+  var parts = [];
+  for (var i = 0; i < 500; i++)
+    parts.push(String.fromCharCode(97 + i % 26) + i.toString(16));
+  var joined = parts.join(",");
+
+  var upper = joined.toUpperCase();
+  var hash = 0;
+  for (var i = 0; i < upper.length; i++)
+    hash = (hash * 31 + upper.charCodeAt(i)) | 0;
+
+  var reversed = joined.split("").reverse().join("");
+  var count = 0, index = 0;
+  while ((index = out.indexOf("odd", index)) >= 0) {
+    count++;
+    index += 3;
+  }
+
+  return out.length + reversed.length + count + (hash & 0xffff) + out.substring(100, 200).trim().length;
+}
@@ -0,0 +1,41 @@
+// UTF-8 text coding: a mostly ASCII document with some accented, CJK and
+// emoji text is encoded with TextEncoder, decoded with TextDecoder (whole and
+// streamed in chunks), and the lengths of the decoded strings are counted.
+
+var words = ["status", "ok", "request", "naïve", "café", "日本語", "données", "response", "😀", "Grüße"];
+var paragraphs = [];
+
+for (var i = 0; i < 400; i++) {
+  var text = "#" + i + " ";
+  for (var j = 0; j < 24; j++)
+    text += (j % 9 === 4 ? words[(i + j) % words.length] : words[(i * j) % 3]) + " ";
+  paragraphs.push(text + "the quick brown fox jumps over the lazy dog.");
+}
+
+var document = paragraphs.join("\n");
+var encoder = new TextEncoder();
+
+function run() {
+  var bytes = encoder.encode(document);
+  var decoded = new TextDecoder().decode(bytes);
+
+  if (decoded !== document)
+    throw new Error("Bad round trip: " + decoded.length + " vs " + document.length + " characters");
+
+  var streamed = "", decoder = new TextDecoder();
+  for (var position = 0; position < bytes.length; position += 1000)
+    streamed += decoder.decode(bytes.subarray(position, position + 1000), { stream: true });
+  streamed += decoder.decode();
+
+  if (streamed !== document)
+    throw new Error("Bad streamed decode: " + streamed.length + " characters");
+
+  var characters = 0, asciiBytes = 0;
+  for (var k = 0; k < paragraphs.length; k++) {
+    var line = new TextDecoder().decode(encoder.encode(paragraphs[k]));
+    characters += line.length;
+    asciiBytes += encoder.encode(line.slice(0, 8)).length;
+  }
+
+  return bytes.length * 1000 + characters % 1000 + asciiBytes;
+}
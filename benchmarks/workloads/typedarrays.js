@@ -0,0 +1,40 @@
+// Typed array copies: converting 16-bit samples to floats, widening and
+// narrowing between float types, loading arrays of numbers and moving blocks
+// around with set(), as audio and geometry scripts do with their buffers.
+
+var FRAMES = 4096;
+
+var samples = new Int16Array(FRAMES);
+var positions = [];
+
+for (var i = 0; i < FRAMES; i++) {
+  samples[i] = ((i * 2654435761) >>> 16) - 32768;
+  positions.push((i % 97) * 0.25 - 12);
+}
+
+function run() {
+  var floats = new Float32Array(samples);
+  var doubles = new Float64Array(floats);
+  var narrowed = new Float32Array(FRAMES);
+  var bytes = new Uint8ClampedArray(FRAMES);
+  var ring = new Float32Array(FRAMES * 2);
+  var vertices = new Float32Array(positions);
+
+  narrowed.set(doubles);
+  bytes.set(vertices);
+
+  for (var block = 0; block < 16; block++) {
+    ring.set(floats.subarray(block * 256, block * 256 + 1024), (block * 512) % FRAMES);
+    ring.set(ring.subarray(0, 1024), FRAMES);
+    floats.set(new Int8Array(samples.buffer, block * 256, 256), block * 256);
+  }
+
+  var check = 0;
+  for (var j = 0; j < FRAMES; j += 61) {
+    if (doubles[j] !== samples[j] || narrowed[j] !== samples[j] || vertices[j] !== positions[j])
+      throw new Error("Bad conversion at " + j);
+    check = (check + floats[j] + ring[j] + ring[FRAMES + (j % 1024)] + bytes[j]) | 0;
+  }
+
+  return check;
+}
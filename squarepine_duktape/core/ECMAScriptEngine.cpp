@@ -55,6 +55,26 @@ var ECMAScriptEngine::evaluate (const File& code)
     return {};
 }
 
+var ECMAScriptEngine::evaluate (InputStream& stream, const String& sourceName)
+{
+    try
+    {
+        return pimpl->evaluate (stream, sourceName);
+    }
+    catch (const ECMAScriptError& err)
+    {
+        Logger::writeToLog (err.context);
+        Logger::writeToLog (err.stack);
+        jassertfalse;
+    }
+    catch (...)
+    {
+        jassertfalse;
+    }
+
+    return {};
+}
+
 //==============================================================================
 void ECMAScriptEngine::registerNativeMethod (const String& name, var::NativeFunction fn)
 {
@@ -66,6 +86,55 @@ void ECMAScriptEngine::registerNativeMethod (const String& target, const String&
     registerNativeProperty (target, name, var (fn));
 }
 
+void ECMAScriptEngine::registerNativeStringMethod (const String& name, NativeStringFunction fn)
+{
+    pimpl->registerNativeStringMethod ({}, name, std::move (fn));
+}
+
+void ECMAScriptEngine::registerNativeStringMethod (const String& target, const String& name, NativeStringFunction fn)
+{
+    pimpl->registerNativeStringMethod (target, name, std::move (fn));
+}
+
+bool ECMAScriptEngine::NativeStringArgs::isString (int index) const
+{
+    return index >= 0 && index < numArguments && duk_is_string (static_cast<duk_context*> (context), index);
+}
+
+std::string_view ECMAScriptEngine::NativeStringArgs::getString (int index) const
+{
+    if (! isString (index))
+        return {};
+
+    duk_size_t numBytes = 0;
+    const auto* data = duk_get_lstring (static_cast<duk_context*> (context), index, &numBytes);
+    return { data, numBytes };
+}
+
+StringRef ECMAScriptEngine::NativeStringArgs::getStringRef (int index) const
+{
+    if (! isString (index))
+        return {};
+
+    // Duktape's string data is null terminated, so it can be referred to directly
+    return String::CharPointerType (duk_get_string (static_cast<duk_context*> (context), index));
+}
+
+var ECMAScriptEngine::NativeStringArgs::operator[] (int index) const
+{
+    if (index < 0 || index >= numArguments)
+        return var::undefined();
+
+    auto* dukContext = static_cast<duk_context*> (context);
+
+    duk_push_global_stash (dukContext);
+    duk_get_prop_string (dukContext, -1, DUK_HIDDEN_SYMBOL ("__EcmascriptEngineInstance__"));
+    auto* engine = static_cast<Pimpl*> (duk_get_pointer (dukContext, -1));
+    duk_pop_2 (dukContext);
+
+    return engine->readVarFromDukStack (engine->dukContext, index);
+}
+
 //==============================================================================
 void ECMAScriptEngine::registerNativeProperty (const String& name, const var& value)
 {
@@ -77,6 +146,11 @@ void ECMAScriptEngine::registerNativeProperty (const String& target, const Strin
     pimpl->registerNativeProperty (target, name, value);
 }
 
+void ECMAScriptEngine::registerExternalString (const String& name, const char* utf8, size_t numBytes)
+{
+    pimpl->registerExternalString (name, utf8, numBytes);
+}
+
 //==============================================================================
 var ECMAScriptEngine::invoke (const String& name, const std::vector<var>& vargs)
 {
@@ -88,6 +162,181 @@ void ECMAScriptEngine::reset()
     pimpl->reset();
 }
 
+//==============================================================================
+void ECMAScriptEngine::addModuleResolver (std::unique_ptr<ECMAScriptModuleResolver> resolver)
+{
+    pimpl->addModuleResolver (std::move (resolver));
+}
+
+var ECMAScriptEngine::require (const String& id)
+{
+    try
+    {
+        return pimpl->require (id);
+    }
+    catch (const ECMAScriptError& err)
+    {
+        Logger::writeToLog (err.context);
+        Logger::writeToLog (err.stack);
+        jassertfalse;
+    }
+    catch (...)
+    {
+        jassertfalse;
+    }
+
+    return {};
+}
+
+void ECMAScriptEngine::addCompiledModule (const String& canonicalId, const MemoryBlock& bytecode)
+{
+    pimpl->addCompiledModule (canonicalId, bytecode);
+}
+
+void ECMAScriptEngine::clearModuleCaches()
+{
+    pimpl->clearModuleCaches();
+}
+
+//==============================================================================
+void ECMAScriptEngine::setBulkTransferThreshold (int numValues)
+{
+   #if SQUAREPINE_DUKTAPE_USE_JSON_FASTLANE
+    pimpl->bulkTransferThreshold = jmax (0, numValues);
+   #else
+    ignoreUnused (numValues);
+   #endif
+}
+
+//==============================================================================
+ECMAScriptLogSink& ECMAScriptEngine::getLogSink() noexcept
+{
+    return pimpl->logSink;
+}
+
+//==============================================================================
+std::map<String, ECMAScriptEngine::TimingStatistics> ECMAScriptEngine::getTimingStatistics() const
+{
+    std::map<String, TimingStatistics> result;
+
+    for (const auto& t : pimpl->timingStatistics)
+        result[t.first] = t.second.getStatistics();
+
+    return result;
+}
+
+void ECMAScriptEngine::clearTimingStatistics()
+{
+    pimpl->timingStatistics.clear();
+}
+
+//==============================================================================
+void ECMAScriptEngine::collectGarbage (GarbageCollectionMode mode)
+{
+    pimpl->collectGarbage (mode);
+}
+
+void ECMAScriptEngine::setGarbageCollectionTrigger (int percentOfLiveHeap, int minimumAllocations)
+{
+    pimpl->setGarbageCollectionTrigger (percentOfLiveHeap, minimumAllocations);
+}
+
+void ECMAScriptEngine::setVoluntaryGarbageCollectionEnabled (bool shouldBeEnabled)
+{
+    pimpl->setVoluntaryGarbageCollectionEnabled (shouldBeEnabled);
+}
+
+void ECMAScriptEngine::setIdleGarbageCollection (int intervalMilliseconds, GarbageCollectionMode mode, int minimumAllocations)
+{
+    pimpl->setIdleGarbageCollection (intervalMilliseconds, mode, minimumAllocations);
+}
+
+ECMAScriptEngine::TimingStatistics ECMAScriptEngine::getGarbageCollectionPauses() const
+{
+    return pimpl->garbageCollectionPauses.getStatistics();
+}
+
+void ECMAScriptEngine::clearGarbageCollectionPauses()
+{
+    pimpl->garbageCollectionPauses = {};
+}
+
+//==============================================================================
+ECMAScriptEngine::HeapStatistics ECMAScriptEngine::getHeapStats() const
+{
+    return pimpl->getHeapStats();
+}
+
+//==============================================================================
+void ECMAScriptEngine::setBindingStatisticsEnabled (bool shouldBeEnabled) noexcept
+{
+    pimpl->bindingStatisticsEnabled = shouldBeEnabled;
+}
+
+ECMAScriptEngine::BindingStatistics ECMAScriptEngine::getBindingStatistics() const
+{
+    BindingStatistics result;
+    result.numScriptToNativeCalls = pimpl->numScriptToNativeCalls;
+    result.numNativeToScriptCalls = pimpl->numNativeToScriptCalls;
+
+    for (const auto& b : pimpl->bindingMetrics)
+    {
+        const auto& metrics = b.second;
+
+        if (metrics.numCalls == 0)
+            continue;
+
+        NativeBindingStatistics stats;
+        stats.name = b.first;
+        stats.numCalls = metrics.numCalls;
+        stats.totalMs = Time::highResolutionTicksToSeconds (metrics.totalTicks) * 1000.0;
+        stats.marshallingMs = Time::highResolutionTicksToSeconds (metrics.totalTicks - metrics.callbackTicks) * 1000.0;
+        stats.latency = metrics.latency.getStatistics();
+        result.bindings.push_back (stats);
+    }
+
+    std::sort (result.bindings.begin(), result.bindings.end(),
+               [] (const NativeBindingStatistics& a, const NativeBindingStatistics& b) { return a.totalMs > b.totalMs; });
+
+    return result;
+}
+
+void ECMAScriptEngine::clearBindingStatistics()
+{
+    // The entries are reset in place since native functions keep pointers to them
+    for (auto& b : pimpl->bindingMetrics)
+        b.second = {};
+
+    pimpl->numScriptToNativeCalls = 0;
+    pimpl->numNativeToScriptCalls = 0;
+}
+
+//==============================================================================
+bool ECMAScriptEngine::startProfiling (int samplingIntervalMicroseconds)
+{
+    return pimpl->startProfiling (samplingIntervalMicroseconds);
+}
+
+ECMAScriptProfile ECMAScriptEngine::stopProfiling()
+{
+    return pimpl->stopProfiling();
+}
+
+bool ECMAScriptEngine::isProfiling() const noexcept
+{
+    return pimpl->profiler != nullptr;
+}
+
+void ECMAScriptEngine::setConsoleProfileCallback (std::function<void (const String&, const ECMAScriptProfile&)> callback)
+{
+    pimpl->consoleProfileCallback = std::move (callback);
+}
+
+void ECMAScriptEngine::setConsoleProfileDirectory (const File& directory)
+{
+    pimpl->consoleProfileDirectory = directory;
+}
+
 //==============================================================================
 void ECMAScriptEngine::debuggerAttach()
 {
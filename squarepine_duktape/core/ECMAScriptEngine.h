@@ -21,12 +21,30 @@ public:
 
     /** Evaluates an ECMA script compatible code file.
 
+        The file is compiled directly from a read-only memory mapping of it, so large
+        script bundles aren't copied into memory first and their pages are shared with
+        any other engine or process that loads the same file. Files that can't be mapped
+        are streamed in, as with the InputStream overload.
+
         @param file The file to evaluate.
 
         @returns the result of the evaluation, or var::undefined() on failure.
     */
     var evaluate (const File& file);
 
+    /** Evaluates ECMA script compatible code read from a stream.
+
+        The remainder of the stream is read straight into a single buffer owned
+        by the engine and compiled from there, without an intermediate String.
+        The source is expected to be UTF-8.
+
+        @param stream       The stream to read the code from.
+        @param sourceName   The name used for the code in error messages and stack traces.
+
+        @returns the result of the evaluation, or var::undefined() on failure.
+    */
+    var evaluate (InputStream& stream, const String& sourceName);
+
     //==============================================================================
     /** Registers a native method by the given name in the global namespace. */
     void registerNativeMethod (const String&, var::NativeFunction fn);
@@ -51,6 +69,70 @@ public:
     */
     void registerNativeMethod (const String&, const String&, var::NativeFunction fn);
 
+    //==============================================================================
+    /** The arguments of a native method registered with registerNativeStringMethod().
+
+        String arguments are read in place: the views point straight at the engine's
+        string data, so no String is allocated or copied for them. That data is only
+        valid until the method returns, so copy anything that needs to outlive the call.
+    */
+    class NativeStringArgs final
+    {
+    public:
+        /** @returns the number of arguments the method was called with. */
+        int size() const noexcept                   { return numArguments; }
+
+        /** @returns true if the argument at this index is a string. */
+        bool isString (int index) const;
+
+        /** @returns the UTF-8 data of a string argument, or an empty view for any other argument. */
+        std::string_view getString (int index) const;
+
+        /** @returns a string argument as a StringRef, or an empty one for any other argument. */
+        StringRef getStringRef (int index) const;
+
+        /** Converts an argument to a var, the way a var::NativeFunction would have received it. */
+        var operator[] (int index) const;
+
+    private:
+        friend class ECMAScriptEngine;
+
+        NativeStringArgs (void* dukContext, int numArgs) noexcept :
+            context (dukContext),
+            numArguments (numArgs)
+        {
+        }
+
+        void* const context; // The duk_context the method was called on
+        const int numArguments;
+
+        JUCE_DECLARE_NON_COPYABLE (NativeStringArgs)
+    };
+
+    /** A native method taking its string arguments in place. */
+    using NativeStringFunction = std::function<var (const NativeStringArgs&)>;
+
+    /** Registers a native method by the given name in the global namespace, without copying its string arguments.
+
+        This suits lookup-style bindings called with long keys or JSON text, which the
+        var::NativeFunction flavour would copy into a new String on every call.
+
+        @code
+            registerNativeStringMethod ("lookup",
+            [&table] (const ECMAScriptEngine::NativeStringArgs& args)
+            {
+                return table.find (args.getString (0));
+            });
+        @endcode
+    */
+    void registerNativeStringMethod (const String&, NativeStringFunction fn);
+
+    /** Registers a native method by the given name on the target object, without copying its string arguments.
+
+        @see registerNativeMethod, registerNativeStringMethod
+    */
+    void registerNativeStringMethod (const String&, const String&, NativeStringFunction fn);
+
     //==============================================================================
     /** Registers a native value by the given name in the global namespace. */
     void registerNativeProperty (const String&, const var&);
@@ -71,6 +153,19 @@ public:
     */
     void registerNativeProperty (const String&, const String&, const var&);
 
+    /** Registers a read-only string by the given name in the global namespace, without copying its text.
+
+        This is meant for large, immutable native text such as templates, data tables
+        and BinaryData resources. With SQUAREPINE_DUKTAPE_USE_EXTERNAL_STRINGS enabled,
+        the engine's string refers to the text in place; otherwise the text is copied.
+
+        @param name     The name of the global property holding the string.
+        @param utf8     The text, which must stay valid and unchanged for the lifetime of the
+                        engine, and must be followed by a null terminator (BinaryData resources are).
+        @param numBytes The size of the text in bytes, excluding the terminator.
+    */
+    void registerExternalString (const String& name, const char* utf8, size_t numBytes);
+
     //==============================================================================
     /** Invokes a method, applying the given args, inside the interpreter.
         
@@ -101,10 +196,263 @@ public:
     template<typename... T>
     var invoke (const String& name, T... args);
 
+    //==============================================================================
+    /** Adds a resolver used to locate the modules loaded by `require()`.
+
+        Scripts get a CommonJS style global `require()`. Each module is only
+        resolved and compiled the first time it's required, runs once per heap,
+        and gets its own `exports`, `require`, `module`, `__filename` and
+        `__dirname`. Identifiers starting with "./" or "../" are relative
+        to the requiring module.
+
+        Resolvers are asked in the order they were added. They are kept
+        when the engine is reset.
+
+        @see FileModuleResolver, MemoryModuleResolver, BinaryDataModuleResolver
+    */
+    void addModuleResolver (std::unique_ptr<ECMAScriptModuleResolver> resolver);
+
+    /** Requires a module from outside of any script, as `require (id)` would from the global scope.
+
+        @returns the module's exports, or var::undefined() on failure.
+    */
+    var require (const String& id);
+
+    /** Provides precompiled bytecode for a module, as produced by `duk_dump_function()`
+        from the module's wrapper function.
+
+        Compiled modules are kept across resets, so modules are normally only compiled
+        the first time any heap of this engine requires them. This lets the bytecode
+        be supplied ahead of time instead, e.g. to skip compiling large bundles at startup.
+
+        @warning Duktape doesn't validate bytecode: only load bytecode from a trusted
+                 source, produced by the same Duktape version and configuration.
+    */
+    void addCompiledModule (const String& canonicalId, const MemoryBlock& bytecode);
+
+    /** Forgets all compiled module bytecode, and all modules loaded in the current heap. */
+    void clearModuleCaches();
+
     //==============================================================================
     /** Resets the internal context, clearing the value stack and destroying native callbacks. */
     void reset();
 
+    //==============================================================================
+    /** Sets the size, in number of values, from which arrays and objects are moved
+        between vars and the engine as a single JSON document instead of one property
+        at a time.
+
+        Only trees made of plain data qualify: anything holding methods, binary data,
+        undefined values or non-finite numbers always goes property by property.
+        Pass 0 to disable the JSON path entirely. The default is 256.
+
+        This has no effect unless SQUAREPINE_DUKTAPE_USE_JSON_FASTLANE is enabled.
+    */
+    void setBulkTransferThreshold (int numValues);
+
+    //==============================================================================
+    /** @returns the sink that receives the output of `print()`, `console.log()` and the
+        other console methods, which can be used to filter, rate limit or redirect it.
+    */
+    ECMAScriptLogSink& getLogSink() noexcept;
+
+    //==============================================================================
+    /** Aggregated durations recorded under one label. */
+    struct TimingStatistics final
+    {
+        int64 count = 0;            /**< The number of durations recorded. */
+        double minimumMs = 0.0;     /**< The shortest duration. */
+        double averageMs = 0.0;     /**< The mean duration. */
+        double p99Ms = 0.0;         /**< The 99th percentile, estimated to within about 9%. */
+        double maximumMs = 0.0;     /**< The longest duration. */
+    };
+
+    /** @returns the durations recorded by scripts, by label.
+
+        Scripts record a duration each time they call `console.timeEnd (label)` or
+        `performance.measure (label, startMark, endMark)`. The timers, counters and
+        marks behind these live in native tables and use a monotonic clock, so they
+        are cheap enough to leave in production scripts.
+
+        Statistics are kept across resets.
+    */
+    std::map<String, TimingStatistics> getTimingStatistics() const;
+
+    /** Forgets all of the durations recorded by scripts. */
+    void clearTimingStatistics();
+
+    //==============================================================================
+    /** The kinds of garbage collection that can be requested. */
+    enum class GarbageCollectionMode
+    {
+        full,       /**< Frees everything that is unreachable. */
+        compacting  /**< Also shrinks objects and the string table, giving memory back to the allocator, at a higher cost. */
+    };
+
+    /** Collects garbage right away, e.g. to give memory back after a burst of work.
+
+        Objects whose finalizers resurrect them are only freed by a second collection.
+    */
+    void collectGarbage (GarbageCollectionMode mode = GarbageCollectionMode::full);
+
+    /** Sets when the engine collects garbage on its own, in the middle of running scripts.
+
+        A voluntary collection runs once the number of allocations since the last
+        collection reaches the given percentage of the objects and strings that
+        survived it, plus a minimum number of allocations. The default is 5000%
+        plus 1024, since reference counting frees most garbage as soon as it's
+        dropped. Settings are kept across resets.
+    */
+    void setGarbageCollectionTrigger (int percentOfLiveHeap, int minimumAllocations = 1024);
+
+    /** Enables or disables voluntary garbage collection.
+
+        While disabled, garbage is only collected when asked to, by the idle collector,
+        or when an allocation fails. Reference counting still frees acyclic garbage.
+    */
+    void setVoluntaryGarbageCollectionEnabled (bool shouldBeEnabled);
+
+    /** Collects garbage on the message thread while scripts aren't running,
+        so that collection pauses land between events rather than in the middle of them.
+
+        Every interval, the engine is collected if at least the given number of
+        allocations were made since the last collection. Combine this with a higher
+        trigger, or with voluntary collection disabled, to keep pauses out of
+        latency sensitive handlers.
+
+        The engine must be used from the message thread for this to be safe.
+
+        @param intervalMilliseconds The time between checks, or 0 to stop collecting when idle.
+    */
+    void setIdleGarbageCollection (int intervalMilliseconds,
+                                   GarbageCollectionMode mode = GarbageCollectionMode::full,
+                                   int minimumAllocations = 1024);
+
+    /** @returns the pause times of every garbage collection since the engine was created
+        or the statistics were cleared, whatever triggered them. Kept across resets.
+    */
+    TimingStatistics getGarbageCollectionPauses() const;
+
+    /** Forgets the garbage collection pause times recorded so far. */
+    void clearGarbageCollectionPauses();
+
+    //==============================================================================
+    /** The number and size of the live allocations of one kind. */
+    struct HeapUsage final
+    {
+        int64 count = 0;    /**< The number of live allocations. */
+        int64 bytes = 0;    /**< Their total size, including Duktape's headers. */
+    };
+
+    /** A snapshot of what the current heap contains. */
+    struct HeapStatistics final
+    {
+        HeapUsage objects;                              /**< All objects, including functions; object sizes include their property tables. */
+        HeapUsage functions;                            /**< Script, native and bound functions. */
+        HeapUsage strings;                              /**< Interned strings. */
+        HeapUsage buffers;                              /**< Plain buffers, including compiled bytecode. */
+        std::map<String, HeapUsage> objectsByClass;     /**< Objects by their class, e.g. "Object", "Array" or "DecEnv". */
+
+        int64 stringTableSize = 0;                      /**< The number of slots in the string table. */
+        double stringTableLoadFactor = 0.0;             /**< The number of strings per string table slot. */
+        double literalCacheHitRate = 0.0;               /**< The fraction of literal lookups served by the literal cache. */
+        double propertyCacheHitRate = 0.0;              /**< The fraction of cacheable property and global variable accesses served by the property cache. */
+
+        int64 valueStackDepth = 0;                      /**< The number of values on the value stack. */
+        int64 valueStackReserved = 0;                   /**< The number of values the value stack has room for. */
+        int64 callStackDepth = 0;                       /**< The number of calls in progress. */
+        int64 peakCallStackDepth = 0;                   /**< The deepest call stack seen by this heap. */
+
+        int64 numRefcountFrees = 0;                     /**< Allocations freed as soon as they became unreferenced. */
+        int64 numMarkAndSweepFrees = 0;                 /**< Allocations freed by garbage collections. */
+        int64 numGarbageCollections = 0;                /**< The number of garbage collections run. */
+    };
+
+    /** @returns the contents of the current heap.
+
+        The numbers come from counters that Duktape maintains as it allocates and
+        frees, so this is cheap enough to poll. They start over when the engine is reset.
+    */
+    HeapStatistics getHeapStats() const;
+
+    //==============================================================================
+    /** Statistics for the calls made by scripts into one native function. */
+    struct NativeBindingStatistics final
+    {
+        String name;                    /**< The name the function was registered under, e.g. "console.log", or "(anonymous)". */
+        int64 numCalls = 0;             /**< The number of calls. */
+        double totalMs = 0.0;           /**< The time spent in calls, including marshalling. */
+        double marshallingMs = 0.0;     /**< The part of totalMs spent converting the arguments and results. */
+        TimingStatistics latency;       /**< The latency of each call, including marshalling. */
+    };
+
+    /** A snapshot of the traffic between scripts and native code. */
+    struct BindingStatistics final
+    {
+        std::vector<NativeBindingStatistics> bindings;  /**< Every native function called, the most time consuming first. */
+        int64 numScriptToNativeCalls = 0;               /**< Calls from scripts into native functions. */
+        int64 numNativeToScriptCalls = 0;               /**< Evaluations, invocations, requires and callbacks into scripts. */
+    };
+
+    /** Enables or disables collecting statistics about native function calls.
+
+        Collection is off by default, in which case it costs a branch per call.
+        Statistics are kept across resets.
+    */
+    void setBindingStatisticsEnabled (bool shouldBeEnabled) noexcept;
+
+    /** @returns the statistics collected since they were enabled or last cleared. */
+    BindingStatistics getBindingStatistics() const;
+
+    /** Forgets the statistics collected so far. */
+    void clearBindingStatistics();
+
+    //==============================================================================
+    /** Starts recording a CPU profile of the scripts run by this engine.
+
+        While profiling, the engine checks every thousand or so executed opcodes whether
+        a sample is due, and if so records the current call stack. Profiling continues
+        across resets. Scripts may also start and stop a profile with `console.profile()`
+        and `console.profileEnd()`, once a callback or directory has been set for them.
+
+        Profiling needs Duktape's interrupt counter, which is always present in debug
+        builds and is enabled in release builds by SQUAREPINE_DUKTAPE_ENABLE_PROFILER.
+
+        @param samplingIntervalMicroseconds The time between samples.
+
+        @returns false if a profile is already being recorded or if profiling isn't
+                 available in this build.
+    */
+    bool startProfiling (int samplingIntervalMicroseconds = 1000);
+
+    /** Stops recording a CPU profile.
+
+        @returns the profile, or an empty profile if none was being recorded.
+    */
+    ECMAScriptProfile stopProfiling();
+
+    /** @returns true if a CPU profile is being recorded. */
+    bool isProfiling() const noexcept;
+
+    /** Sets a callback for the profiles recorded with `console.profile()` and `console.profileEnd()`.
+
+        The callback gets the label passed to `console.profile()`. It takes precedence
+        over a profile directory.
+
+        @see setConsoleProfileDirectory
+    */
+    void setConsoleProfileCallback (std::function<void (const String& label, const ECMAScriptProfile&)> callback);
+
+    /** Sets a directory to write the profiles recorded with `console.profile()` and
+        `console.profileEnd()` to, as .cpuprofile files named after their labels.
+
+        Scripts can't write files by default: with neither a directory nor a callback,
+        `console.profile()` doesn't record anything. Pass File() to stop writing files.
+
+        @see setConsoleProfileCallback
+    */
+    void setConsoleProfileDirectory (const File& directory);
+
     //==============================================================================
     /** Pauses execution and waits for a debug client to attach and begin a debug session. */
     void debuggerAttach();
@@ -60,13 +60,27 @@ static void safeEvalString (duk_context* context, const String& s)
     }
 }
 
-static void safeCompileFile (duk_context* context, const File& file)
+/** Compiles source code, leaving the compiled function on the top of the stack.
+
+    The source is read in place, so it only needs to stay valid for the duration of the call.
+*/
+static void safeCompileSource (duk_context* context, const char* data, size_t numBytes, const String& sourceName)
 {
-    const auto body = file.loadFileAsString();
+    // Skip any UTF-8 BOM, the way loading the file as a String would have.
+    if (numBytes >= 3 && std::memcmp (data, "\xEF\xBB\xBF", 3) == 0)
+    {
+        data += 3;
+        numBytes -= 3;
+    }
+
+    // An empty buffer's data can be null, which Duktape would take as
+    // "compile the source on the stack" rather than as an empty script.
+    if (data == nullptr)
+        data = "";
 
-    duk_push_string (context, file.getFileName().toRawUTF8());
+    duk_push_string (context, sourceName.toRawUTF8());
 
-    if (duk_pcompile_string_filename (context, DUK_COMPILE_EVAL, body.toRawUTF8()) != DUK_EXEC_SUCCESS)
+    if (duk_pcompile_lstring_filename (context, DUK_COMPILE_EVAL, data, numBytes) != DUK_EXEC_SUCCESS)
     {
         const String stack = duk_safe_to_stacktrace (context, -1);
         const String msg = duk_safe_to_string (context, -1);
@@ -75,174 +89,1531 @@ static void safeCompileFile (duk_context* context, const File& file)
     }
 }
 
-//==============================================================================
-static var javascriptLog (const var::NativeFunctionArgs& args)
+/** Compiles the top of the stack's source buffer, replacing it with the compiled function. */
+static void safeCompileBuffer (duk_context* context, const String& sourceName)
 {
-    for (int i = 0; i < args.numArguments; ++i)
-        Logger::writeToLog (args.arguments[i].toString());
+    duk_size_t numBytes = 0;
+    const auto* data = static_cast<const char*> (duk_get_buffer (context, -1, &numBytes));
 
-    return var::undefined();
+    safeCompileSource (context, data, numBytes, sourceName);
+
+    // Drop the source buffer, leaving only the compiled function
+    duk_remove (context, -2);
 }
 
-static var javascriptPlaceholderFunction (const var::NativeFunctionArgs&)
+/** Compiles a file from a read-only memory mapping of it.
+
+    The source is compiled directly from the mapped pages, so a bundle shared by several
+    engines or processes is only held once, in the OS page cache.
+
+    @returns false if the file couldn't be mapped, in which case nothing has been pushed.
+*/
+static bool safeCompileMappedFile (duk_context* context, const File& file)
 {
-    jassertfalse; // Careful - you're calling a function that is low priority to implement.
-    return var::undefined();
+    MemoryMappedFile mappedFile (file, MemoryMappedFile::readOnly);
+
+    if (mappedFile.getData() == nullptr)
+        return false;
+
+    safeCompileSource (context, static_cast<const char*> (mappedFile.getData()), mappedFile.getSize(), file.getFileName());
+    return true;
 }
 
-struct ConsoleObject final : DynamicObject
+/** Reads the remainder of a stream straight into a single Duktape buffer on the top of the stack.
+
+    The optional prefix and suffix are written around the stream's data, in the same buffer.
+
+    @returns false if the stream couldn't be read in full, in which case the buffer has been popped.
+*/
+static bool pushStreamAsBuffer (duk_context* context, InputStream& stream, StringRef prefix = {}, StringRef suffix = {})
 {
-    ConsoleObject()
+    const auto prefixSize = prefix.text.sizeInBytes() - 1;
+    const auto suffixSize = suffix.text.sizeInBytes() - 1;
+    const auto numBytesRemaining = stream.getNumBytesRemaining();
+
+    const auto readInto = [&stream] (char* dest, size_t maxBytes)
     {
-        setMethod ("log", javascriptLog);
+        return stream.read (dest, (int) jmin ((size_t) std::numeric_limits<int>::max(), maxBytes));
+    };
 
-        setMethod ("clear", javascriptPlaceholderFunction);
-        setMethod ("assert", javascriptPlaceholderFunction);
-        setMethod ("count", javascriptPlaceholderFunction);
-        setMethod ("countReset", javascriptPlaceholderFunction);
-        setMethod ("debug", javascriptPlaceholderFunction);
-        setMethod ("dir", javascriptPlaceholderFunction);
-        setMethod ("dirxml", javascriptPlaceholderFunction);
-        setMethod ("error", javascriptPlaceholderFunction);
-        setMethod ("exception", javascriptPlaceholderFunction);
-        setMethod ("group", javascriptPlaceholderFunction);
-        setMethod ("groupCollapsed", javascriptPlaceholderFunction);
-        setMethod ("groupEnd", javascriptPlaceholderFunction);
-        setMethod ("info", javascriptPlaceholderFunction);
-        setMethod ("profile", javascriptPlaceholderFunction);
-        setMethod ("profileEnd", javascriptPlaceholderFunction);
-        setMethod ("table", javascriptPlaceholderFunction);
-        setMethod ("time", javascriptPlaceholderFunction);
-        setMethod ("timeLog", javascriptPlaceholderFunction);
-        setMethod ("timeStamp", javascriptPlaceholderFunction);
-        setMethod ("trace", javascriptPlaceholderFunction);
-        setMethod ("warn", javascriptPlaceholderFunction);
+    char* data = nullptr;
+    size_t numRead = 0;
+
+    if (numBytesRemaining >= 0)
+    {
+        // Known length: a single fixed buffer, filled in place
+        const auto streamSize = static_cast<size_t> (numBytesRemaining);
+        data = static_cast<char*> (duk_push_fixed_buffer (context, prefixSize + streamSize + suffixSize));
+
+        while (numRead < streamSize)
+        {
+            const auto n = readInto (data + prefixSize + numRead, streamSize - numRead);
+            if (n <= 0)
+                break;
+
+            numRead += (size_t) n;
+        }
+
+        if (numRead < streamSize)
+        {
+            duk_pop (context);
+            return false;
+        }
+    }
+    else
+    {
+        // Unknown length: grow a dynamic buffer as the stream is drained
+        size_t capacity = 64 * 1024;
+        data = static_cast<char*> (duk_push_dynamic_buffer (context, capacity));
+
+        for (;;)
+        {
+            if (prefixSize + numRead == capacity)
+            {
+                capacity *= 2;
+                data = static_cast<char*> (duk_resize_buffer (context, -1, capacity));
+            }
+
+            const auto n = readInto (data + prefixSize + numRead, capacity - prefixSize - numRead);
+            if (n <= 0)
+                break;
+
+            numRead += (size_t) n;
+        }
+
+        data = static_cast<char*> (duk_resize_buffer (context, -1, prefixSize + numRead + suffixSize));
+    }
+
+    std::memcpy (data, prefix.text.getAddress(), prefixSize);
+    std::memcpy (data + prefixSize + numRead, suffix.text.getAddress(), suffixSize);
+    return true;
+}
+
+/** Reads the remainder of a stream straight into a single Duktape buffer and compiles it. */
+static void safeCompileStream (duk_context* context, InputStream& stream, const String& sourceName)
+{
+    if (! pushStreamAsBuffer (context, stream))
+        throw ECMAScriptError ("Failed to read the entire script: " + sourceName);
+
+    safeCompileBuffer (context, sourceName);
+}
+
+/** @returns true if the var holds any of the numeric types that a script number may be read back as. */
+static bool isNumeric (const var& v) noexcept
+{
+    return v.isInt() || v.isInt64() || v.isDouble();
+}
+
+/** Converts a script number to the narrowest var type that holds it exactly.
+
+    Integer values come back as int or int64 so that callers don't have to re-convert
+    doubles, which also keeps them on the fastint path once pushed back to the engine.
+    Negative zero, fractions, non-finite values and integers outside of the range
+    a double can represent exactly are kept as doubles.
+*/
+static var numberToVar (double d) noexcept
+{
+    constexpr auto maxSafeInteger = 9007199254740991.0; // 2^53 - 1
+
+    if (std::trunc (d) != d || (d == 0.0 && std::signbit (d)))
+        return d;
+
+    if (d >= (double) std::numeric_limits<int>::min() && d <= (double) std::numeric_limits<int>::max())
+        return static_cast<int> (d);
+
+    if (std::abs (d) <= maxSafeInteger)
+        return static_cast<int64> (d);
+
+    return d;
+}
+
+/** Pushes an int64 without going through a lossy double conversion where it can be avoided. */
+static void pushInt64 (duk_context* context, int64 value)
+{
+    if (value >= std::numeric_limits<duk_int_t>::min() && value <= std::numeric_limits<duk_int_t>::max())
+    {
+        // Stays a fastint when DUK_USE_FASTINT is enabled.
+        duk_push_int (context, static_cast<duk_int_t> (value));
+        return;
     }
+
+    // Anything beyond 2^53 can't be represented by an ECMAScript number.
+    jassert (std::abs (value) <= 9007199254740991LL);
+    duk_push_number (context, static_cast<duk_double_t> (value));
+}
+
+/** Pushes a String with its byte length, so that Duktape doesn't have to measure it again. */
+static void pushString (duk_context* context, const String& s)
+{
+    duk_push_lstring (context, s.toRawUTF8(), s.getNumBytesAsUTF8());
+}
+
+//==============================================================================
+/** The native text currently being pushed by registerExternalString().
+
+    Each heap's user data points at one of these, which is how Duktape's intern
+    check tells that text apart from the other strings being interned.
+*/
+struct ExternalString final
+{
+    const void* data = nullptr;
+    size_t numBytes = 0;
 };
 
+#if SQUAREPINE_DUKTAPE_USE_EXTERNAL_STRINGS
+extern "C" const void* squarepine_duktape_intern_external_string (void* udata, void* ptr, duk_size_t numBytes)
+{
+    const auto* pending = static_cast<const ExternalString*> (udata);
+
+    if (pending != nullptr && ptr == pending->data && numBytes == pending->numBytes)
+        return ptr;
+
+    return nullptr;
+}
+#endif
+
+#if SQUAREPINE_DUKTAPE_USE_JSON_FASTLANE
 //==============================================================================
-class ECMAScriptEngine::Pimpl final : private Timer
+/** Objects and arrays nested deeper than this never take the JSON path,
+    which also keeps cyclic graphs away from the serialisers.
+*/
+static constexpr int maxBulkTransferDepth = 64;
+
+/** Checks that a number reads back as the same value through JSON: non-finite values
+    become null, and JSON.stringify() writes negative zero as 0.
+*/
+static bool isBulkTransferNumber (double d) noexcept
 {
-public:
-    Pimpl()
+    return std::isfinite (d) && ! (d == 0.0 && std::signbit (d));
+}
+
+/** Counts the values in a var tree, checking that sending it as a single JSON
+    document gives the engine the same values as pushing it property by property.
+
+    @returns the number of values, or -1 if anything in the tree can't take the JSON path.
+*/
+static int countBulkTransferValues (const var& v, int depth = 0)
+{
+    if (v.isBool() || v.isInt() || v.isInt64() || v.isString())
+        return 1;
+
+    if (v.isDouble())
+        return isBulkTransferNumber ((double) v) ? 1 : -1;
+
+    if (depth >= maxBulkTransferDepth)
+        return -1;
+
+    if (auto* array = v.getArray())
     {
-        reset();
+        int count = 1;
+
+        for (const auto& e : *array)
+        {
+            const auto n = countBulkTransferValues (e, depth + 1);
+            if (n < 0)
+                return -1;
+
+            count += n;
+        }
+
+        return count;
     }
 
-    ~Pimpl() override
+    if (auto* object = v.getDynamicObject())
     {
-        // NB: Explicitly stopping the timer so as to avoid any late calls to dereferencing a (cleaned up) context.
-        stopTimer();
+        int count = 1;
+
+        for (const auto& e : object->getProperties())
+        {
+            const auto n = countBulkTransferValues (e.value, depth + 1);
+            if (n < 0)
+                return -1;
+
+            count += n;
+        }
+
+        return count;
     }
 
-    //==============================================================================
-    var evaluate (const String& code)
+    // Undefined and void (which has no JSON equivalent), methods and binary data.
+    return -1;
+}
+
+/** Counts the values in an object graph inside the engine, reading the heap structures
+    directly rather than going through the API.
+
+    The graph qualifies for the JSON path when it only holds plain objects, dense arrays
+    and JSON-compatible primitives, so that JSON.stringify() followed by JSON::parse()
+    gives the same var as enumerating it property by property.
+
+    @returns the number of values, or -1 if anything in the graph can't take the JSON path.
+*/
+static int countBulkTransferValues (duk_hthread* thread, duk_hobject* object, int depth = 0)
+{
+    if (depth >= maxBulkTransferDepth
+        || DUK_HOBJECT_IS_CALLABLE (object)
+        || DUK_HOBJECT_HAS_EXOTIC_PROXYOBJ (object))
+        return -1;
+
+    auto* heap = thread->heap;
+
+    // JSON.stringify() calls an own toJSON() too, even a non-enumerable one.
+    duk_int_t entryIndex = -1, hashIndex = -1;
+    if (duk_hobject_find_entry (heap, object, DUK_HTHREAD_STRING_TO_JSON (thread), &entryIndex, &hashIndex))
+        return -1;
+
+    const auto countValue = [&] (duk_tval* tv) -> int
     {
-        jassert (code.isNotEmpty());
-        auto* rawContext = dukContext.get();
+        switch (DUK_TVAL_GET_TAG (tv))
+        {
+            case DUK_TAG_NULL:
+            case DUK_TAG_BOOLEAN:
+                return 1;
 
-        try
+            case DUK_TAG_STRING:
+                return DUK_HSTRING_HAS_SYMBOL (DUK_TVAL_GET_STRING (tv)) ? -1 : 1;
+
+            case DUK_TAG_OBJECT:
+                return countBulkTransferValues (thread, DUK_TVAL_GET_OBJECT (tv), depth + 1);
+
+            default:
+                if (DUK_TVAL_IS_NUMBER (tv))
+                    return isBulkTransferNumber (DUK_TVAL_GET_NUMBER (tv)) ? 1 : -1;
+
+                // Undefined, buffers, pointers and lightfuncs.
+                return -1;
+        }
+    };
+
+    int count = 1;
+
+    switch (DUK_HOBJECT_GET_CLASS_NUMBER (object))
+    {
+        case DUK_HOBJECT_CLASS_OBJECT:
         {
-            safeEvalString (rawContext, code);
+            if (DUK_HOBJECT_GET_PROTOTYPE (heap, object) != thread->builtins[DUK_BIDX_OBJECT_PROTOTYPE])
+                return -1;
+
+            for (duk_uint_fast32_t i = 0; i < DUK_HOBJECT_GET_ENEXT (object); ++i)
+            {
+                auto* key = DUK_HOBJECT_E_GET_KEY (heap, object, i);
+
+                // Deleted, hidden and non-enumerable properties are skipped by both paths.
+                if (key == nullptr
+                    || DUK_HSTRING_HAS_SYMBOL (key)
+                    || (DUK_HOBJECT_E_GET_FLAGS (heap, object, i) & DUK_PROPDESC_FLAG_ENUMERABLE) == 0)
+                    continue;
+
+                if (DUK_HOBJECT_E_SLOT_IS_ACCESSOR (heap, object, i))
+                    return -1;
+
+                const auto n = countValue (DUK_HOBJECT_E_GET_VALUE_TVAL_PTR (heap, object, i));
+                if (n < 0)
+                    return -1;
+
+                count += n;
+            }
         }
-        catch (const ECMAScriptError& error)
+        break;
+
+        case DUK_HOBJECT_CLASS_ARRAY:
         {
-            reset();
-            throw error;
+            // Only dense arrays: sparse ones and holes read back as undefined per property,
+            // but as null through JSON.
+            if (DUK_HOBJECT_GET_PROTOTYPE (heap, object) != thread->builtins[DUK_BIDX_ARRAY_PROTOTYPE]
+                || ! DUK_HOBJECT_HAS_ARRAY_PART (object))
+                return -1;
+
+            const auto length = ((duk_harray*) object)->length;
+            if (length > DUK_HOBJECT_GET_ASIZE (object))
+                return -1;
+
+            for (duk_uint32_t i = 0; i < length; ++i)
+            {
+                auto* tv = DUK_HOBJECT_A_GET_VALUE_PTR (heap, object, i);
+                if (DUK_TVAL_IS_UNUSED (tv))
+                    return -1;
+
+                const auto n = countValue (tv);
+                if (n < 0)
+                    return -1;
+
+                count += n;
+            }
         }
+        break;
 
-        auto result = readVarFromDukStack (dukContext, -1);
-        duk_pop (rawContext);
+        default:
+            return -1;
+    }
 
-        return result;
+    return count;
+}
+
+/** Checks whether the prototypes of the objects and arrays countBulkTransferValues() accepts
+    provide a toJSON(), which JSON.stringify() would call on every one of them.
+
+    This reads the prototype chains without invoking getters or proxy traps.
+*/
+static bool prototypesHaveToJSON (duk_hthread* thread)
+{
+    auto* key = DUK_HTHREAD_STRING_TO_JSON (thread);
+
+    return duk_hobject_hasprop_raw (thread, thread->builtins[DUK_BIDX_OBJECT_PROTOTYPE], key)
+        || duk_hobject_hasprop_raw (thread, thread->builtins[DUK_BIDX_ARRAY_PROTOTYPE], key);
+}
+
+//==============================================================================
+/** Writes a var tree as JSON straight into a Duktape dynamic buffer on the top of the stack.
+
+    Only use this on trees that countBulkTransferValues() accepted.
+*/
+class BulkTransferWriter final
+{
+public:
+    BulkTransferWriter (duk_context* c, size_t initialCapacity) :
+        context (c),
+        capacity (jmax ((size_t) 64, initialCapacity)),
+        data (static_cast<char*> (duk_push_dynamic_buffer (context, capacity)))
+    {
     }
 
-    var evaluate (const File& code)
+    /** Decodes the written document, replacing the buffer with the resulting value. */
+    void finishAndDecode()
     {
-        jassert (code.existsAsFile());
-        jassert (code.loadFileAsString().isNotEmpty());
-        auto* rawContext = dukContext.get();
+        duk_resize_buffer (context, -1, size);
+        duk_buffer_to_string (context, -1);
+        duk_json_decode (context, -1);
+    }
 
-        try
+    void writeValue (const var& v)
+    {
+        if (v.isBool())
         {
-            safeCompileFile (rawContext, code);
-            safeCall (rawContext, 0);
+            if ((bool) v)   write ("true", 4);
+            else            write ("false", 5);
         }
-        catch (const ECMAScriptError& error)
+        else if (v.isInt() || v.isInt64())
         {
-            reset();
-            throw error;
+            char text[24];
+            const auto n = std::snprintf (text, sizeof (text), "%lld", (long long) (int64) v);
+            write (text, (size_t) n);
+        }
+        else if (v.isDouble())
+        {
+            writeDouble ((double) v);
+        }
+        else if (v.isString())
+        {
+            writeString (v.toString());
         }
+        else if (auto* array = v.getArray())
+        {
+            write ('[');
 
-        auto result = readVarFromDukStack (dukContext, -1);
-        duk_pop (rawContext);
-        return result;
+            for (int i = 0; i < array->size(); ++i)
+            {
+                if (i > 0)
+                    write (',');
+
+                writeValue (array->getReference (i));
+            }
+
+            write (']');
+        }
+        else if (auto* object = v.getDynamicObject())
+        {
+            write ('{');
+            bool first = true;
+
+            for (const auto& e : object->getProperties())
+            {
+                if (! first)
+                    write (',');
+
+                first = false;
+                writeString (e.name.toString());
+                write (':');
+                writeValue (e.value);
+            }
+
+            write ('}');
+        }
+        else
+        {
+            jassertfalse; // Should have been rejected by countBulkTransferValues()
+            write ("null", 4);
+        }
     }
-    //==============================================================================
-    void registerNativeProperty (const String& name, var value)
+
+private:
+    duk_context* context;
+    size_t size = 0, capacity;
+    char* data;
+
+    void ensureSpace (size_t numBytes)
     {
-        auto* rawContext = dukContext.get();
+        if (size + numBytes <= capacity)
+            return;
 
-        duk_push_global_object (rawContext);
-        pushVarToDukStack (dukContext, value, true);
-        duk_put_prop_string (rawContext, -2, name.toRawUTF8());
-        duk_pop (rawContext);
+        capacity = jmax (capacity * 2, size + numBytes);
+        data = static_cast<char*> (duk_resize_buffer (context, -1, capacity));
     }
 
-    void registerNativeFunction (const String& name, var::NativeFunction value)
+    void write (char c)
     {
-        registerNativeProperty (name, value);
+        ensureSpace (1);
+        data[size++] = c;
     }
 
-    void registerNativeProperty (const String& target, const String& name, const var& value)
+    void write (const char* text, size_t numBytes)
     {
-        auto* rawContext = dukContext.get();
+        ensureSpace (numBytes);
+        std::memcpy (data + size, text, numBytes);
+        size += numBytes;
+    }
 
-        try
+    void writeDouble (double d)
+    {
+        char text[32];
+        const auto n = std::snprintf (text, sizeof (text), "%.17g", d);
+
+        // snprintf follows the C locale's decimal point, JSON doesn't.
+        for (int i = 0; i < n; ++i)
+            if (text[i] == ',')
+                text[i] = '.';
+
+        write (text, (size_t) n);
+    }
+
+    void writeString (const String& s)
+    {
+        const auto* text = s.toRawUTF8();
+        const auto numBytes = s.getNumBytesAsUTF8();
+
+        // Worst case is every byte becoming a \u00XX escape.
+        ensureSpace (numBytes * 6 + 2);
+        data[size++] = '"';
+
+        for (size_t i = 0; i < numBytes; ++i)
         {
-            safeEvalString (rawContext, target);
+            const auto c = static_cast<unsigned char> (text[i]);
+
+            if (c == '"' || c == '\\')
+            {
+                data[size++] = '\\';
+                data[size++] = (char) c;
+            }
+            else if (c < 0x20)
+            {
+                static const char hexDigits[] = "0123456789abcdef";
+                std::memcpy (data + size, "\\u00", 4);
+                data[size + 4] = hexDigits[c >> 4];
+                data[size + 5] = hexDigits[c & 15];
+                size += 6;
+            }
+            else
+            {
+                // Multi-byte UTF-8 sequences are passed through untouched.
+                data[size++] = (char) c;
+            }
         }
-        catch (const ECMAScriptError& error)
+
+        data[size++] = '"';
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (BulkTransferWriter)
+};
+#endif
+
+//==============================================================================
+/** Accumulates durations into logarithmic buckets, eight per power of two,
+    so that percentiles can be estimated to within about 9% in constant space.
+*/
+class DurationHistogram final
+{
+public:
+    DurationHistogram() = default;
+
+    void add (double microseconds) noexcept
+    {
+        microseconds = jmax (0.0, microseconds);
+
+        minimum = count == 0 ? microseconds : jmin (minimum, microseconds);
+        maximum = count == 0 ? microseconds : jmax (maximum, microseconds);
+        sum += microseconds;
+        ++count;
+
+        ++buckets[(size_t) getBucketIndex (microseconds)];
+    }
+
+    double getPercentile (double percentile) const noexcept
+    {
+        if (count == 0)
+            return 0.0;
+
+        const auto target = (int64) std::ceil ((double) count * percentile / 100.0);
+        int64 cumulative = 0;
+
+        for (int i = 0; i < numBuckets; ++i)
         {
-            reset();
-            throw error;
+            cumulative += buckets[(size_t) i];
+
+            if (cumulative >= target)
+                return jlimit (minimum, maximum, getBucketUpperBound (i));
+        }
+
+        return maximum;
+    }
+
+    ECMAScriptEngine::TimingStatistics getStatistics() const noexcept
+    {
+        ECMAScriptEngine::TimingStatistics stats;
+        stats.count = count;
+
+        if (count > 0)
+        {
+            stats.minimumMs = minimum / 1000.0;
+            stats.averageMs = sum / (double) count / 1000.0;
+            stats.p99Ms = getPercentile (99.0) / 1000.0;
+            stats.maximumMs = maximum / 1000.0;
+        }
+
+        return stats;
+    }
+
+private:
+    static constexpr int bucketsPerOctave = 8;
+    static constexpr int numBuckets = bucketsPerOctave * 40 + 1;
+
+    std::array<uint32, (size_t) numBuckets> buckets {};
+    int64 count = 0;
+    double sum = 0.0, minimum = 0.0, maximum = 0.0;
+
+    // Bucket 0 holds everything under 1us; bucket i holds [2^((i - 1) / 8), 2^(i / 8)) microseconds.
+    static int getBucketIndex (double microseconds) noexcept
+    {
+        if (microseconds < 1.0)
+            return 0;
+
+        return jmin (numBuckets - 1, 1 + (int) (std::log2 (microseconds) * bucketsPerOctave));
+    }
+
+    static double getBucketUpperBound (int index) noexcept
+    {
+        return std::exp2 ((double) index / bucketsPerOctave);
+    }
+};
+
+//==============================================================================
+static var javascriptPlaceholderFunction (const var::NativeFunctionArgs&)
+{
+    jassertfalse; // Careful - you're calling a function that is low priority to implement.
+    return var::undefined();
+}
+
+struct ConsoleObject final : DynamicObject
+{
+    ConsoleObject()
+    {
+        setMethod ("clear", javascriptPlaceholderFunction);
+        setMethod ("assert", javascriptPlaceholderFunction);
+        setMethod ("dir", javascriptPlaceholderFunction);
+        setMethod ("dirxml", javascriptPlaceholderFunction);
+        setMethod ("exception", javascriptPlaceholderFunction);
+        setMethod ("group", javascriptPlaceholderFunction);
+        setMethod ("groupCollapsed", javascriptPlaceholderFunction);
+        setMethod ("groupEnd", javascriptPlaceholderFunction);
+        setMethod ("table", javascriptPlaceholderFunction);
+    }
+};
+
+//==============================================================================
+class ECMAScriptEngine::Pimpl final : private Timer
+{
+public:
+    Pimpl()
+    {
+        reset();
+    }
+
+    ~Pimpl() override
+    {
+        // NB: Explicitly stopping the timer so as to avoid any late calls to dereferencing a (cleaned up) context.
+        stopTimer();
+        idleCollector.reset();
+
+        // The final collections of the heap aren't worth recording
+        duk_set_gc_pause_handler (dukContext.get(), nullptr, nullptr);
+    }
+
+    //==============================================================================
+    var evaluate (const String& code)
+    {
+        jassert (code.isNotEmpty());
+        auto* rawContext = dukContext.get();
+
+        try
+        {
+            countScriptCall();
+            safeEvalString (rawContext, code);
+        }
+        catch (const ECMAScriptError& error)
+        {
+            reset();
+            throw error;
+        }
+
+        auto result = readVarFromDukStack (dukContext, -1);
+        duk_pop (rawContext);
+
+        return result;
+    }
+
+    var evaluate (const File& code)
+    {
+        jassert (code.existsAsFile());
+        auto* rawContext = dukContext.get();
+
+        try
+        {
+            if (! safeCompileMappedFile (rawContext, code))
+            {
+                // Files that can't be mapped (e.g. empty ones) are streamed in instead
+                FileInputStream stream (code);
+
+                if (stream.failedToOpen())
+                    throw ECMAScriptError ("Unable to open script file: " + code.getFullPathName());
+
+                safeCompileStream (rawContext, stream, code.getFileName());
+            }
+
+            countScriptCall();
+            safeCall (rawContext, 0);
+        }
+        catch (const ECMAScriptError& error)
+        {
+            reset();
+            throw error;
+        }
+
+        auto result = readVarFromDukStack (dukContext, -1);
+        duk_pop (rawContext);
+        return result;
+    }
+
+    var evaluate (InputStream& stream, const String& sourceName)
+    {
+        auto* rawContext = dukContext.get();
+
+        try
+        {
+            safeCompileStream (rawContext, stream, sourceName);
+            countScriptCall();
+            safeCall (rawContext, 0);
+        }
+        catch (const ECMAScriptError& error)
+        {
+            reset();
+            throw error;
+        }
+
+        auto result = readVarFromDukStack (dukContext, -1);
+        duk_pop (rawContext);
+        return result;
+    }
+    //==============================================================================
+    void registerNativeProperty (const String& name, var value)
+    {
+        auto* rawContext = dukContext.get();
+
+        duk_push_global_object (rawContext);
+        pushVarToDukStack (dukContext, value, true, name);
+        duk_put_prop_string (rawContext, -2, name.toRawUTF8());
+        duk_pop (rawContext);
+    }
+
+    void registerNativeFunction (const String& name, var::NativeFunction value)
+    {
+        registerNativeProperty (name, value);
+    }
+
+    void registerNativeStringMethod (const String& target, const String& name, ECMAScriptEngine::NativeStringFunction fn)
+    {
+        auto* rawContext = dukContext.get();
+        auto bindingName = name;
+
+        if (target.isEmpty())
+        {
+            duk_push_global_object (rawContext);
+        }
+        else
+        {
+            try
+            {
+                safeEvalString (rawContext, target);
+            }
+            catch (const ECMAScriptError& error)
+            {
+                reset();
+                throw error;
+            }
+
+            bindingName = target + "." + name;
+        }
+
+        pushPersistentFunction (rawContext, std::make_unique<LambdaHelper> (std::move (fn), nextHelperId++, bindingName),
+                                LambdaHelper::invokeStringMethodFromDukContext);
+        duk_put_prop_string (rawContext, -2, name.toRawUTF8());
+        duk_pop (rawContext);
+    }
+
+    void registerExternalString (const String& name, const char* utf8, size_t numBytes)
+    {
+        auto* rawContext = dukContext.get();
+
+        duk_push_global_object (rawContext);
+        pushExternalString (rawContext, utf8, numBytes);
+        duk_put_prop_string (rawContext, -2, name.toRawUTF8());
+        duk_pop (rawContext);
+    }
+
+    /** Pushes native text that outlives the heap, without copying it when external strings are enabled. */
+    void pushExternalString (duk_context* context, const char* utf8, size_t numBytes)
+    {
+        // Duktape reads external text as a C string: registerExternalString() documents that
+        // callers must pass terminated text, as the terminator itself is past numBytes.
+        pendingExternalString = { utf8, numBytes };
+        duk_push_lstring (context, utf8, numBytes);
+        pendingExternalString = {};
+    }
+
+    void registerNativeProperty (const String& target, const String& name, const var& value)
+    {
+        auto* rawContext = dukContext.get();
+
+        try
+        {
+            safeEvalString (rawContext, target);
+        }
+        catch (const ECMAScriptError& error)
+        {
+            reset();
+            throw error;
+        }
+
+        pushVarToDukStack (dukContext, value, true, target + "." + name);
+        duk_put_prop_string (rawContext, -2, name.toRawUTF8());
+        duk_pop (rawContext);
+    }
+
+    //==============================================================================
+    var invoke (const String& name, const std::vector<var>& vargs)
+    {
+        auto* rawContext = dukContext.get();
+
+        try
+        {
+            safeEvalString (rawContext, name);
+
+            if (! duk_is_function (rawContext, -1))
+                throw ECMAScriptError ("Invocation failed, target is not a function.");
+
+            const auto nargs = static_cast<duk_idx_t> (vargs.size());
+            duk_require_stack_top (rawContext, nargs);
+
+            for (auto& p : vargs)
+                pushVarToDukStack (dukContext, p);
+
+            countScriptCall();
+            safeCall (rawContext, nargs);
+        }
+        catch (const ECMAScriptError& error)
+        {
+            reset();
+            throw error;
+        }
+
+        auto result = readVarFromDukStack (dukContext, -1);
+        duk_pop (rawContext);
+
+        return result;
+    }
+
+    //==============================================================================
+    void addModuleResolver (std::unique_ptr<ECMAScriptModuleResolver> resolver)
+    {
+        jassert (resolver != nullptr);
+        moduleResolvers.push_back (std::move (resolver));
+    }
+
+    void addCompiledModule (const String& canonicalId, const MemoryBlock& bytecode)
+    {
+        compiledModules[canonicalId] = bytecode;
+    }
+
+    void clearModuleCaches()
+    {
+        compiledModules.clear();
+
+        auto* rawContext = dukContext.get();
+        duk_push_global_stash (rawContext);
+        duk_push_bare_object (rawContext);
+        duk_put_prop_string (rawContext, -2, DUK_HIDDEN_SYMBOL ("ModuleCache"));
+        duk_pop (rawContext);
+    }
+
+    var require (const String& id)
+    {
+        auto* rawContext = dukContext.get();
+
+        countScriptCall();
+
+        if (! pushModuleExports (rawContext, id, {}))
+        {
+            const String stack = duk_safe_to_stacktrace (rawContext, -1);
+            const String msg = duk_safe_to_string (rawContext, -1);
+            const ECMAScriptError error (msg, stack, getContextDump (rawContext));
+
+            duk_pop (rawContext);
+            throw error;
+        }
+
+        auto result = readVarFromDukStack (dukContext, -1);
+        duk_pop (rawContext);
+        return result;
+    }
+
+    /** Pushes a `require` function that resolves relative identifiers against the given module. */
+    static void pushRequireFunction (duk_context* rawContext, const String& moduleId)
+    {
+        duk_push_c_function (rawContext, requireFromDukContext, 1);
+        duk_push_string (rawContext, moduleId.toRawUTF8());
+        duk_put_prop_string (rawContext, -2, DUK_HIDDEN_SYMBOL ("ModuleId"));
+    }
+
+    static duk_ret_t requireFromDukContext (duk_context* context)
+    {
+        const auto* id = duk_require_string (context, 0);
+        bool succeeded = false;
+
+        // Everything with a destructor lives in this scope, so that it's gone before duk_throw() unwinds
+        {
+            duk_push_current_function (context);
+            duk_get_prop_string (context, -1, DUK_HIDDEN_SYMBOL ("ModuleId"));
+            const String parentId (CharPointer_UTF8 (duk_get_string (context, -1)));
+            duk_pop_2 (context);
+
+            duk_push_global_stash (context);
+            duk_get_prop_string (context, -1, DUK_HIDDEN_SYMBOL ("__EcmascriptEngineInstance__"));
+            auto* engine = static_cast<ECMAScriptEngine::Pimpl*> (duk_get_pointer (context, -1));
+            duk_pop_2 (context);
+
+            succeeded = engine->pushModuleExports (context, String (CharPointer_UTF8 (id)), parentId);
+        }
+
+        if (! succeeded)
+            return duk_throw (context);
+
+        return 1;
+    }
+
+    /** Resolves, loads and runs a module as needed, pushing its exports.
+
+        This never throws through Duktape: on failure the error is pushed instead.
+
+        @returns true if the exports were pushed, false if an error was.
+    */
+    bool pushModuleExports (duk_context* rawContext, const String& id, const String& parentId)
+    {
+        ECMAScriptModuleResolver* resolver = nullptr;
+        String canonicalId;
+
+        for (auto& r : moduleResolvers)
+        {
+            canonicalId = r->resolve (id, parentId);
+
+            if (canonicalId.isNotEmpty())
+            {
+                resolver = r.get();
+                break;
+            }
+        }
+
+        if (resolver == nullptr)
+        {
+            duk_push_error_object (rawContext, DUK_ERR_ERROR, "Cannot find module '%s'", id.toRawUTF8());
+            return false;
+        }
+
+        duk_push_global_stash (rawContext);
+        duk_get_prop_string (rawContext, -1, DUK_HIDDEN_SYMBOL ("ModuleCache"));
+        duk_remove (rawContext, -2);
+        const auto cacheIdx = duk_get_top_index (rawContext);
+
+        // Modules that have been loaded in this heap, or that are still loading in case of a circular require
+        if (duk_get_prop_string (rawContext, cacheIdx, canonicalId.toRawUTF8()))
+        {
+            duk_get_prop_string (rawContext, -1, "exports");
+            duk_replace (rawContext, cacheIdx);
+            duk_pop (rawContext);
+            return true;
+        }
+
+        duk_pop (rawContext);
+
+        if (! pushModuleFunction (rawContext, *resolver, canonicalId))
+        {
+            duk_replace (rawContext, cacheIdx);
+            return false;
+        }
+
+        const auto functionIdx = cacheIdx + 1;
+
+        // The module is cached before it runs, so that circular requires get its partial exports
+        duk_push_object (rawContext);
+        const auto moduleIdx = functionIdx + 1;
+
+        duk_push_string (rawContext, canonicalId.toRawUTF8());
+        duk_put_prop_string (rawContext, moduleIdx, "id");
+        duk_push_object (rawContext);
+        duk_put_prop_string (rawContext, moduleIdx, "exports");
+        duk_push_false (rawContext);
+        duk_put_prop_string (rawContext, moduleIdx, "loaded");
+
+        duk_dup (rawContext, moduleIdx);
+        duk_put_prop_string (rawContext, cacheIdx, canonicalId.toRawUTF8());
+
+        // function (exports, require, module, __filename, __dirname), with `this` being exports
+        duk_dup (rawContext, functionIdx);
+        duk_get_prop_string (rawContext, moduleIdx, "exports");
+        duk_get_prop_string (rawContext, moduleIdx, "exports");
+        pushRequireFunction (rawContext, canonicalId);
+        duk_dup (rawContext, moduleIdx);
+        duk_push_string (rawContext, canonicalId.toRawUTF8());
+        duk_push_string (rawContext, ECMAScriptModuleResolver::getDirectory (canonicalId).toRawUTF8());
+
+        if (duk_pcall_method (rawContext, 5) != DUK_EXEC_SUCCESS)
+        {
+            // Forget the failed module so that requiring it again retries it
+            duk_del_prop_string (rawContext, cacheIdx, canonicalId.toRawUTF8());
+            duk_replace (rawContext, cacheIdx);
+            duk_set_top (rawContext, cacheIdx + 1);
+            return false;
+        }
+
+        duk_pop (rawContext);
+
+        duk_push_true (rawContext);
+        duk_put_prop_string (rawContext, moduleIdx, "loaded");
+
+        // Re-read the exports, since the module may have replaced module.exports
+        duk_get_prop_string (rawContext, moduleIdx, "exports");
+        duk_replace (rawContext, cacheIdx);
+        duk_set_top (rawContext, cacheIdx + 1);
+        return true;
+    }
+
+    /** Pushes the compiled wrapper function of a module, from the bytecode cache or by compiling its source.
+
+        @returns true if the function was pushed, false if an error was.
+    */
+    bool pushModuleFunction (duk_context* rawContext, ECMAScriptModuleResolver& resolver, const String& canonicalId)
+    {
+        const auto compiled = compiledModules.find (canonicalId);
+
+        if (compiled != compiledModules.cend())
+        {
+            const auto& bytecode = compiled->second;
+            auto* data = duk_push_fixed_buffer (rawContext, bytecode.getSize());
+            std::memcpy (data, bytecode.getData(), bytecode.getSize());
+
+            return duk_safe_call (rawContext, [] (duk_context* c, void*) -> duk_ret_t
+            {
+                duk_load_function (c);
+                return 1;
+            }, nullptr, 1, 1) == DUK_EXEC_SUCCESS;
+        }
+
+        auto stream = resolver.createInputStream (canonicalId);
+
+        // Each module is compiled once as a function taking the CommonJS free variables.
+        // The prefix has no line breaks, so line numbers in errors match the source file.
+        if (stream == nullptr
+            || ! pushStreamAsBuffer (rawContext, *stream,
+                                     "function (exports, require, module, __filename, __dirname) {",
+                                     "\n}"))
+        {
+            duk_push_error_object (rawContext, DUK_ERR_ERROR, "Unable to load module '%s'", canonicalId.toRawUTF8());
+            return false;
+        }
+
+        duk_size_t numBytes = 0;
+        const auto* data = static_cast<const char*> (duk_get_buffer (rawContext, -1, &numBytes));
+
+        // Modules are compiled once and their bytecode is reused, so they're worth optimising
+       #if SQUAREPINE_DUKTAPE_OPTIMIZE_BYTECODE
+        const duk_uint_t compileFlags = DUK_COMPILE_FUNCTION | DUK_COMPILE_OPTIMIZE;
+       #else
+        const duk_uint_t compileFlags = DUK_COMPILE_FUNCTION;
+       #endif
+
+        duk_push_string (rawContext, canonicalId.toRawUTF8());
+        const auto compileResult = duk_pcompile_lstring_filename (rawContext, compileFlags, data, numBytes);
+        duk_remove (rawContext, -2);
+
+        if (compileResult != DUK_EXEC_SUCCESS)
+            return false;
+
+        // Keep the bytecode, so that later heaps (e.g. after a reset) skip compiling the module
+        duk_dup (rawContext, -1);
+        duk_dump_function (rawContext);
+
+        duk_size_t bytecodeSize = 0;
+        const auto* bytecode = duk_get_buffer (rawContext, -1, &bytecodeSize);
+        compiledModules[canonicalId] = MemoryBlock (bytecode, bytecodeSize);
+        duk_pop (rawContext);
+
+        return true;
+    }
+
+    //==============================================================================
+    struct ProfileRecorder final
+    {
+        /** @returns the index of the frame for an activation, adding it to the profile the first time it's seen. */
+        int getFrameIndex (const duk_callstack_frame& activation)
+        {
+            frameKey.clear();
+
+            if (activation.name != nullptr)
+                frameKey.append (activation.name, activation.name_len);
+
+            const auto nameLength = frameKey.size();
+            frameKey.push_back ('\0');
+
+            if (activation.file_name != nullptr)
+                frameKey.append (activation.file_name, activation.file_name_len);
+
+            const auto fileNameLength = frameKey.size() - nameLength - 1;
+            frameKey.push_back ('\0');
+            frameKey.append (std::to_string (activation.start_line));
+
+            const auto existing = frameIndices.find (frameKey);
+            if (existing != frameIndices.cend())
+                return existing->second;
+
+            ECMAScriptProfile::Frame frame;
+            frame.fileName = String::fromUTF8 (frameKey.data() + nameLength + 1, (int) fileNameLength);
+            frame.lineNumber = (int) activation.start_line;
+
+            if (nameLength > 0)
+                frame.functionName = String::fromUTF8 (frameKey.data(), (int) nameLength);
+            else if (activation.is_native)
+                frame.functionName = "(native)";
+            else
+                frame.functionName = "(anonymous)";
+
+            const auto index = profile.addFrame (std::move (frame));
+            frameIndices.emplace (frameKey, index);
+            return index;
+        }
+
+        ECMAScriptProfile profile;
+        std::unordered_map<std::string, int> frameIndices;
+        std::string frameKey;
+        int64 intervalTicks = 0, nextSampleTicks = 0;
+        bool startedFromConsole = false;
+        String consoleLabel;
+    };
+
+    /** The number of opcodes executed between checks of whether a sample is due. */
+    static constexpr duk_int_t profilerOpcodeInterval = 1000;
+
+    /** The deepest call stack recorded; outer frames beyond this are dropped. */
+    static constexpr int maxProfileDepth = 128;
+
+    static int64 ticksToMicroseconds (int64 ticks) noexcept
+    {
+        return (int64) (Time::highResolutionTicksToSeconds (ticks) * 1.0e6);
+    }
+
+    static void sampleCallStack (duk_context* context, void* userData)
+    {
+        auto& recorder = *static_cast<ProfileRecorder*> (userData);
+
+        const auto now = Time::getHighResolutionTicks();
+        if (now < recorder.nextSampleTicks)
+            return;
+
+        recorder.nextSampleTicks = now + recorder.intervalTicks;
+
+        try
+        {
+            // Read in place, without allocating or calling into scripts.
+            std::array<duk_callstack_frame, maxProfileDepth> activations;
+            const auto depth = (int) duk_get_callstack_frames (context, activations.data(), maxProfileDepth);
+
+            std::array<int, maxProfileDepth> stack;
+
+            for (int i = 0; i < depth; ++i)
+                stack[(size_t) i] = recorder.getFrameIndex (activations[(size_t) i]);
+
+            recorder.profile.addSample (stack.data(), depth, ticksToMicroseconds (now));
+        }
+        catch (...)
+        {
+            // The interrupt handler must not throw through the executor: drop the sample.
+        }
+    }
+
+    void installProfiler (duk_context* rawContext)
+    {
+        if (profiler != nullptr)
+            duk_set_interrupt_handler (rawContext, sampleCallStack, profiler.get(), profilerOpcodeInterval);
+    }
+
+    bool startProfiling (int samplingIntervalMicroseconds)
+    {
+       #if defined (DUK_USE_INTERRUPT_COUNTER)
+        if (profiler != nullptr)
+            return false;
+
+        const auto now = Time::getHighResolutionTicks();
+
+        profiler = std::make_unique<ProfileRecorder>();
+        profiler->intervalTicks = jmax ((int64) 1, Time::getHighResolutionTicksPerSecond() * jmax (1, samplingIntervalMicroseconds) / 1000000);
+        profiler->nextSampleTicks = now + profiler->intervalTicks;
+        profiler->profile.start (ticksToMicroseconds (now));
+
+        installProfiler (dukContext.get());
+        return true;
+       #else
+        // Profiling needs DUK_USE_INTERRUPT_COUNTER: enable SQUAREPINE_DUKTAPE_ENABLE_PROFILER.
+        ignoreUnused (samplingIntervalMicroseconds);
+        return false;
+       #endif
+    }
+
+    ECMAScriptProfile stopProfiling()
+    {
+        if (profiler == nullptr)
+            return {};
+
+        duk_set_interrupt_handler (dukContext.get(), nullptr, nullptr, 0);
+
+        auto recorder = std::move (profiler);
+        recorder->profile.finish (ticksToMicroseconds (Time::getHighResolutionTicks()));
+        return std::move (recorder->profile);
+    }
+
+    void startConsoleProfile (const String& label)
+    {
+        // Without anywhere for the profile to go, don't pay for recording it.
+        if (consoleProfileCallback == nullptr && consoleProfileDirectory == File())
+            return;
+
+        if (startProfiling (1000))
+        {
+            profiler->startedFromConsole = true;
+            profiler->consoleLabel = label;
+        }
+    }
+
+    void finishConsoleProfile()
+    {
+        // Profiles started from C++ are only stopped from C++
+        if (profiler == nullptr || ! profiler->startedFromConsole)
+            return;
+
+        const auto label = profiler->consoleLabel;
+        const auto profile = stopProfiling();
+
+        if (consoleProfileCallback != nullptr)
+        {
+            consoleProfileCallback (label, profile);
+            return;
+        }
+
+        // The directory may have been cleared while the profile was being recorded.
+        if (consoleProfileDirectory == File() || consoleProfileDirectory.createDirectory().failed())
+            return;
+
+        const auto file = consoleProfileDirectory.getNonexistentChildFile (label.isNotEmpty() ? File::createLegalFileName (label) : String ("profile"),
+                                                                           ".cpuprofile", false);
+
+        FileOutputStream output (file);
+
+        if (output.openedOk())
+        {
+            profile.writeChromeProfile (output);
+            Logger::writeToLog ("Script profile written to " + file.getFullPathName());
+        }
+    }
+
+    //==============================================================================
+    static ECMAScriptEngine::Pimpl& getEngineFromDukContext (duk_context* context)
+    {
+        duk_push_global_stash (context);
+        duk_get_prop_string (context, -1, DUK_HIDDEN_SYMBOL ("__EcmascriptEngineInstance__"));
+        auto* engine = static_cast<ECMAScriptEngine::Pimpl*> (duk_get_pointer (context, -1));
+        duk_pop_2 (context);
+
+        jassert (engine != nullptr);
+        return *engine;
+    }
+
+    /** @returns the label passed as the first argument, or "default". This may throw into the script. */
+    static const char* getLabelArgument (duk_context* context)
+    {
+        if (duk_is_undefined (context, 0))
+            return "default";
+
+        return duk_to_string (context, 0);
+    }
+
+    static String formatMilliseconds (double ms)
+    {
+        return String (ms, 3) + "ms";
+    }
+
+    void writeLog (ECMAScriptLogSink::Level level, const String& message)
+    {
+        logSink.write (level, message.toRawUTF8(), message.getNumBytesAsUTF8());
+    }
+
+    /** console.log() and friends, where the function's magic is the log level.
+
+        The level is checked before any of the arguments are converted, and the
+        record is formatted into a reused buffer, so that filtered out calls
+        cost next to nothing and enabled ones never wait on the output.
+    */
+    static duk_ret_t consoleWrite (duk_context* context)
+    {
+        const auto level = (ECMAScriptLogSink::Level) duk_get_current_magic (context);
+        auto& engine = getEngineFromDukContext (context);
+
+        if (! engine.logSink.isEnabled (level))
+            return 0;
+
+        auto& record = engine.logRecord;
+        record.clear();
+
+        for (duk_idx_t i = 0; i < duk_get_top (context); ++i)
+        {
+            duk_size_t numBytes = 0;
+            const auto* text = duk_safe_to_lstring (context, i, &numBytes);
+
+            if (i > 0)
+                record.push_back (' ');
+
+            record.append (text, (size_t) numBytes);
+        }
+
+        engine.logSink.write (level, record.data(), record.size());
+        return 0;
+    }
+
+    static duk_ret_t consoleTime (duk_context* context)
+    {
+        const auto* label = getLabelArgument (context);
+        auto& engine = getEngineFromDukContext (context);
+
+        const auto inserted = engine.consoleTimers.emplace (String (CharPointer_UTF8 (label)), Time::getHighResolutionTicks()).second;
+
+        if (! inserted)
+            engine.writeLog (ECMAScriptLogSink::Level::warning, "Timer '" + String (CharPointer_UTF8 (label)) + "' already exists");
+
+        return 0;
+    }
+
+    /** Logs the time elapsed on a console timer, optionally stopping it and recording the duration. */
+    static duk_ret_t logConsoleTimer (duk_context* context, bool stop)
+    {
+        const auto* label = getLabelArgument (context);
+        auto& engine = getEngineFromDukContext (context);
+
+        const auto name = String (CharPointer_UTF8 (label));
+        const auto timer = engine.consoleTimers.find (name);
+
+        if (timer == engine.consoleTimers.end())
+        {
+            engine.writeLog (ECMAScriptLogSink::Level::warning, "Timer '" + name + "' does not exist");
+            return 0;
+        }
+
+        const auto elapsedTicks = Time::getHighResolutionTicks() - timer->second;
+        const auto elapsedMs = Time::highResolutionTicksToSeconds (elapsedTicks) * 1000.0;
+
+        if (stop)
+        {
+            engine.consoleTimers.erase (timer);
+            engine.timingStatistics[name].add (elapsedMs * 1000.0);
+        }
+
+        if (engine.logSink.isEnabled (ECMAScriptLogSink::Level::info))
+        {
+            auto message = name + ": " + formatMilliseconds (elapsedMs);
+
+            for (duk_idx_t i = 1; i < duk_get_top (context); ++i)
+                message << " " << String (CharPointer_UTF8 (duk_safe_to_string (context, i)));
+
+            engine.writeLog (ECMAScriptLogSink::Level::info, message);
+        }
+
+        return 0;
+    }
+
+    static duk_ret_t consoleTimeLog (duk_context* context)     { return logConsoleTimer (context, false); }
+    static duk_ret_t consoleTimeEnd (duk_context* context)     { return logConsoleTimer (context, true); }
+
+    static duk_ret_t consoleTimeStamp (duk_context* context)
+    {
+        const auto* label = getLabelArgument (context);
+        getEngineFromDukContext (context).performanceMarks[String (CharPointer_UTF8 (label))] = duk_time_get_monotonic_time ((duk_hthread*) context);
+        return 0;
+    }
+
+    static duk_ret_t consoleCount (duk_context* context)
+    {
+        const auto* label = getLabelArgument (context);
+        auto& engine = getEngineFromDukContext (context);
+
+        const auto name = String (CharPointer_UTF8 (label));
+        const auto count = ++engine.consoleCounters[name];
+
+        if (engine.logSink.isEnabled (ECMAScriptLogSink::Level::info))
+            engine.writeLog (ECMAScriptLogSink::Level::info, name + ": " + String (count));
+        return 0;
+    }
+
+    static duk_ret_t consoleCountReset (duk_context* context)
+    {
+        const auto* label = getLabelArgument (context);
+        auto& engine = getEngineFromDukContext (context);
+
+        const auto name = String (CharPointer_UTF8 (label));
+        const auto counter = engine.consoleCounters.find (name);
+
+        if (counter != engine.consoleCounters.end())
+            counter->second = 0;
+        else
+            engine.writeLog (ECMAScriptLogSink::Level::warning, "Count for '" + name + "' does not exist");
+
+        return 0;
+    }
+
+    /** performance.mark (name): remembers the current time on the performance.now() clock. */
+    static duk_ret_t performanceMark (duk_context* context)
+    {
+        const auto* name = duk_to_string (context, 0);
+        getEngineFromDukContext (context).performanceMarks[String (CharPointer_UTF8 (name))] = duk_time_get_monotonic_time ((duk_hthread*) context);
+        return 0;
+    }
+
+    /** performance.measure (name, startMark, endMark): records the time between two marks.
+
+        Without a start mark, the measure starts from the performance.now() origin.
+        Without an end mark, it ends now. The duration is returned in milliseconds.
+    */
+    static duk_ret_t performanceMeasure (duk_context* context)
+    {
+        const auto* name = duk_to_string (context, 0);
+        const auto* startMark = duk_is_undefined (context, 1) ? nullptr : duk_to_string (context, 1);
+        const auto* endMark = duk_is_undefined (context, 2) ? nullptr : duk_to_string (context, 2);
+
+        const char* missingMark = nullptr;
+        double duration = 0.0;
+
+        // Everything with a destructor lives in this scope, so that it's gone before duk_error() unwinds
+        {
+            auto& engine = getEngineFromDukContext (context);
+
+            const auto getMarkTime = [&] (const char* mark, double defaultTime)
+            {
+                if (mark == nullptr)
+                    return defaultTime;
+
+                const auto m = engine.performanceMarks.find (String (CharPointer_UTF8 (mark)));
+
+                if (m == engine.performanceMarks.cend())
+                {
+                    missingMark = mark;
+                    return defaultTime;
+                }
+
+                return m->second;
+            };
+
+            const auto start = getMarkTime (startMark, 0.0);
+            const auto end = getMarkTime (endMark, duk_time_get_monotonic_time ((duk_hthread*) context));
+
+            if (missingMark == nullptr)
+            {
+                duration = end - start;
+                engine.timingStatistics[String (CharPointer_UTF8 (name))].add (duration * 1000.0);
+            }
         }
 
-        pushVarToDukStack (dukContext, value, true);
-        duk_put_prop_string (rawContext, -2, name.toRawUTF8());
-        duk_pop (rawContext);
+        if (missingMark != nullptr)
+            return duk_error (context, DUK_ERR_SYNTAX_ERROR, "the mark '%s' does not exist", missingMark);
+
+        duk_push_number (context, duration);
+        return 1;
     }
 
-    //==============================================================================
-    var invoke (const String& name, const std::vector<var>& vargs)
+    static duk_ret_t performanceClearMarks (duk_context* context)
     {
-        auto* rawContext = dukContext.get();
+        const auto* name = duk_is_undefined (context, 0) ? nullptr : duk_to_string (context, 0);
+        auto& engine = getEngineFromDukContext (context);
 
-        try
-        {
-            safeEvalString (rawContext, name);
+        if (name == nullptr)
+            engine.performanceMarks.clear();
+        else
+            engine.performanceMarks.erase (String (CharPointer_UTF8 (name)));
 
-            if (! duk_is_function (rawContext, -1))
-                throw ECMAScriptError ("Invocation failed, target is not a function.");
+        return 0;
+    }
 
-            const auto nargs = static_cast<duk_idx_t> (vargs.size());
-            duk_require_stack_top (rawContext, nargs);
+    static void putNativeFunction (duk_context* rawContext, const char* name, duk_c_function function,
+                                   duk_idx_t numArgs, duk_int_t magic = 0)
+    {
+        duk_push_c_function (rawContext, function, numArgs);
+        duk_set_magic (rawContext, -1, magic);
+        duk_put_prop_string (rawContext, -2, name);
+    }
 
-            for (auto& p : vargs)
-                pushVarToDukStack (dukContext, p);
+    void registerConsoleFunctions (duk_context* rawContext)
+    {
+        using Level = ECMAScriptLogSink::Level;
 
-            safeCall (rawContext, nargs);
-        }
-        catch (const ECMAScriptError& error)
+        duk_push_global_object (rawContext);
+        putNativeFunction (rawContext, "print", consoleWrite, DUK_VARARGS, (duk_int_t) Level::info);
+        putNativeFunction (rawContext, "log", consoleWrite, DUK_VARARGS, (duk_int_t) Level::info);
+        duk_pop (rawContext);
+
+        duk_get_global_string (rawContext, "console");
+        putNativeFunction (rawContext, "log", consoleWrite, DUK_VARARGS, (duk_int_t) Level::info);
+        putNativeFunction (rawContext, "info", consoleWrite, DUK_VARARGS, (duk_int_t) Level::info);
+        putNativeFunction (rawContext, "debug", consoleWrite, DUK_VARARGS, (duk_int_t) Level::debug);
+        putNativeFunction (rawContext, "trace", consoleWrite, DUK_VARARGS, (duk_int_t) Level::debug);
+        putNativeFunction (rawContext, "warn", consoleWrite, DUK_VARARGS, (duk_int_t) Level::warning);
+        putNativeFunction (rawContext, "error", consoleWrite, DUK_VARARGS, (duk_int_t) Level::error);
+        putNativeFunction (rawContext, "time", consoleTime, 1);
+        putNativeFunction (rawContext, "timeLog", consoleTimeLog, DUK_VARARGS);
+        putNativeFunction (rawContext, "timeEnd", consoleTimeEnd, 1);
+        putNativeFunction (rawContext, "timeStamp", consoleTimeStamp, 1);
+        putNativeFunction (rawContext, "count", consoleCount, 1);
+        putNativeFunction (rawContext, "countReset", consoleCountReset, 1);
+        duk_pop (rawContext);
+
+        if (duk_get_global_string (rawContext, "performance") && duk_is_object (rawContext, -1))
         {
-            reset();
-            throw error;
+            putNativeFunction (rawContext, "mark", performanceMark, 1);
+            putNativeFunction (rawContext, "measure", performanceMeasure, 3);
+            putNativeFunction (rawContext, "clearMarks", performanceClearMarks, 1);
         }
 
-        auto result = readVarFromDukStack (dukContext, -1);
         duk_pop (rawContext);
-
-        return result;
     }
 
     struct TimeoutFunctionManager final : public MultiTimer
@@ -315,7 +1686,7 @@ public:
             {
                 if constexpr (IsSetter)
                 {
-                    if (_args.numArguments < 2 || ! _args.arguments[0].isMethod() || ! _args.arguments[1].isDouble())
+                    if (_args.numArguments < 2 || ! _args.arguments[0].isMethod() || ! isNumeric (_args.arguments[1]))
                         throw ECMAScriptError (String (name) + " requires a callback and time in milliseconds");
 
                     std::vector<var> args (_args.arguments + 2, _args.arguments + _args.numArguments);
@@ -323,7 +1694,7 @@ public:
                 }
                 else
                 {
-                    if (_args.numArguments < 1 || ! _args.arguments[0].isDouble())
+                    if (_args.numArguments < 1 || ! isNumeric (_args.arguments[0]))
                         throw ECMAScriptError (String (name) + " requires an integer ID of the timer to clear");
 
                     return (timeoutsManager.get()->*method) (_args.arguments[0]);
@@ -344,15 +1715,20 @@ public:
         // Clear out any timer callbacks
         timeoutsManager = std::make_unique<TimeoutFunctionManager>();
 
+        if (auto* oldContext = dukContext.get())
+            duk_set_gc_pause_handler (oldContext, nullptr, nullptr);
+
         // Allocate a new js heap
         dukContext = std::shared_ptr<duk_context> (
-            duk_create_heap (nullptr, nullptr, nullptr, nullptr, fatalErrorHandler),
+            duk_create_heap (nullptr, nullptr, nullptr, &pendingExternalString, fatalErrorHandler),
             duk_destroy_heap
         );
 
-        // Add console.log support
         auto* rawContext = dukContext.get();
-        duk_console_init (rawContext, DUK_CONSOLE_FLUSH);
+
+        // Keep sampling and the collection settings across resets
+        installProfiler (rawContext);
+        installGarbageCollector (rawContext);
 
         // Install a pointer back to this ECMAScriptEngine instance
         duk_push_global_stash (rawContext);
@@ -362,11 +1738,49 @@ public:
 
         persistentReleasePool.clear();
 
+        consoleTimers.clear();
+        consoleCounters.clear();
+        performanceMarks.clear();
+
+        // Set up the per-heap module cache and the top-level require()
+        duk_push_global_stash (rawContext);
+        duk_push_bare_object (rawContext);
+        duk_put_prop_string (rawContext, -2, DUK_HIDDEN_SYMBOL ("ModuleCache"));
+        duk_pop (rawContext);
+
+        // The property key cache pins its strings in the new heap, so it starts over empty
+        propertyKeysByName.clear();
+        propertyKeysByString.clear();
+
+        duk_push_global_stash (rawContext);
+        duk_push_bare_array (rawContext);
+        propertyKeyStore = duk_get_heapptr (rawContext, -1);
+        duk_put_prop_string (rawContext, -2, DUK_HIDDEN_SYMBOL ("PropertyKeys"));
+        duk_pop (rawContext);
+
+        duk_push_global_object (rawContext);
+        pushRequireFunction (rawContext, {});
+        duk_put_prop_string (rawContext, -2, "require");
+        duk_pop (rawContext);
+
         registerTimerGlobals();
 
-        registerNativeProperty ("console", new ConsoleObject());
-        registerNativeFunction ("print", javascriptLog);
-        registerNativeFunction ("log", javascriptLog);
+        auto* console = new ConsoleObject();
+
+        console->setMethod ("profile", [this] (const var::NativeFunctionArgs& args)
+        {
+            startConsoleProfile (args.numArguments > 0 ? args.arguments[0].toString() : String());
+            return var::undefined();
+        });
+
+        console->setMethod ("profileEnd", [this] (const var::NativeFunctionArgs&)
+        {
+            finishConsoleProfile();
+            return var::undefined();
+        });
+
+        registerNativeProperty ("console", console);
+        registerConsoleFunctions (rawContext);
     }
 
     //==============================================================================
@@ -409,13 +1823,239 @@ public:
             duk_debugger_cooperate (dc);
     }
 
+    //==============================================================================
+    /** Collects garbage from the message thread, between the events that run scripts. */
+    struct IdleCollector final : private Timer
+    {
+        IdleCollector (Pimpl& e, int intervalMs, GarbageCollectionMode m, int minimum) :
+            engine (e),
+            mode (m),
+            minimumAllocations (minimum)
+        {
+            startTimer (intervalMs);
+        }
+
+        ~IdleCollector() override
+        {
+            stopTimer();
+        }
+
+        void timerCallback() override
+        {
+            auto* rawContext = engine.dukContext.get();
+
+            // A nested message loop may run this from inside a native function: leave the heap alone
+            if (rawContext == nullptr || rawContext->callstack_curr != nullptr)
+                return;
+
+            if (engine.getNumAllocationsSinceCollection() >= minimumAllocations)
+                engine.collectGarbage (mode);
+        }
+
+        Pimpl& engine;
+        const GarbageCollectionMode mode;
+        const int minimumAllocations;
+    };
+
+    static void recordGarbageCollectionPause (void* data, duk_uint_t, duk_double_t durationMs)
+    {
+        auto& engine = *static_cast<Pimpl*> (data);
+        engine.garbageCollectionPauses.add (durationMs * 1000.0);
+
+       #if defined (DUK_USE_VOLUNTARY_GC)
+        if (auto* rawContext = engine.dukContext.get())
+            engine.triggerCounterAfterCollection = rawContext->heap->ms_trigger_counter;
+       #endif
+    }
+
+    void installGarbageCollector (duk_context* rawContext)
+    {
+        duk_set_gc_pause_handler (rawContext, recordGarbageCollectionPause, this);
+        duk_set_gc_trigger (rawContext, voluntaryCollectionEnabled ? triggerMultiplier : -1, triggerMinimum);
+
+       #if defined (DUK_USE_VOLUNTARY_GC)
+        triggerCounterAfterCollection = rawContext->heap->ms_trigger_counter;
+       #endif
+    }
+
+    void updateGarbageCollectionTrigger()
+    {
+        // Disabling voluntary collection rearms the counter, so keep the count of pending allocations
+        const auto numPending = getNumAllocationsSinceCollection();
+        auto* rawContext = dukContext.get();
+
+        duk_set_gc_trigger (rawContext, voluntaryCollectionEnabled ? triggerMultiplier : -1, triggerMinimum);
+
+       #if defined (DUK_USE_VOLUNTARY_GC)
+        triggerCounterAfterCollection = (int64) rawContext->heap->ms_trigger_counter + numPending;
+       #else
+        ignoreUnused (numPending);
+       #endif
+    }
+
+    /** @returns the number of allocations made since the last collection, as counted down by the voluntary GC trigger. */
+    int64 getNumAllocationsSinceCollection() const noexcept
+    {
+       #if defined (DUK_USE_VOLUNTARY_GC)
+        return triggerCounterAfterCollection - (int64) dukContext->heap->ms_trigger_counter;
+       #else
+        // Without the trigger counter there's no telling, so collect on every idle tick
+        return std::numeric_limits<int64>::max();
+       #endif
+    }
+
+    void collectGarbage (GarbageCollectionMode mode)
+    {
+        duk_gc (dukContext.get(), mode == GarbageCollectionMode::compacting ? DUK_GC_COMPACT : 0);
+    }
+
+    void setGarbageCollectionTrigger (int percentOfLiveHeap, int minimumAllocations)
+    {
+        // Duktape's multiplier is in 1/256ths of the objects and strings kept by the last collection
+        triggerMultiplier = (int) jmin ((int64) std::numeric_limits<int>::max(), (int64) jmax (0, percentOfLiveHeap) * 256 / 100);
+        triggerMinimum = jmax (0, minimumAllocations);
+        updateGarbageCollectionTrigger();
+    }
+
+    void setVoluntaryGarbageCollectionEnabled (bool shouldBeEnabled)
+    {
+        voluntaryCollectionEnabled = shouldBeEnabled;
+        updateGarbageCollectionTrigger();
+    }
+
+    void setIdleGarbageCollection (int intervalMs, GarbageCollectionMode mode, int minimumAllocations)
+    {
+        idleCollector.reset();
+
+        if (intervalMs > 0)
+            idleCollector = std::make_unique<IdleCollector> (*this, intervalMs, mode, jmax (0, minimumAllocations));
+    }
+
+    //==============================================================================
+    HeapStatistics getHeapStats() const
+    {
+        // Duktape's class names, in class number order
+        static constexpr const char* classNames[] =
+        {
+            "(internal)", "Object", "Array", "Function", "Arguments", "Boolean", "Date", "Error",
+            "JSON", "Math", "Number", "RegExp", "String", "global", "Symbol", "ObjEnv", "DecEnv",
+            "Pointer", "Thread", "ArrayBuffer", "DataView", "Int8Array", "Uint8Array", "Uint8ClampedArray",
+            "Int16Array", "Uint16Array", "Int32Array", "Uint32Array", "Float32Array", "Float64Array"
+        };
+
+        static_assert (std::size (classNames) == DUK_HOBJECT_CLASS_MAX + 1, "Duktape's classes have changed");
+
+        duk_heap_stats stats;
+        duk_get_heap_stats (dukContext.get(), &stats);
+
+        HeapStatistics result;
+
+        for (int i = 0; i <= DUK_HOBJECT_CLASS_MAX; ++i)
+        {
+            const HeapUsage usage { (int64) stats.object_count[i], (int64) stats.object_bytes[i] };
+
+            if (usage.count == 0)
+                continue;
+
+            result.objects.count += usage.count;
+            result.objects.bytes += usage.bytes;
+            result.objectsByClass[classNames[i]] = usage;
+        }
+
+        result.functions = { (int64) stats.object_count[DUK_HOBJECT_CLASS_FUNCTION], (int64) stats.object_bytes[DUK_HOBJECT_CLASS_FUNCTION] };
+        result.strings = { (int64) stats.string_count, (int64) stats.string_bytes };
+        result.buffers = { (int64) stats.buffer_count, (int64) stats.buffer_bytes };
+
+        result.stringTableSize = (int64) stats.strtab_size;
+
+        if (stats.strtab_size > 0)
+            result.stringTableLoadFactor = (double) stats.string_count / (double) stats.strtab_size;
+
+        if (const auto numLookups = stats.litcache_hit + stats.litcache_miss; numLookups > 0)
+            result.literalCacheHitRate = (double) stats.litcache_hit / (double) numLookups;
+
+        if (const auto numLookups = stats.propcache_hit + stats.propcache_miss; numLookups > 0)
+            result.propertyCacheHitRate = (double) stats.propcache_hit / (double) numLookups;
+
+        result.valueStackDepth = (int64) stats.valstack_used;
+        result.valueStackReserved = (int64) stats.valstack_reserved;
+        result.callStackDepth = (int64) stats.callstack_depth;
+        result.peakCallStackDepth = (int64) stats.callstack_peak;
+
+        result.numRefcountFrees = (int64) stats.refzero_free_count;
+        result.numMarkAndSweepFrees = (int64) stats.ms_free_count;
+        result.numGarbageCollections = (int64) stats.ms_count;
+        return result;
+    }
+
+    //==============================================================================
+    struct LambdaHelper;
+
+    struct BindingMetrics final
+    {
+        int64 numCalls = 0, totalTicks = 0, callbackTicks = 0;
+        DurationHistogram latency;
+    };
+
+    /** Times a native call, including the marshalling of its arguments and result.
+
+        All of this is skipped unless binding statistics are enabled, leaving
+        a single branch per call.
+    */
+    struct BindingTimer final
+    {
+        explicit BindingTimer (Pimpl& e) noexcept :
+            engine (e),
+            enabled (e.bindingStatisticsEnabled),
+            startTicks (enabled ? Time::getHighResolutionTicks() : 0)
+        {
+        }
+
+        void callbackStarted() noexcept     { if (enabled) callbackStartTicks = Time::getHighResolutionTicks(); }
+        void callbackFinished() noexcept    { if (enabled) callbackEndTicks = Time::getHighResolutionTicks(); }
+
+        void record (LambdaHelper& helper)
+        {
+            if (! enabled)
+                return;
+
+            const auto totalTicks = Time::getHighResolutionTicks() - startTicks;
+
+            if (helper.metrics == nullptr)
+                helper.metrics = &engine.bindingMetrics[helper.name.isNotEmpty() ? helper.name : String ("(anonymous)")];
+
+            auto& m = *helper.metrics;
+            ++m.numCalls;
+            m.totalTicks += totalTicks;
+            m.callbackTicks += callbackEndTicks - callbackStartTicks;
+            m.latency.add (Time::highResolutionTicksToSeconds (totalTicks) * 1.0e6);
+
+            ++engine.numScriptToNativeCalls;
+        }
+
+        Pimpl& engine;
+        const bool enabled;
+        const int64 startTicks;
+        int64 callbackStartTicks = 0, callbackEndTicks = 0;
+    };
+
+    void countScriptCall() noexcept
+    {
+        if (bindingStatisticsEnabled)
+            ++numNativeToScriptCalls;
+    }
+
     //==============================================================================
     struct LambdaHelper
     {
-        LambdaHelper (var::NativeFunction fn, uint32_t _id)
-            : callback (std::move (fn)), id (_id) {}
+        LambdaHelper (var::NativeFunction fn, uint32_t _id, const String& _name = {})
+            : callback (std::move (fn)), id (_id), name (_name) {}
 
-        static duk_ret_t invokeFromDukContext (duk_context* context)
+        LambdaHelper (ECMAScriptEngine::NativeStringFunction fn, uint32_t _id, const String& _name = {})
+            : stringCallback (std::move (fn)), id (_id), name (_name) {}
+
+        /** Retrieves the helper and engine pointers from the persistent function being called. */
+        static LambdaHelper* getCurrentHelper (duk_context* context, ECMAScriptEngine::Pimpl*& engine)
         {
             // First we have to retrieve the actual function pointer and our engine pointer
             // See: https://duktape.org/guide.html#hidden-symbol-properties
@@ -427,10 +2067,19 @@ public:
 
             // Then the engine...
             duk_get_prop_string (context, -1, DUK_HIDDEN_SYMBOL ("EnginePtr"));
-            auto* engine = static_cast<ECMAScriptEngine::Pimpl*> (duk_get_pointer (context, -1));
+            engine = static_cast<ECMAScriptEngine::Pimpl*> (duk_get_pointer (context, -1));
 
             // Pop back both the pointer and the "current function"
             duk_pop_2 (context);
+            return helper;
+        }
+
+        static duk_ret_t invokeFromDukContext (duk_context* context)
+        {
+            ECMAScriptEngine::Pimpl* engine = nullptr;
+            auto* helper = getCurrentHelper (context, engine);
+
+            BindingTimer timer (*engine);
 
             // Now we can collect our args
             std::vector<var> args;
@@ -444,24 +2093,69 @@ public:
             // Now we can invoke the user method with its arguments
             try
             {
+                timer.callbackStarted();
                 result = std::invoke (helper->callback, var::NativeFunctionArgs (
                     var(),
                     args.data(),
                     static_cast<int> (args.size())
                 ));
+                timer.callbackFinished();
             }
             catch (const ECMAScriptError& error)
             {
+                timer.callbackFinished();
+                timer.record (*helper);
+
                 duk_push_error_object (context, DUK_ERR_TYPE_ERROR, error.what());
                 return duk_throw (context);
             }
 
             // For an undefined result, return 0 to notify the duktape interpreter
             if (result.isUndefined())
+            {
+                timer.record (*helper);
                 return 0;
+            }
 
             // Otherwise, push the result to the stack and tell duktape
             engine->pushVarToDukStack (engine->dukContext, result);
+            timer.record (*helper);
+            return 1;
+        }
+
+        /** Calls a NativeStringFunction, whose arguments are read straight off the value stack. */
+        static duk_ret_t invokeStringMethodFromDukContext (duk_context* context)
+        {
+            ECMAScriptEngine::Pimpl* engine = nullptr;
+            auto* helper = getCurrentHelper (context, engine);
+
+            BindingTimer timer (*engine);
+            const ECMAScriptEngine::NativeStringArgs args (context, duk_get_top (context));
+            var result;
+
+            try
+            {
+                timer.callbackStarted();
+                result = std::invoke (helper->stringCallback, args);
+                timer.callbackFinished();
+            }
+            catch (const ECMAScriptError& error)
+            {
+                timer.callbackFinished();
+                timer.record (*helper);
+
+                duk_push_error_object (context, DUK_ERR_TYPE_ERROR, error.what());
+                return duk_throw (context);
+            }
+
+            if (result.isUndefined())
+            {
+                timer.record (*helper);
+                return 0;
+            }
+
+            engine->pushVarToDukStack (engine->dukContext, result);
+            timer.record (*helper);
             return 1;
         }
 
@@ -480,6 +2174,8 @@ public:
             auto& helper = engine->temporaryReleasePool[static_cast<size_t> (magic + 128)];
             duk_pop (context);
 
+            BindingTimer timer (*engine);
+
             // Now we can collect our args
             const int nargs = duk_get_top (context);
             std::vector<var> args;
@@ -489,14 +2185,20 @@ public:
                 args.push_back (engine->readVarFromDukStack (engine->dukContext, i));
 
             // Now we can invoke the user method with its arguments
+            timer.callbackStarted();
             const auto result = std::invoke (helper->callback, var::NativeFunctionArgs (var(), args.data(), static_cast<int> (args.size())));
+            timer.callbackFinished();
 
             // For an undefined result, return 0 to notify the duktape interpreter
             if (result.isUndefined())
+            {
+                timer.record (*helper);
                 return 0;
+            }
 
             // Otherwise, push the result to the stack and tell duktape
             engine->pushVarToDukStack (engine->dukContext, result);
+            timer.record (*helper);
             return 1;
         }
 
@@ -525,9 +2227,73 @@ public:
         }
 
         var::NativeFunction callback;
+        ECMAScriptEngine::NativeStringFunction stringCallback;
         uint32_t id;
+        String name;
+        BindingMetrics* metrics = nullptr;
     };
 
+    //==============================================================================
+    /** Returns the interned Duktape string for a property name, creating and pinning it on first use.
+
+        Identifiers are pooled, so the address of their text identifies them without hashing
+        or comparing it. Once the cache is full this returns nullptr, and the caller falls back
+        to passing the key's text.
+    */
+    void* getPropertyKey (duk_context* context, const Identifier& name)
+    {
+        const auto found = propertyKeysByName.find (name.getCharPointer().getAddress());
+
+        if (found != propertyKeysByName.end())
+            return found->second.heapPtr;
+
+        if (propertyKeysByName.size() >= maxNumPropertyKeys)
+            return nullptr;
+
+        const auto& text = name.toString();
+        duk_push_lstring (context, text.toRawUTF8(), text.getNumBytesAsUTF8());
+        auto* heapPtr = addPropertyKey (context, -1, name);
+        duk_pop (context);
+        return heapPtr;
+    }
+
+    /** Returns the Identifier for a string key on the stack, reusing the one cached for it if there is one. */
+    Identifier getPropertyName (duk_context* context, duk_idx_t idx)
+    {
+        duk_to_string (context, idx);
+        auto* heapPtr = duk_get_heapptr (context, idx);
+
+        const auto found = propertyKeysByString.find (heapPtr);
+
+        if (found != propertyKeysByString.end())
+            return found->second;
+
+        duk_size_t numBytes = 0;
+        const auto* text = duk_get_lstring (context, idx, &numBytes);
+        const Identifier name (String::fromUTF8 (text, (int) numBytes));
+
+        if (propertyKeysByName.size() < maxNumPropertyKeys)
+            addPropertyKey (context, idx, name);
+
+        return name;
+    }
+
+    /** Pins the string at the given index in the key store, so that its heap pointer stays valid. */
+    void* addPropertyKey (duk_context* context, duk_idx_t idx, const Identifier& name)
+    {
+        idx = duk_normalize_index (context, idx);
+        auto* heapPtr = duk_get_heapptr (context, idx);
+
+        duk_push_heapptr (context, propertyKeyStore);
+        duk_dup (context, idx);
+        duk_put_prop_index (context, -2, (duk_uarridx_t) propertyKeysByName.size());
+        duk_pop (context);
+
+        propertyKeysByName[name.getCharPointer().getAddress()] = { name, heapPtr };
+        propertyKeysByString[heapPtr] = name;
+        return heapPtr;
+    }
+
     //==============================================================================
     /** Helper for cleaning up native function temporaries. */
     void removeLambdaHelper (LambdaHelper* helper)
@@ -535,17 +2301,71 @@ public:
         persistentReleasePool.erase (helper->id);
     }
 
+    /** Pushes a function calling through to a LambdaHelper, which is kept until the function is finalised. */
+    void pushPersistentFunction (duk_context* rawContext, std::unique_ptr<LambdaHelper> helper, duk_c_function invoker)
+    {
+        // We provide a helper layer storing and retrieving the stash, and marshalling
+        // between the Duktape C interface and the native function interface
+        duk_push_c_function (rawContext, invoker, DUK_VARARGS);
+
+        // Now we assign the pointers as properties of the wrapper function
+        duk_push_pointer (rawContext, (void *) helper.get());
+        duk_put_prop_string (rawContext, -2, DUK_HIDDEN_SYMBOL ("LambdaHelperPtr"));
+        duk_push_pointer (rawContext, (void *) this);
+        duk_put_prop_string (rawContext, -2, DUK_HIDDEN_SYMBOL ("EnginePtr"));
+
+        // Now we prepare the finalizer
+        duk_push_c_function (rawContext, LambdaHelper::callbackFinalizer, 1);
+        duk_push_pointer (rawContext, (void *) helper.get());
+        duk_put_prop_string (rawContext, -2, DUK_HIDDEN_SYMBOL ("LambdaHelperPtr"));
+        duk_push_pointer (rawContext, (void *) this);
+        duk_put_prop_string (rawContext, -2, DUK_HIDDEN_SYMBOL ("EnginePtr"));
+        duk_set_finalizer (rawContext, -2);
+
+        // And hang on to it!
+        persistentReleasePool[helper->id] = std::move (helper);
+    }
+
     /** Helper for pushing a var to the duktape stack. */
-    void pushVarToDukStack (std::shared_ptr<duk_context> context, var v, bool persistNativeFunctions = false)
+    void pushVarToDukStack (std::shared_ptr<duk_context> context, var v, bool persistNativeFunctions = false,
+                            const String& bindingName = {})
+    {
+       #if SQUAREPINE_DUKTAPE_USE_JSON_FASTLANE
+        if ((v.isArray() || v.isObject()) && bulkTransferThreshold > 0)
+        {
+            const auto numValues = countBulkTransferValues (v);
+
+            if (numValues >= bulkTransferThreshold)
+            {
+                // Large data-only trees are sent as a single JSON document
+                // rather than with an API call for every property.
+                BulkTransferWriter writer (dukContext.get(), (size_t) numValues * 8);
+                writer.writeValue (v);
+                writer.finishAndDecode();
+                return;
+            }
+        }
+       #endif
+
+        pushVarToDukStackPerValue (context, v, persistNativeFunctions, bindingName);
+    }
+
+    /** Pushes a var to the duktape stack, recursing into arrays and objects one value at a time.
+
+        The binding name identifies native functions in the binding statistics; the methods
+        of objects are named after the object, e.g. "console.log".
+    */
+    void pushVarToDukStackPerValue (std::shared_ptr<duk_context> context, var v, bool persistNativeFunctions,
+                                    const String& bindingName = {})
     {
         auto* rawContext = dukContext.get();
 
         if (v.isVoid() || v.isUndefined())      { duk_push_undefined (rawContext); return; }
         else if (v.isBool())                    { duk_push_boolean (rawContext, (bool) v); return; }
         else if (v.isInt())                     { duk_push_int (rawContext, (int) v); return; }
-        else if (v.isInt64())                   { duk_push_number (rawContext, (double) v); return; } // Because duktape sucks...
+        else if (v.isInt64())                   { pushInt64 (rawContext, (int64) v); return; }
         else if (v.isDouble())                  { duk_push_number (rawContext, (double) v); return; }
-        else if (v.isString())                  { duk_push_string (rawContext, v.toString().toRawUTF8()); return; }
+        else if (v.isString())                  { pushString (rawContext, v.toString()); return; }
         else if (v.isArray())
         {
             auto arr_idx = duk_push_array (rawContext);
@@ -553,7 +2373,7 @@ public:
 
             for (auto& e : *v.getArray())
             {
-                pushVarToDukStack (context, e, persistNativeFunctions);
+                pushVarToDukStackPerValue (context, e, persistNativeFunctions);
                 duk_put_prop_index (rawContext, arr_idx, i++);
             }
 
@@ -567,8 +2387,18 @@ public:
 
                 for (auto& e : o->getProperties())
                 {
-                    pushVarToDukStack (context, e.value, persistNativeFunctions);
-                    duk_put_prop_string (rawContext, obj_idx, e.name.toString().toRawUTF8());
+                    const auto propertyName = bindingName.isNotEmpty() ? bindingName + "." + e.name.toString() : String();
+                    pushVarToDukStackPerValue (context, e.value, persistNativeFunctions, propertyName);
+
+                    if (auto* key = getPropertyKey (rawContext, e.name))
+                    {
+                        duk_put_prop_heapptr (rawContext, obj_idx, key);
+                    }
+                    else
+                    {
+                        const auto& text = e.name.toString();
+                        duk_put_prop_lstring (rawContext, obj_idx, text.toRawUTF8(), text.getNumBytesAsUTF8());
+                    }
                 }
             }
 
@@ -578,27 +2408,9 @@ public:
         {
             if (persistNativeFunctions)
             {
-                // For persisted native functions, we provide a helper layer storing and retrieving the
-                // stash, and marshalling between the Duktape C interface and the NativeFunction interface
-                duk_push_c_function (rawContext, LambdaHelper::invokeFromDukContext, DUK_VARARGS);
-
-                // Now we assign the pointers as properties of the wrapper function
-                auto helper = std::make_unique<LambdaHelper> (v.getNativeFunction(), nextHelperId++);
-                duk_push_pointer (rawContext, (void *) helper.get());
-                duk_put_prop_string (rawContext, -2, DUK_HIDDEN_SYMBOL ("LambdaHelperPtr"));
-                duk_push_pointer (rawContext, (void *) this);
-                duk_put_prop_string (rawContext, -2, DUK_HIDDEN_SYMBOL ("EnginePtr"));
-
-                // Now we prepare the finalizer
-                duk_push_c_function (rawContext, LambdaHelper::callbackFinalizer, 1);
-                duk_push_pointer (rawContext, (void *) helper.get());
-                duk_put_prop_string (rawContext, -2, DUK_HIDDEN_SYMBOL ("LambdaHelperPtr"));
-                duk_push_pointer (rawContext, (void *) this);
-                duk_put_prop_string (rawContext, -2, DUK_HIDDEN_SYMBOL ("EnginePtr"));
-                duk_set_finalizer (rawContext, -2);
-
-                // And hang on to it! 
-                persistentReleasePool[helper->id] = std::move (helper);
+                pushPersistentFunction (rawContext,
+                                        std::make_unique<LambdaHelper> (v.getNativeFunction(), nextHelperId++, bindingName),
+                                        LambdaHelper::invokeFromDukContext);
             }
             else
             {
@@ -609,7 +2421,7 @@ public:
                 // to wrap around and clobber previous temporaries, effectively garbage collecting on
                 // demand. The maximum number of temporary values before wrapping is 255, as dictated
                 // by that we use the lightfunc's magic number to identify our native callback.
-                auto helper = std::make_unique<LambdaHelper> (v.getNativeFunction(), nextHelperId++);
+                auto helper = std::make_unique<LambdaHelper> (v.getNativeFunction(), nextHelperId++, bindingName);
                 auto magic = nextMagicInt++;
 
                 duk_push_c_lightfunc (rawContext, LambdaHelper::invokeFromDukContextLightFunc, DUK_VARARGS, 15, magic);
@@ -628,6 +2440,49 @@ public:
 
     /** Helper for reading from the duktape stack to a var instance. */
     var readVarFromDukStack (std::shared_ptr<duk_context> context, duk_idx_t idx)
+    {
+       #if SQUAREPINE_DUKTAPE_USE_JSON_FASTLANE
+        auto* rawContext = dukContext.get();
+
+        if (bulkTransferThreshold > 0 && duk_get_type (rawContext, idx) == DUK_TYPE_OBJECT)
+        {
+            auto* thread = reinterpret_cast<duk_hthread*> (rawContext);
+            auto* object = static_cast<duk_hobject*> (duk_get_heapptr (rawContext, idx));
+
+            // The prototypes are checked first, so that a graph they rule out isn't walked twice.
+            if (! prototypesHaveToJSON (thread)
+                && countBulkTransferValues (thread, object) >= bulkTransferThreshold)
+            {
+                duk_dup (rawContext, idx);
+
+                // Encoding can still fail, e.g. when out of memory, so it mustn't throw
+                // past the caller: the graph is then read one value at a time instead.
+                const auto encoded = duk_safe_call (rawContext, [] (duk_context* c, void*) -> duk_ret_t
+                {
+                    duk_json_encode (c, -1);
+                    return 1;
+                }, nullptr, 1, 1) == DUK_EXEC_SUCCESS;
+
+                if (encoded)
+                {
+                    duk_size_t numBytes = 0;
+                    const auto* text = duk_get_lstring (rawContext, -1, &numBytes);
+                    auto result = JSON::parse (String::fromUTF8 (text, static_cast<int> (numBytes)));
+
+                    duk_pop (rawContext);
+                    return result;
+                }
+
+                duk_pop (rawContext);
+            }
+        }
+       #endif
+
+        return readVarFromDukStackPerValue (context, idx);
+    }
+
+    /** Reads a var from the duktape stack, recursing into arrays and objects one value at a time. */
+    var readVarFromDukStackPerValue (std::shared_ptr<duk_context> context, duk_idx_t idx)
     {
         auto* rawContext = dukContext.get();
         var value;
@@ -641,8 +2496,15 @@ public:
 
             case DUK_TYPE_UNDEFINED:    value = var::undefined(); break;
             case DUK_TYPE_BOOLEAN:      value = (bool) duk_get_boolean (rawContext, idx);  break;
-            case DUK_TYPE_NUMBER:       value = duk_get_number (rawContext, idx); break;
-            case DUK_TYPE_STRING:       value = String (CharPointer_UTF8 (duk_get_string (rawContext, idx))); break;
+            case DUK_TYPE_NUMBER:       value = numberToVar (duk_get_number (rawContext, idx)); break;
+            case DUK_TYPE_STRING:
+            {
+                duk_size_t numBytes = 0;
+                const auto* text = duk_get_lstring (rawContext, idx, &numBytes);
+                value = String::fromUTF8 (text, (int) numBytes);
+            }
+            break;
+
 
             case DUK_TYPE_OBJECT:
             case DUK_TYPE_LIGHTFUNC:
@@ -655,7 +2517,7 @@ public:
                     for (duk_size_t i = 0; i < len; ++i)
                     {
                         duk_get_prop_index (rawContext, idx, static_cast<duk_uarridx_t> (i));
-                        els.add (readVarFromDukStack (context, -1));
+                        els.add (readVarFromDukStackPerValue (context, -1));
                         duk_pop (rawContext);
                     }
 
@@ -720,6 +2582,7 @@ public:
                             // Invocation
                             try
                             {
+                                countScriptCall();
                                 safeCall (rawPtr, args.numArguments);
                             }
                             catch (const ECMAScriptError& error)
@@ -757,7 +2620,7 @@ public:
                     // conversion from number to string. Thus here, while constructing
                     // the DynamicObject, we take the `toString()` value for the key
                     // always.
-                    obj->setProperty (duk_to_string (rawContext, -2), readVarFromDukStack (context, -1));
+                    obj->setProperty (getPropertyName (rawContext, -2), readVarFromDukStackPerValue (context, -1));
 
                     // Clear the key/value pair from the stack
                     duk_pop_2 (rawContext);
@@ -780,6 +2643,55 @@ public:
     }
 
     //==============================================================================
+   #if SQUAREPINE_DUKTAPE_USE_JSON_FASTLANE
+    int bulkTransferThreshold = 256;
+   #else
+    int bulkTransferThreshold = 0;
+   #endif
+
+    // The heap's user data, read by the external string intern check
+    ExternalString pendingExternalString;
+
+    // Property names marshalled to and from DynamicObjects, pinned in the "PropertyKeys" stash array
+    struct PropertyKey final
+    {
+        Identifier name;
+        void* heapPtr = nullptr;
+    };
+
+    static constexpr size_t maxNumPropertyKeys = 4096;
+    std::unordered_map<const char*, PropertyKey> propertyKeysByName;
+    std::unordered_map<void*, Identifier> propertyKeysByString;
+    void* propertyKeyStore = nullptr;
+
+    std::vector<std::unique_ptr<ECMAScriptModuleResolver>> moduleResolvers;
+    std::map<String, MemoryBlock> compiledModules;
+
+    std::unique_ptr<ProfileRecorder> profiler;
+    std::function<void (const String&, const ECMAScriptProfile&)> consoleProfileCallback;
+    File consoleProfileDirectory;
+
+    ECMAScriptLogSink logSink;
+    std::string logRecord;
+
+    // Native binding statistics: entries are never erased, so LambdaHelpers can point into the map
+    bool bindingStatisticsEnabled = false;
+    std::map<String, BindingMetrics> bindingMetrics;
+    int64 numScriptToNativeCalls = 0, numNativeToScriptCalls = 0;
+
+    // Native tables behind console.time(), console.count() and performance.mark()
+    std::map<String, int64> consoleTimers;
+    std::map<String, int> consoleCounters;
+    std::map<String, double> performanceMarks;
+    std::map<String, DurationHistogram> timingStatistics;
+
+    // Garbage collection settings, reapplied to each new heap
+    bool voluntaryCollectionEnabled = true;
+    int triggerMultiplier = (int) DUK_HEAP_MARK_AND_SWEEP_TRIGGER_MULT, triggerMinimum = (int) DUK_HEAP_MARK_AND_SWEEP_TRIGGER_ADD;
+    int64 triggerCounterAfterCollection = 0;
+    DurationHistogram garbageCollectionPauses;
+    std::unique_ptr<IdleCollector> idleCollector;
+
     uint32_t nextHelperId = 0;
     int32_t nextMagicInt = 0;
     std::unordered_map<uint32_t, std::unique_ptr<LambdaHelper>> persistentReleasePool;
@@ -0,0 +1,175 @@
+ECMAScriptLogSink::ECMAScriptLogSink (int bufferSizeBytes) :
+    Thread ("ECMAScript log writer"),
+    fifo (jmax (1024, bufferSizeBytes)),
+    maxRecordSize (fifo.getTotalSize() / 4),
+    output ([] (Level, const String& text) { Logger::writeToLog (text); })
+{
+    buffer.malloc ((size_t) fifo.getTotalSize());
+    startThread();
+}
+
+ECMAScriptLogSink::~ECMAScriptLogSink()
+{
+    signalThreadShouldExit();
+    notify();
+    stopThread (5000);
+}
+
+void ECMAScriptLogSink::setOutput (Output newOutput)
+{
+    const ScopedLock sl (outputLock);
+    output = std::move (newOutput);
+}
+
+//==============================================================================
+/** @returns the length to cut text down to so that it fits, without splitting a multi-byte character. */
+static size_t getTruncatedLength (const char* utf8, size_t numBytes, size_t maxBytes) noexcept
+{
+    if (numBytes <= maxBytes)
+        return numBytes;
+
+    // Back up while the first byte cut off continues a character; a sequence is at most 4 bytes.
+    auto length = maxBytes;
+
+    for (int i = 0; i < 3 && length > 0 && (((uint8) utf8[length]) & 0xc0) == 0x80; ++i)
+        --length;
+
+    // Nor keep the high half of a CESU-8 surrogate pair without its low half.
+    if (length >= 3 && (uint8) utf8[length - 3] == 0xed && (((uint8) utf8[length - 2]) & 0xf0) == 0xa0)
+        length -= 3;
+
+    return length;
+}
+
+bool ECMAScriptLogSink::write (Level level, const char* utf8, size_t numBytes) noexcept
+{
+    if (! isEnabled (level))
+        return false;
+
+    const auto limit = rateLimit.load();
+
+    if (limit > 0)
+    {
+        const auto now = Time::getMillisecondCounter();
+
+        if (now - rateWindowStart >= 1000)
+        {
+            rateWindowStart = now;
+            numInRateWindow = 0;
+        }
+
+        if (++numInRateWindow > limit)
+        {
+            ++numDropped;
+            return false;
+        }
+    }
+
+    const auto length = (int) getTruncatedLength (utf8, numBytes, (size_t) (maxRecordSize - headerSize));
+    const auto recordSize = headerSize + length;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (recordSize, start1, size1, start2, size2);
+
+    if (size1 + size2 < recordSize)
+    {
+        ++numDropped;
+        return false;
+    }
+
+    // The writer thread sleeps once it has emptied the buffer, so only wake it for the first record.
+    const auto wasEmpty = fifo.getNumReady() == 0;
+
+    // The level goes in the low bits of the header, and the length above it
+    const auto header = ((uint32) length << 2) | (uint32) level;
+    copyToBuffer (start1, &header, headerSize);
+    copyToBuffer ((start1 + headerSize) % fifo.getTotalSize(), utf8, length);
+
+    // Publishing the whole record at once means the writer never sees a partial one
+    fifo.finishedWrite (recordSize);
+
+    if (wasEmpty)
+        notify();
+
+    return true;
+}
+
+void ECMAScriptLogSink::flush()
+{
+    while (fifo.getNumReady() > 0 || writing.load())
+    {
+        notify();
+        drained.wait (10);
+    }
+}
+
+//==============================================================================
+void ECMAScriptLogSink::copyToBuffer (int position, const void* data, int numBytes) noexcept
+{
+    const auto firstPart = jmin (numBytes, fifo.getTotalSize() - position);
+
+    std::memcpy (buffer + position, data, (size_t) firstPart);
+    std::memcpy (buffer.get(), static_cast<const char*> (data) + firstPart, (size_t) (numBytes - firstPart));
+}
+
+void ECMAScriptLogSink::readFromFifo (void* data, int numBytes) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (numBytes, start1, size1, start2, size2);
+    jassert (size1 + size2 == numBytes);
+
+    std::memcpy (data, buffer + start1, (size_t) size1);
+    std::memcpy (static_cast<char*> (data) + size1, buffer + start2, (size_t) size2);
+    fifo.finishedRead (size1 + size2);
+}
+
+void ECMAScriptLogSink::drain()
+{
+    writing = true;
+
+    while (fifo.getNumReady() >= headerSize)
+    {
+        uint32 header = 0;
+        readFromFifo (&header, headerSize);
+
+        const auto level = (Level) (header & 3);
+        const auto length = (int) (header >> 2);
+
+        readBuffer.ensureSize ((size_t) length + 1);
+        readFromFifo (readBuffer.getData(), length);
+
+        const auto text = String::fromUTF8 (static_cast<const char*> (readBuffer.getData()), length);
+
+        const ScopedLock sl (outputLock);
+
+        if (output != nullptr)
+            output (level, text);
+    }
+
+    const auto dropped = numDropped.load();
+
+    if (dropped != numDroppedReported)
+    {
+        const auto text = String (dropped - numDroppedReported) + " log messages were dropped";
+        numDroppedReported = dropped;
+
+        const ScopedLock sl (outputLock);
+
+        if (output != nullptr)
+            output (Level::warning, text);
+    }
+
+    writing = false;
+    drained.signal();
+}
+
+void ECMAScriptLogSink::run()
+{
+    while (! threadShouldExit())
+    {
+        drain();
+        wait (50);
+    }
+
+    drain();
+}
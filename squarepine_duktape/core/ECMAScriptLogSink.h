@@ -0,0 +1,98 @@
+/** Collects the output of `console.log()` and friends without blocking scripts.
+
+    Scripts write preformatted records into a lock-free ring buffer, which a
+    background thread drains into the output callback. Records below the minimum
+    level are rejected before they're formatted, and an optional rate limit caps
+    the number of records accepted per second. Records that don't fit into the
+    buffer, or that exceed the rate limit, are dropped and counted; the writer
+    thread reports how many were lost.
+
+    Records must only be written from one thread at a time, which for an engine
+    is the thread running its scripts.
+
+    @see ECMAScriptEngine::getLogSink
+*/
+class ECMAScriptLogSink final : private Thread
+{
+public:
+    //==============================================================================
+    /** The severity of a record. */
+    enum class Level
+    {
+        debug = 0,  /**< console.debug() and console.trace() */
+        info,       /**< console.log(), console.info() and print() */
+        warning,    /**< console.warn() */
+        error       /**< console.error() */
+    };
+
+    /** A callback for the records drained from the buffer, called on the writer thread. */
+    using Output = std::function<void (Level, const String&)>;
+
+    //==============================================================================
+    /** Constructor.
+
+        @param bufferSizeBytes  The size of the ring buffer. Records longer than a quarter
+                                of this are truncated.
+    */
+    explicit ECMAScriptLogSink (int bufferSizeBytes = 1 << 16);
+
+    /** Destructor, which writes out any remaining records before stopping the writer thread. */
+    ~ECMAScriptLogSink() override;
+
+    //==============================================================================
+    /** Sets the lowest level that is written. The default is Level::debug. */
+    void setMinimumLevel (Level level) noexcept                 { minimumLevel.store ((int) level); }
+
+    /** @returns true if records of this level are written. */
+    bool isEnabled (Level level) const noexcept                 { return (int) level >= minimumLevel.load(); }
+
+    /** Sets the maximum number of records accepted per second, or 0 for no limit (the default). */
+    void setRateLimit (int maxRecordsPerSecond) noexcept        { rateLimit.store (jmax (0, maxRecordsPerSecond)); }
+
+    /** Sets where records go. By default they're written to the current Logger. */
+    void setOutput (Output newOutput);
+
+    //==============================================================================
+    /** Adds a record to the buffer.
+
+        @returns false if the record was filtered out or dropped.
+    */
+    bool write (Level level, const char* utf8, size_t numBytes) noexcept;
+
+    /** Blocks until every record written so far has been passed to the output. */
+    void flush();
+
+    /** @returns the number of records dropped because the buffer was full or the rate limit was hit. */
+    int64 getNumDropped() const noexcept                        { return numDropped.load(); }
+
+private:
+    //==============================================================================
+    static constexpr int headerSize = (int) sizeof (uint32);
+
+    AbstractFifo fifo;
+    HeapBlock<char> buffer;
+    const int maxRecordSize;
+
+    std::atomic<int> minimumLevel { (int) Level::debug }, rateLimit { 0 };
+    std::atomic<int64> numDropped { 0 };
+    std::atomic<bool> writing { false };
+
+    // Only touched by the thread writing records
+    uint32 rateWindowStart = 0;
+    int numInRateWindow = 0;
+
+    // Only touched by the writer thread
+    int64 numDroppedReported = 0;
+    MemoryBlock readBuffer;
+
+    CriticalSection outputLock;
+    Output output;
+    WaitableEvent drained;
+
+    void copyToBuffer (int position, const void* data, int numBytes) noexcept;
+    void readFromFifo (void* data, int numBytes) noexcept;
+    void drain();
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ECMAScriptLogSink)
+};
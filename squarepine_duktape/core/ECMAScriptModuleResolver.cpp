@@ -0,0 +1,167 @@
+String ECMAScriptModuleResolver::resolvePath (const String& id, const String& parentId)
+{
+    StringArray parts;
+
+    // Relative identifiers start from the parent module's directory
+    if (id.startsWith ("./") || id.startsWith ("../"))
+    {
+        parts.addTokens (getDirectory (parentId), "/", "");
+        parts.removeEmptyStrings();
+    }
+
+    StringArray idParts;
+    idParts.addTokens (id, "/", "");
+    idParts.removeEmptyStrings();
+
+    for (const auto& part : idParts)
+    {
+        if (part == ".")
+            continue;
+
+        if (part == "..")
+        {
+            if (parts.isEmpty())
+                return {};
+
+            parts.remove (parts.size() - 1);
+            continue;
+        }
+
+        parts.add (part);
+    }
+
+    if (parts.isEmpty())
+        return {};
+
+    auto path = parts.joinIntoString ("/");
+
+    if (! parts[parts.size() - 1].containsChar ('.'))
+        path += ".js";
+
+    return path;
+}
+
+String ECMAScriptModuleResolver::getDirectory (const String& canonicalId)
+{
+    if (! canonicalId.containsChar ('/'))
+        return {};
+
+    return canonicalId.upToLastOccurrenceOf ("/", false, false);
+}
+
+//==============================================================================
+FileModuleResolver::FileModuleResolver (const File& rootDirectory) :
+    root (rootDirectory)
+{
+    jassert (root.isDirectory());
+}
+
+String FileModuleResolver::resolve (const String& id, const String& parentId)
+{
+    const auto path = resolvePath (id, parentId);
+
+    if (path.isNotEmpty() && root.getChildFile (path).existsAsFile())
+        return path;
+
+    return {};
+}
+
+std::unique_ptr<InputStream> FileModuleResolver::createInputStream (const String& canonicalId)
+{
+    return root.getChildFile (canonicalId).createInputStream();
+}
+
+//==============================================================================
+void MemoryModuleResolver::addModule (const String& path, const void* sourceData, size_t numBytes)
+{
+    jassert (sourceData != nullptr || numBytes == 0);
+
+    const auto canonicalId = resolvePath (path, {});
+    jassert (canonicalId.isNotEmpty());
+
+    modules[canonicalId] = { sourceData, numBytes, nullptr };
+}
+
+void MemoryModuleResolver::addModule (const String& path, const String& source)
+{
+    auto storage = std::make_shared<MemoryBlock> (source.toRawUTF8(), source.getNumBytesAsUTF8());
+
+    const auto canonicalId = resolvePath (path, {});
+    jassert (canonicalId.isNotEmpty());
+
+    modules[canonicalId] = { storage->getData(), storage->getSize(), storage };
+}
+
+String MemoryModuleResolver::resolve (const String& id, const String& parentId)
+{
+    const auto path = resolvePath (id, parentId);
+
+    if (modules.find (path) != modules.cend())
+        return path;
+
+    return {};
+}
+
+std::unique_ptr<InputStream> MemoryModuleResolver::createInputStream (const String& canonicalId)
+{
+    const auto m = modules.find (canonicalId);
+
+    if (m == modules.cend())
+        return {};
+
+    return std::make_unique<MemoryInputStream> (m->second.data, m->second.size, false);
+}
+
+//==============================================================================
+BinaryDataModuleResolver::BinaryDataModuleResolver (NamedResourceGetter getter) :
+    getNamedResource (getter)
+{
+    jassert (getNamedResource != nullptr);
+}
+
+String BinaryDataModuleResolver::getResourceName (const String& path)
+{
+    const auto fileName = path.fromLastOccurrenceOf ("/", false, false);
+
+    String name;
+
+    for (auto p = fileName.getCharPointer(); ! p.isEmpty();)
+    {
+        const auto c = p.getAndAdvance();
+
+        if (CharacterFunctions::isLetterOrDigit (c) || c == '_')
+            name << String::charToString (c);
+        else if (c == '.' || c == ' ')
+            name << "_";
+    }
+
+    if (name.isEmpty() || CharacterFunctions::isDigit (name[0]))
+        name = "_" + name;
+
+    return name;
+}
+
+String BinaryDataModuleResolver::resolve (const String& id, const String& parentId)
+{
+    const auto path = resolvePath (id, parentId);
+
+    if (path.isEmpty())
+        return {};
+
+    int numBytes = 0;
+
+    if (getNamedResource (getResourceName (path).toRawUTF8(), numBytes) != nullptr)
+        return path;
+
+    return {};
+}
+
+std::unique_ptr<InputStream> BinaryDataModuleResolver::createInputStream (const String& canonicalId)
+{
+    int numBytes = 0;
+
+    if (auto* data = getNamedResource (getResourceName (canonicalId).toRawUTF8(), numBytes))
+        return std::make_unique<MemoryInputStream> (data, (size_t) numBytes, false);
+
+    return {};
+}
@@ -0,0 +1,151 @@
+/** Locates and opens the source code of modules loaded with `require()`.
+
+    An ECMAScriptEngine asks each of its resolvers in turn, in the order they were
+    added, to resolve the identifier passed to `require()`. The first resolver to
+    return a canonical ID is then asked for the module's source. Modules are only
+    resolved and compiled the first time they are required.
+
+    Canonical IDs are '/' separated paths, and must be unique across all of the
+    resolvers added to an engine since the engine's module caches are keyed by them.
+
+    @see ECMAScriptEngine::addModuleResolver
+*/
+class ECMAScriptModuleResolver
+{
+public:
+    /** Destructor. */
+    virtual ~ECMAScriptModuleResolver() = default;
+
+    //==============================================================================
+    /** Resolves a module identifier to a canonical ID.
+
+        @param id       The identifier as passed to `require()`.
+        @param parentId The canonical ID of the module calling `require()`,
+                        or an empty string for calls from outside of any module.
+
+        @returns the canonical ID of the module, or an empty string if this
+                 resolver can't provide it.
+    */
+    virtual String resolve (const String& id, const String& parentId) = 0;
+
+    /** Opens the UTF-8 source of a module that this resolver has resolved.
+
+        @returns a stream positioned at the start of the source, or nullptr on failure.
+    */
+    virtual std::unique_ptr<InputStream> createInputStream (const String& canonicalId) = 0;
+
+    //==============================================================================
+    /** Resolves an identifier into a normalised, '/' separated module path.
+
+        Identifiers starting with "./" or "../" are relative to the directory of the
+        parent module; anything else is relative to the root. A ".js" extension is
+        appended if the final path component doesn't have one.
+
+        @returns the path, or an empty string if it would escape the root.
+    */
+    static String resolvePath (const String& id, const String& parentId);
+
+    /** @returns the directory part of a module path, or an empty string for modules at the root. */
+    static String getDirectory (const String& canonicalId);
+};
+
+//==============================================================================
+/** Resolves modules to script files inside a root directory. */
+class FileModuleResolver final : public ECMAScriptModuleResolver
+{
+public:
+    /** Constructor.
+
+        @param rootDirectory The directory that top-level module identifiers are relative to.
+    */
+    explicit FileModuleResolver (const File& rootDirectory);
+
+    /** @internal */
+    String resolve (const String&, const String&) override;
+    /** @internal */
+    std::unique_ptr<InputStream> createInputStream (const String&) override;
+
+private:
+    const File root;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FileModuleResolver)
+};
+
+//==============================================================================
+/** Resolves modules to sources held in memory.
+
+    Sources may either be copied into the resolver or referenced in place,
+    which suits read-only data that outlives the engine, such as BinaryData.
+
+    @code
+        auto resolver = std::make_unique<MemoryModuleResolver>();
+        resolver->addModule ("lib/util.js", BinaryData::util_js, BinaryData::util_jsSize);
+        resolver->addModule ("config.js", "module.exports = { verbose: true };");
+        engine.addModuleResolver (std::move (resolver));
+    @endcode
+*/
+class MemoryModuleResolver final : public ECMAScriptModuleResolver
+{
+public:
+    /** Constructor. */
+    MemoryModuleResolver() = default;
+
+    /** Adds a module by referencing its source, which must stay valid for
+        as long as this resolver exists.
+    */
+    void addModule (const String& path, const void* sourceData, size_t numBytes);
+
+    /** Adds a module, copying its source into the resolver. */
+    void addModule (const String& path, const String& source);
+
+    /** @internal */
+    String resolve (const String&, const String&) override;
+    /** @internal */
+    std::unique_ptr<InputStream> createInputStream (const String&) override;
+
+private:
+    struct Module final
+    {
+        const void* data = nullptr;
+        size_t size = 0;
+        std::shared_ptr<MemoryBlock> storage;
+    };
+
+    std::map<String, Module> modules;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MemoryModuleResolver)
+};
+
+//==============================================================================
+/** Resolves modules to resources embedded by a project's BinaryData.
+
+    Module paths are mapped to resource names the way the Projucer and CMake
+    binary data builders name them from file names, ignoring directories:
+    "lib/util.js" is looked up as "util_js".
+
+    @code
+        engine.addModuleResolver (std::make_unique<BinaryDataModuleResolver> (BinaryData::getNamedResource));
+    @endcode
+*/
+class BinaryDataModuleResolver final : public ECMAScriptModuleResolver
+{
+public:
+    /** The signature of the generated BinaryData::getNamedResource function. */
+    using NamedResourceGetter = const char* (*) (const char* resourceNameUTF8, int& dataSizeInBytes);
+
+    /** Constructor. */
+    explicit BinaryDataModuleResolver (NamedResourceGetter getNamedResource);
+
+    /** @returns the BinaryData resource name used for a module path. */
+    static String getResourceName (const String& path);
+
+    /** @internal */
+    String resolve (const String&, const String&) override;
+    /** @internal */
+    std::unique_ptr<InputStream> createInputStream (const String&) override;
+
+private:
+    const NamedResourceGetter getNamedResource;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BinaryDataModuleResolver)
+};
@@ -0,0 +1,148 @@
+void ECMAScriptProfile::start (int64 timeMicroseconds)
+{
+    startTime = endTime = lastSampleTime = timeMicroseconds;
+}
+
+int ECMAScriptProfile::addFrame (Frame frame)
+{
+    frames.push_back (std::move (frame));
+    return (int) frames.size() - 1;
+}
+
+void ECMAScriptProfile::addSample (const int* frameIndices, int numFrames, int64 timeMicroseconds)
+{
+    int nodeIndex = 0;
+
+    // Walk down from the root, starting with the outermost call
+    for (int i = numFrames; --i >= 0;)
+    {
+        const auto frameIndex = frameIndices[i];
+        int childIndex = -1;
+
+        for (auto c : nodes[(size_t) nodeIndex].children)
+        {
+            if (nodes[(size_t) c].frameIndex == frameIndex)
+            {
+                childIndex = c;
+                break;
+            }
+        }
+
+        if (childIndex < 0)
+        {
+            Node child;
+            child.frameIndex = frameIndex;
+            child.parentIndex = nodeIndex;
+
+            childIndex = (int) nodes.size();
+            nodes.push_back (std::move (child));
+            nodes[(size_t) nodeIndex].children.push_back (childIndex);
+        }
+
+        nodeIndex = childIndex;
+    }
+
+    ++nodes[(size_t) nodeIndex].hitCount;
+
+    samples.push_back (nodeIndex);
+    timeDeltas.push_back (timeMicroseconds - lastSampleTime);
+    lastSampleTime = endTime = timeMicroseconds;
+}
+
+void ECMAScriptProfile::finish (int64 timeMicroseconds)
+{
+    endTime = jmax (lastSampleTime, timeMicroseconds);
+}
+
+//==============================================================================
+String ECMAScriptProfile::getFrameLabel (int frameIndex) const
+{
+    const auto& frame = frames[(size_t) frameIndex];
+
+    auto label = frame.functionName;
+
+    if (frame.fileName.isNotEmpty())
+        label << " (" << frame.fileName << ":" << frame.lineNumber << ")";
+
+    // Semicolons separate the frames of collapsed stacks
+    return label.replaceCharacter (';', ',');
+}
+
+void ECMAScriptProfile::writeCollapsedStacks (OutputStream& output, int nodeIndex, const String& path) const
+{
+    const auto& node = nodes[(size_t) nodeIndex];
+
+    if (node.hitCount > 0)
+        output << path << " " << node.hitCount << "\n";
+
+    for (auto c : node.children)
+    {
+        const auto label = getFrameLabel (nodes[(size_t) c].frameIndex);
+        writeCollapsedStacks (output, c, path.isEmpty() ? label : path + ";" + label);
+    }
+}
+
+void ECMAScriptProfile::writeCollapsedStacks (OutputStream& output) const
+{
+    writeCollapsedStacks (output, 0, {});
+}
+
+void ECMAScriptProfile::writeChromeProfile (OutputStream& output) const
+{
+    // Chrome's node IDs start from 1, so the IDs used here are the node indices plus one.
+    Array<var> jsonNodes;
+
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        const auto& node = nodes[i];
+
+        DynamicObject::Ptr callFrame = new DynamicObject();
+
+        if (node.frameIndex < 0)
+        {
+            callFrame->setProperty ("functionName", "(root)");
+            callFrame->setProperty ("url", String());
+            callFrame->setProperty ("lineNumber", -1);
+        }
+        else
+        {
+            const auto& frame = frames[(size_t) node.frameIndex];
+            callFrame->setProperty ("functionName", frame.functionName);
+            callFrame->setProperty ("url", frame.fileName);
+            callFrame->setProperty ("lineNumber", frame.lineNumber - 1);
+        }
+
+        callFrame->setProperty ("scriptId", "0");
+        callFrame->setProperty ("columnNumber", -1);
+
+        Array<var> children;
+        for (auto c : node.children)
+            children.add (c + 1);
+
+        DynamicObject::Ptr jsonNode = new DynamicObject();
+        jsonNode->setProperty ("id", (int) i + 1);
+        jsonNode->setProperty ("callFrame", callFrame.get());
+        jsonNode->setProperty ("hitCount", node.hitCount);
+        jsonNode->setProperty ("children", children);
+        jsonNodes.add (jsonNode.get());
+    }
+
+    Array<var> jsonSamples, jsonTimeDeltas;
+    jsonSamples.ensureStorageAllocated ((int) samples.size());
+    jsonTimeDeltas.ensureStorageAllocated ((int) timeDeltas.size());
+
+    for (auto s : samples)
+        jsonSamples.add (s + 1);
+
+    for (auto t : timeDeltas)
+        jsonTimeDeltas.add (t);
+
+    DynamicObject::Ptr profile = new DynamicObject();
+    profile->setProperty ("nodes", jsonNodes);
+    profile->setProperty ("startTime", startTime);
+    profile->setProperty ("endTime", endTime);
+    profile->setProperty ("samples", jsonSamples);
+    profile->setProperty ("timeDeltas", jsonTimeDeltas);
+
+    JSON::writeToStream (output, profile.get(), true);
+}
@@ -0,0 +1,78 @@
+/** A CPU profile of script execution, built by periodically sampling the call stack.
+
+    Samples are only taken while bytecode is running, so the time spent inside
+    native functions isn't attributed to them; native functions only show up
+    as the callers of scripts, such as `Array.prototype.forEach`.
+
+    @see ECMAScriptEngine::startProfiling
+*/
+class ECMAScriptProfile final
+{
+public:
+    //==============================================================================
+    /** Constructor. */
+    ECMAScriptProfile() = default;
+
+    //==============================================================================
+    /** A function seen on the call stack. */
+    struct Frame final
+    {
+        String functionName;    /**< The name of the function, or "(anonymous)". */
+        String fileName;        /**< The name of the script the function was compiled from, if any. */
+        int lineNumber = 0;     /**< The line the function's code starts on, or 0 for native functions. */
+    };
+
+    /** A node of the call tree: a frame reached through a particular chain of callers. */
+    struct Node final
+    {
+        int frameIndex = -1;        /**< The index of this node's frame, or -1 for the root. */
+        int parentIndex = -1;       /**< The index of the calling node, or -1 for the root. */
+        int hitCount = 0;           /**< The number of samples taken while this node was on top of the stack. */
+        std::vector<int> children;  /**< The indices of the nodes called from this one. */
+    };
+
+    //==============================================================================
+    /** @returns the number of samples taken. */
+    int getNumSamples() const noexcept                          { return (int) samples.size(); }
+
+    /** @returns the time covered by the profile, in microseconds. */
+    int64 getDurationMicroseconds() const noexcept              { return endTime - startTime; }
+
+    /** @returns the frames referenced by the call tree. */
+    const std::vector<Frame>& getFrames() const noexcept        { return frames; }
+
+    /** @returns the call tree, where the first node is the root. */
+    const std::vector<Node>& getNodes() const noexcept          { return nodes; }
+
+    //==============================================================================
+    /** Writes the profile as collapsed stacks: one "outer;...;inner count" line
+        per distinct stack seen, as consumed by flamegraph.pl and speedscope.
+    */
+    void writeCollapsedStacks (OutputStream& output) const;
+
+    /** Writes the profile in the Chrome DevTools .cpuprofile JSON format. */
+    void writeChromeProfile (OutputStream& output) const;
+
+    //==============================================================================
+    /** @internal Sets the time the profile starts from, in microseconds. */
+    void start (int64 timeMicroseconds);
+    /** @internal Adds a frame, returning its index. */
+    int addFrame (Frame frame);
+    /** @internal Adds a sample of the given frame indices, ordered from the innermost call outwards. */
+    void addSample (const int* frameIndices, int numFrames, int64 timeMicroseconds);
+    /** @internal Sets the time the profile ends at, in microseconds. */
+    void finish (int64 timeMicroseconds);
+
+private:
+    //==============================================================================
+    std::vector<Frame> frames;
+    std::vector<Node> nodes { Node() };
+    std::vector<int> samples;
+    std::vector<int64> timeDeltas;
+    int64 startTime = 0, endTime = 0, lastSampleTime = 0;
+
+    String getFrameLabel (int frameIndex) const;
+    void writeCollapsedStacks (OutputStream&, int nodeIndex, const String& path) const;
+
+    JUCE_LEAK_DETECTOR (ECMAScriptProfile)
+};
@@ -3740,6 +3740,14 @@ typedef struct duk_hthread duk_context;
 #endif  /* defined(DUK_USE_BYTEORDER) */
 
 
+/* SSE2 is part of every x64 target and most x86 ones; string searches use
+ * it when the compiler targets it.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define DUK_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 #if JUCE_DEBUG
 //TODO: We need a better system for allowing custom/user configured duk_config headers
 //      in react-juce. This set of inline change works for now to enable debugging support.
@@ -3750,4 +3758,34 @@ typedef struct duk_hthread duk_context;
 
 #endif
 
+#if defined(SQUAREPINE_DUKTAPE_USE_FASTINT) && SQUAREPINE_DUKTAPE_USE_FASTINT && defined(DUK_USE_64BIT_OPS)
+#define DUK_USE_FASTINT
+#endif
+
+#if defined(SQUAREPINE_DUKTAPE_USE_JSON_FASTLANE) && SQUAREPINE_DUKTAPE_USE_JSON_FASTLANE
+#define DUK_USE_JSON_STRINGIFY_FASTPATH
+#endif
+
+#if defined(SQUAREPINE_DUKTAPE_ENABLE_PROFILER) && SQUAREPINE_DUKTAPE_ENABLE_PROFILER && !defined(DUK_USE_INTERRUPT_COUNTER)
+#define DUK_USE_INTERRUPT_COUNTER
+#endif
+
+#if defined(SQUAREPINE_DUKTAPE_USE_COMPUTED_GOTO) && SQUAREPINE_DUKTAPE_USE_COMPUTED_GOTO
+#define DUK_USE_EXEC_COMPUTED_GOTO  /* ignored by compilers without labels as values */
+#endif
+
+#if defined(SQUAREPINE_DUKTAPE_USE_PROPERTY_CACHE) && SQUAREPINE_DUKTAPE_USE_PROPERTY_CACHE
+#define DUK_USE_EXEC_PROPCACHE_SIZE 512
+#endif
+
+#if defined(SQUAREPINE_DUKTAPE_USE_EXTERNAL_STRINGS) && SQUAREPINE_DUKTAPE_USE_EXTERNAL_STRINGS
+/* Defined by the wrapper: keeps strings it registers as external pointing at the
+ * native text.  That text outlives the heap, so there's nothing to free.
+ */
+const void *squarepine_duktape_intern_external_string(void *udata, void *ptr, duk_size_t len);
+#define DUK_USE_HSTRING_EXTDATA
+#define DUK_USE_EXTSTR_INTERN_CHECK(udata,ptr,len) squarepine_duktape_intern_external_string((udata), (ptr), (len))
+#define DUK_USE_EXTSTR_FREE(udata,ptr) do { (void) (udata); (void) (ptr); } while (0)
+#endif
+
 #endif  /* DUK_CONFIG_H_INCLUDED */
@@ -2932,6 +2932,7 @@ DUK_INTERNAL_DECL void duk_byteswap_bytes(duk_uint8_t *p, duk_small_uint_t len);
 
 DUK_INTERNAL_DECL duk_small_int_t duk_memcmp(const void *s1, const void *s2, duk_size_t len);
 DUK_INTERNAL_DECL duk_small_int_t duk_memcmp_unsafe(const void *s1, const void *s2, duk_size_t len);
+DUK_INTERNAL_DECL const duk_uint8_t *duk_memmem(const duk_uint8_t *p, duk_size_t p_len, const duk_uint8_t *q, duk_size_t q_len);
 
 DUK_INTERNAL_DECL duk_bool_t duk_is_whole_get_int32_nonegzero(duk_double_t x, duk_int32_t *ival);
 DUK_INTERNAL_DECL duk_bool_t duk_is_whole_get_int32(duk_double_t x, duk_int32_t *ival);
@@ -3553,8 +3554,8 @@ typedef duk_uint32_t duk_instr_t;
 #define DUK_OP_GETPROPC_CR          209
 #define DUK_OP_GETPROPC_RC          210
 #define DUK_OP_GETPROPC_CC          211
-#define DUK_OP_UNUSED212            212
-#define DUK_OP_UNUSED213            213
+#define DUK_OP_SWITCHINT            212  /* followed by an inline dispatch table, see below */
+#define DUK_OP_SWITCHSTR            213
 #define DUK_OP_UNUSED214            214
 #define DUK_OP_UNUSED215            215
 #define DUK_OP_UNUSED216            216
@@ -3613,6 +3614,29 @@ typedef duk_uint32_t duk_instr_t;
  */
 #define DUK_BC_DECLVAR_FLAG_FUNC_DECL       (1U << 4)  /* function declaration */
 
+/* DUK_OP_SWITCHINT and DUK_OP_SWITCHSTR dispatch a switch statement whose
+ * cases are all integer or all string constants.  BC is the register with
+ * the switch value, and the instruction is followed by an inline table:
+ *
+ *   SWITCHINT:  NOP (ABC = table size)
+ *               NOP (ABC = lowest case value + DUK_BC_JUMP_BIAS)
+ *               JUMP for each value from the lowest case value onwards
+ *               JUMP for no match
+ *
+ *   SWITCHSTR:  NOP (ABC = slot count - 1, slot count is a power of two)
+ *               NOP (A = 1 if used, BC = string constant), JUMP; per slot
+ *               JUMP for no match
+ *
+ * The string slots are an open addressing hash table keyed by
+ * duk_js_switch_hash() of the string, which doesn't depend on the heap so
+ * that the table stays valid in dumped bytecode.  The table is never
+ * executed except for the JUMP the dispatch lands on.
+ */
+#define DUK_BC_SWITCH_TABLE_LENGTH(ins,param) \
+	(DUK_DEC_OP((ins)) == DUK_OP_SWITCHINT ? \
+		(duk_int_t) DUK_DEC_ABC((param)) + 3 : \
+		((duk_int_t) DUK_DEC_ABC((param)) + 1) * 2 + 2)  /* instructions after the SWITCHxxx */
+
 /* DUK_OP_CALLn flags, part of opcode field.  Three lowest bits must match
  * DUK_CALL_FLAG_xxx directly.
  */
@@ -4283,6 +4307,9 @@ struct duk_compiler_ctx {
 	/* code emission temporary */
 	duk_int_t emit_jumpslot_pc;
 
+	/* run the bytecode optimizer on finished functions (DUK_COMPILE_OPTIMIZE) */
+	duk_bool_t optimize;
+
 	/* current function being compiled (embedded instead of pointer for more compact access) */
 	duk_compiler_func curr_func;
 };
@@ -5560,6 +5587,7 @@ DUK_INTERNAL_DECL duk_int_t duk_to_int_clamped(duk_hthread *thr, duk_idx_t idx,
 DUK_INTERNAL_DECL duk_int_t duk_to_int_check_range(duk_hthread *thr, duk_idx_t idx, duk_int_t minval, duk_int_t maxval);
 #if defined(DUK_USE_BUFFEROBJECT_SUPPORT)
 DUK_INTERNAL_DECL duk_uint8_t duk_to_uint8clamped(duk_hthread *thr, duk_idx_t idx);
+DUK_INTERNAL_DECL duk_uint8_t duk_double_to_uint8clamped(duk_double_t d);
 #endif
 DUK_INTERNAL_DECL duk_hstring *duk_to_property_key_hstring(duk_hthread *thr, duk_idx_t idx);
 
@@ -6990,6 +7018,7 @@ DUK_INTERNAL_DECL void duk_hobject_set_prototype_updref(duk_hthread *thr, duk_ho
 #if defined(DUK_USE_PC2LINE)
 DUK_INTERNAL_DECL void duk_hobject_pc2line_pack(duk_hthread *thr, duk_compiler_instr *instrs, duk_uint_fast32_t length);
 DUK_INTERNAL_DECL duk_uint_fast32_t duk_hobject_pc2line_query(duk_hthread *thr, duk_idx_t idx_func, duk_uint_fast32_t pc);
+DUK_INTERNAL_DECL duk_uint_fast32_t duk_hobject_pc2line_query_raw_func(duk_hthread *thr, duk_hobject *func, duk_uint_fast32_t pc);
 #endif
 
 /* misc */
@@ -8759,7 +8788,37 @@ struct duk_heap {
 	 */
 #if defined(DUK_USE_VOLUNTARY_GC)
 	duk_int_t ms_trigger_counter;
-#endif
+
+	/* Runtime adjustable trigger: after mark-and-sweep the counter is
+	 * reset to (kept objects and strings / 256) * mult + add.  A negative
+	 * 'ms_trigger_mult' disables voluntary mark-and-sweep.
+	 */
+	duk_int_t ms_trigger_mult;
+	duk_int_t ms_trigger_add;
+#endif
+
+	/* Application callback for mark-and-sweep pause times. */
+	duk_gc_pause_function ms_pause_func;  /* NULL if not set */
+	void *ms_pause_udata;
+
+	/* Live heap accounting for duk_get_heap_stats(), maintained on
+	 * allocation, resize and free so that no heap walk is needed.
+	 * Object bytes cover the object struct and its property table.
+	 */
+	duk_size_t hs_obj_count[DUK_HOBJECT_CLASS_MAX + 1];
+	duk_size_t hs_obj_bytes[DUK_HOBJECT_CLASS_MAX + 1];
+	duk_size_t hs_str_count;
+	duk_size_t hs_str_bytes;
+	duk_size_t hs_buf_count;
+	duk_size_t hs_buf_bytes;
+	duk_size_t hs_litcache_hit;
+	duk_size_t hs_litcache_miss;
+	duk_size_t hs_propcache_hit;
+	duk_size_t hs_propcache_miss;
+	duk_size_t hs_refzero_free;
+	duk_size_t hs_ms_free;
+	duk_size_t hs_ms_count;
+	duk_size_t hs_callstack_peak;
 
 	/* Mark-and-sweep recursion control: too deep recursion causes
 	 * multi-pass processing to avoid growing C stack without bound.
@@ -8873,6 +8932,15 @@ struct duk_heap {
 	duk_int_t inst_count_interrupt;
 #endif
 
+	/* Application interrupt handler, called from the executor interrupt
+	 * every 'interrupt_interval' opcodes (e.g. for sampling profilers).
+	 */
+#if defined(DUK_USE_INTERRUPT_COUNTER)
+	duk_interrupt_function interrupt_func;  /* NULL if not set */
+	void *interrupt_udata;
+	duk_int_t interrupt_interval;
+#endif
+
 	/* Debugger state. */
 #if defined(DUK_USE_DEBUGGER_SUPPORT)
 	/* Callbacks and udata; dbg_read_cb != NULL is used to indicate attached state. */
@@ -8937,6 +9005,19 @@ struct duk_heap {
 	duk_litcache_entry litcache[DUK_USE_LITCACHE_SIZE];
 #endif
 
+#if defined(DUK_USE_EXEC_PROPCACHE_SIZE)
+	/* Property access cache for GETPROP/PUTPROP call sites (and GETVAR/
+	 * PUTVAR call sites resolving to the global object), indexed by
+	 * instruction address.  Each slot holds the entry part indices where
+	 * the call site last found its key as an own data property; hints are
+	 * checked against the receiver on every use, so they're never stale.
+	 * 'propcache_e_idx' is how the generic lookup reports the index it
+	 * found (-1 if the access wasn't cacheable).
+	 */
+	duk_uint16_t propcache[DUK_USE_EXEC_PROPCACHE_SIZE][2];  /* most recent first */
+	duk_int_t propcache_e_idx;
+#endif
+
 	/* Built-in strings. */
 #if defined(DUK_USE_ROM_STRINGS)
 	/* No field needed when strings are in ROM. */
@@ -9019,6 +9100,11 @@ DUK_INTERNAL_DECL void duk_free_hstring(duk_heap *heap, duk_hstring *h);
 DUK_INTERNAL_DECL void duk_heap_free_heaphdr_raw(duk_heap *heap, duk_heaphdr *hdr);
 
 DUK_INTERNAL_DECL void duk_heap_insert_into_heap_allocated(duk_heap *heap, duk_heaphdr *hdr);
+
+DUK_INTERNAL_DECL duk_size_t duk_heap_hobject_alloc_size(duk_hobject *h);
+DUK_INTERNAL_DECL duk_size_t duk_heap_hstring_alloc_size(duk_hstring *h);
+DUK_INTERNAL_DECL duk_size_t duk_heap_hbuffer_alloc_size(duk_hbuffer *h);
+DUK_INTERNAL_DECL void duk_heap_hobject_set_class(duk_heap *heap, duk_hobject *h, duk_small_uint_t class_num);
 #if defined(DUK_USE_REFERENCE_COUNTING)
 DUK_INTERNAL_DECL void duk_heap_remove_from_heap_allocated(duk_heap *heap, duk_heaphdr *hdr);
 #endif
@@ -10220,6 +10306,9 @@ DUK_INTERNAL_DECL duk_small_int_t duk_unicode_encode_cesu8(duk_ucodepoint_t cp,
 DUK_INTERNAL_DECL duk_small_int_t duk_unicode_decode_xutf8(duk_hthread *thr, const duk_uint8_t **ptr, const duk_uint8_t *ptr_start, const duk_uint8_t *ptr_end, duk_ucodepoint_t *out_cp);
 DUK_INTERNAL_DECL duk_ucodepoint_t duk_unicode_decode_xutf8_checked(duk_hthread *thr, const duk_uint8_t **ptr, const duk_uint8_t *ptr_start, const duk_uint8_t *ptr_end);
 DUK_INTERNAL_DECL duk_size_t duk_unicode_unvalidated_utf8_length(const duk_uint8_t *data, duk_size_t blen);
+#if defined(DUK_USE_ENCODING_BUILTINS) && !defined(DUK_USE_PREFER_SIZE)
+DUK_INTERNAL_DECL duk_size_t duk_unicode_ascii_prefix_length(const duk_uint8_t *data, duk_size_t blen);
+#endif
 DUK_INTERNAL_DECL duk_small_int_t duk_unicode_is_whitespace(duk_codepoint_t cp);
 DUK_INTERNAL_DECL duk_small_int_t duk_unicode_is_line_terminator(duk_codepoint_t cp);
 DUK_INTERNAL_DECL duk_small_int_t duk_unicode_is_identifier_start(duk_codepoint_t cp);
@@ -10352,6 +10441,7 @@ DUK_INTERNAL_DECL duk_bool_t duk_js_instanceof_ordinary(duk_hthread *thr, duk_tv
 #endif
 DUK_INTERNAL_DECL duk_bool_t duk_js_in(duk_hthread *thr, duk_tval *tv_x, duk_tval *tv_y);
 DUK_INTERNAL_DECL duk_small_uint_t duk_js_typeof_stridx(duk_tval *tv_x);
+DUK_INTERNAL_DECL duk_uint32_t duk_js_switch_hash(const duk_uint8_t *str, duk_size_t blen);
 
 /* arithmetic */
 DUK_INTERNAL_DECL double duk_js_arith_pow(double x, double y);
@@ -12125,8 +12215,10 @@ DUK_INTERNAL duk_size_t duk_unicode_unvalidated_utf8_length(const duk_uint8_t *d
 DUK_INTERNAL duk_size_t duk_unicode_unvalidated_utf8_length(const duk_uint8_t *data, duk_size_t blen) {
 	const duk_uint8_t *p;
 	const duk_uint8_t *p_end;
+#if !defined(DUK_USE_SSE2)
 	const duk_uint32_t *p32_end;
 	const duk_uint32_t *p32;
+#endif
 	duk_size_t ncont;
 	duk_size_t clen;
 
@@ -12137,6 +12229,30 @@ DUK_INTERNAL duk_size_t duk_unicode_unvalidated_utf8_length(const duk_uint8_t *d
 		goto skip_fastpath;
 	}
 
+#if defined(DUK_USE_SSE2)
+	/* With SSE2, 16 bytes at a time.  As signed bytes the continuation
+	 * bytes [0x80,0xbf] are exactly those below -64, and each of them
+	 * subtracts -1 from its lane's counter.  The lane counters are summed
+	 * up (_mm_sad_epu8) before any of them can wrap.
+	 */
+	{
+		const __m128i v_limit = _mm_set1_epi8((char) -64);
+		const __m128i v_zero = _mm_setzero_si128();
+
+		while ((duk_size_t) (p_end - p) >= 16) {
+			__m128i v_count = v_zero;
+			duk_small_uint_t n;
+
+			for (n = 0; n < 255 && (duk_size_t) (p_end - p) >= 16; n++, p += 16) {
+				__m128i v = _mm_loadu_si128((const __m128i *) (const void *) p);
+				v_count = _mm_sub_epi8(v_count, _mm_cmplt_epi8(v, v_limit));
+			}
+			v_count = _mm_sad_epu8(v_count, v_zero);
+			ncont += (duk_size_t) _mm_cvtsi128_si32(v_count) +
+			         (duk_size_t) _mm_cvtsi128_si32(_mm_srli_si128(v_count, 8));
+		}
+	}
+#else  /* DUK_USE_SSE2 */
 	/* Align 'p' to 4; the input data may have arbitrary alignment.
 	 * End of string check not needed because blen >= 16.
 	 */
@@ -12177,6 +12293,7 @@ DUK_INTERNAL duk_size_t duk_unicode_unvalidated_utf8_length(const duk_uint8_t *d
 		}
 	}
 	p = (const duk_uint8_t *) p32;
+#endif  /* DUK_USE_SSE2 */
 	/* Fall through to handle the rest. */
 
  skip_fastpath:
@@ -12195,6 +12312,45 @@ DUK_INTERNAL duk_size_t duk_unicode_unvalidated_utf8_length(const duk_uint8_t *d
 }
 #endif  /* DUK_USE_PREFER_SIZE */
 
+/* Length of the run of ASCII bytes at the start of 'data'.  ASCII is the
+ * same in CESU-8 and UTF-8, so the encoding built-ins copy such runs as is
+ * instead of decoding and re-encoding them one codepoint at a time.
+ */
+#if defined(DUK_USE_ENCODING_BUILTINS) && !defined(DUK_USE_PREFER_SIZE)
+DUK_INTERNAL duk_size_t duk_unicode_ascii_prefix_length(const duk_uint8_t *data, duk_size_t blen) {
+	const duk_uint8_t *p;
+	const duk_uint8_t *p_end;
+
+	p = data;
+	p_end = data + blen;
+
+	/* Skip whole blocks without a high bit set; the byte loop then
+	 * finds the exact end of the run within the block that has one.
+	 */
+#if defined(DUK_USE_SSE2)
+	while ((duk_size_t) (p_end - p) >= 16) {
+		if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i *) (const void *) p)) != 0) {
+			break;
+		}
+		p += 16;
+	}
+#else
+	while ((duk_size_t) (p_end - p) >= 4) {
+		duk_uint32_t x;
+		duk_memcpy((void *) &x, (const void *) p, 4);
+		if (x & 0x80808080UL) {
+			break;
+		}
+		p += 4;
+	}
+#endif
+	while (p != p_end && *p <= 0x7fU) {
+		p++;
+	}
+	return (duk_size_t) (p - data);
+}
+#endif  /* DUK_USE_ENCODING_BUILTINS && !DUK_USE_PREFER_SIZE */
+
 /*
  *  Unicode range matcher
  *
@@ -16474,6 +16630,52 @@ DUK_EXTERNAL void duk_inspect_callstack_entry(duk_hthread *thr, duk_int_t level)
 	 */
 }
 
+/* Fills 'out_frames' with up to 'max_frames' activations of the calling
+ * thread, innermost first, and returns how many were filled.  Unlike
+ * duk_inspect_callstack_entry() the activations are read in place: no
+ * allocation, getter calls or errors, so this is safe to call from an
+ * interrupt handler, e.g. for a sampling profiler.
+ */
+DUK_EXTERNAL duk_int_t duk_get_callstack_frames(duk_hthread *thr, duk_callstack_frame *out_frames, duk_int_t max_frames) {
+	duk_activation *act;
+	duk_int_t count;
+
+	DUK_ASSERT_API_ENTRY(thr);
+	DUK_ASSERT(out_frames != NULL || max_frames <= 0);
+
+	count = 0;
+	for (act = thr->callstack_curr; act != NULL && count < max_frames; act = act->parent) {
+		duk_callstack_frame *frame = out_frames + count++;
+		duk_hobject *func;
+		duk_tval *tv;
+
+		duk_memzero((void *) frame, sizeof(*frame));
+		func = DUK_TVAL_IS_OBJECT(&act->tv_func) ? DUK_TVAL_GET_OBJECT(&act->tv_func) : NULL;
+		frame->function = (void *) func;
+		frame->is_native = (func == NULL || DUK_HOBJECT_IS_NATFUNC(func));
+		if (func == NULL) {
+			continue;
+		}
+
+		tv = duk_hobject_find_entry_tval_ptr_stridx(thr->heap, func, DUK_STRIDX_NAME);
+		if (tv != NULL && DUK_TVAL_IS_STRING(tv)) {
+			frame->name = (const char *) DUK_HSTRING_GET_DATA(DUK_TVAL_GET_STRING(tv));
+			frame->name_len = (duk_size_t) DUK_HSTRING_GET_BYTELEN(DUK_TVAL_GET_STRING(tv));
+		}
+		tv = duk_hobject_find_entry_tval_ptr_stridx(thr->heap, func, DUK_STRIDX_FILE_NAME);
+		if (tv != NULL && DUK_TVAL_IS_STRING(tv)) {
+			frame->file_name = (const char *) DUK_HSTRING_GET_DATA(DUK_TVAL_GET_STRING(tv));
+			frame->file_name_len = (duk_size_t) DUK_HSTRING_GET_BYTELEN(DUK_TVAL_GET_STRING(tv));
+		}
+#if defined(DUK_USE_PC2LINE)
+		if (DUK_HOBJECT_IS_COMPFUNC(func)) {
+			frame->start_line = (duk_uint_t) duk_hobject_pc2line_query_raw_func(thr, func, 0);
+		}
+#endif
+	}
+	return count;
+}
+
 /* automatic undefs */
 #undef DUK__IDX_ASIZE
 #undef DUK__IDX_BCBYTES
@@ -16569,6 +16771,102 @@ DUK_EXTERNAL void duk_gc(duk_hthread *thr, duk_uint_t flags) {
 	ms_flags = (duk_small_uint_t) flags;
 	duk_heap_mark_and_sweep(heap, ms_flags);
 }
+
+DUK_EXTERNAL void duk_set_gc_trigger(duk_hthread *thr, duk_int_t mult, duk_int_t add) {
+	duk_heap *heap;
+
+	DUK_ASSERT_API_ENTRY(thr);
+	heap = thr->heap;
+	DUK_ASSERT(heap != NULL);
+
+#if defined(DUK_USE_VOLUNTARY_GC)
+	heap->ms_trigger_mult = (mult < 0 ? -1 : mult);
+	heap->ms_trigger_add = (add < 0 ? 0 : add);
+
+	/* The new thresholds take effect when the counter is next reset,
+	 * except that disabling takes effect right away.
+	 */
+	if (mult < 0) {
+		heap->ms_trigger_counter = DUK_INT_MAX;
+	}
+#else
+	DUK_UNREF(heap);
+	DUK_UNREF(mult);
+	DUK_UNREF(add);
+#endif
+}
+
+DUK_EXTERNAL void duk_get_heap_stats(duk_hthread *thr, duk_heap_stats *out_stats) {
+	duk_heap *heap;
+	duk_small_uint_t i;
+
+	DUK_ASSERT_API_ENTRY(thr);
+	DUK_ASSERT(out_stats != NULL);
+	heap = thr->heap;
+	DUK_ASSERT(heap != NULL);
+
+	duk_memzero((void *) out_stats, sizeof(*out_stats));
+
+	DUK_ASSERT(DUK_HOBJECT_CLASS_MAX < DUK_HEAP_STATS_NUM_CLASSES);
+	for (i = 0; i <= DUK_HOBJECT_CLASS_MAX; i++) {
+		out_stats->object_count[i] = heap->hs_obj_count[i];
+		out_stats->object_bytes[i] = heap->hs_obj_bytes[i];
+	}
+
+	out_stats->string_count = heap->hs_str_count;
+	out_stats->string_bytes = heap->hs_str_bytes;
+	out_stats->buffer_count = heap->hs_buf_count;
+	out_stats->buffer_bytes = heap->hs_buf_bytes;
+	out_stats->strtab_size = (duk_size_t) heap->st_size;
+	out_stats->litcache_hit = heap->hs_litcache_hit;
+	out_stats->litcache_miss = heap->hs_litcache_miss;
+	out_stats->propcache_hit = heap->hs_propcache_hit;
+	out_stats->propcache_miss = heap->hs_propcache_miss;
+	out_stats->refzero_free_count = heap->hs_refzero_free;
+	out_stats->ms_free_count = heap->hs_ms_free;
+	out_stats->ms_count = heap->hs_ms_count;
+	out_stats->valstack_used = (duk_size_t) (thr->valstack_top - thr->valstack);
+	out_stats->valstack_reserved = (duk_size_t) (thr->valstack_alloc_end - thr->valstack);
+	out_stats->callstack_depth = thr->callstack_top;
+	out_stats->callstack_peak = heap->hs_callstack_peak;
+}
+
+DUK_EXTERNAL void duk_set_gc_pause_handler(duk_hthread *thr, duk_gc_pause_function func, void *udata) {
+	DUK_ASSERT_API_ENTRY(thr);
+	DUK_ASSERT(thr->heap != NULL);
+
+	thr->heap->ms_pause_func = func;
+	thr->heap->ms_pause_udata = (func != NULL ? udata : NULL);
+}
+
+DUK_EXTERNAL void duk_set_interrupt_handler(duk_hthread *thr, duk_interrupt_function func, void *udata, duk_int_t interval) {
+	DUK_ASSERT_API_ENTRY(thr);
+	DUK_ASSERT(thr->heap != NULL);
+
+#if defined(DUK_USE_INTERRUPT_COUNTER)
+	if (interval <= 0 || interval > DUK_HTHREAD_INTCTR_DEFAULT) {
+		interval = DUK_HTHREAD_INTCTR_DEFAULT;
+	}
+
+	thr->heap->interrupt_func = func;
+	thr->heap->interrupt_udata = (func != NULL ? udata : NULL);
+	thr->heap->interrupt_interval = interval;
+
+	/* Restart the countdown so that a shorter interval takes effect
+	 * right away rather than after the current default countdown.
+	 */
+	DUK_ASSERT(thr->interrupt_counter <= thr->interrupt_init);
+	thr->interrupt_init -= thr->interrupt_counter;
+	thr->interrupt_counter = 0;
+#else
+	DUK_UNREF(udata);
+	DUK_UNREF(interval);
+	if (func != NULL) {
+		DUK_ERROR_UNSUPPORTED(thr);
+		DUK_WO_NORETURN(return;);
+	}
+#endif
+}
 /*
  *  Object handling: property access and other support functions.
  */
@@ -20612,18 +20910,20 @@ DUK_EXTERNAL duk_uint16_t duk_to_uint16(duk_hthread *thr, duk_idx_t idx) {
 #if defined(DUK_USE_BUFFEROBJECT_SUPPORT)
 /* Special coercion for Uint8ClampedArray. */
 DUK_INTERNAL duk_uint8_t duk_to_uint8clamped(duk_hthread *thr, duk_idx_t idx) {
-	duk_double_t d;
+	DUK_ASSERT_API_ENTRY(thr);
+
+	return duk_double_to_uint8clamped(duk_to_number(thr, idx));
+}
+
+DUK_INTERNAL duk_uint8_t duk_double_to_uint8clamped(duk_double_t d) {
 	duk_double_t t;
 	duk_uint8_t ret;
 
-	DUK_ASSERT_API_ENTRY(thr);
-
 	/* XXX: Simplify this algorithm, should be possible to come up with
 	 * a shorter and faster algorithm by inspecting IEEE representation
 	 * directly.
 	 */
 
-	d = duk_to_number(thr, idx);
 	if (d <= 0.0) {
 		return 0;
 	} else if (d >= 255) {
@@ -25703,308 +26003,365 @@ DUK_INTERNAL duk_ret_t duk_bi_array_prototype_push(duk_hthread *thr) {
 /*
  *  sort()
  *
- *  Currently qsort with random pivot.  This is now really, really slow,
- *  because there is no fast path for array parts.
+ *  Stable merge sort, as required since ES2019.  The values are first read
+ *  into a temporary array, leaving out undefined values and holes, which
+ *  are only counted.  An index permutation of that array is then sorted and
+ *  finally written back, followed by the undefined values, with the holes
+ *  deleted last.  Plain arrays are read and written through their array
+ *  part directly.
  *
- *  Signed indices are used because qsort() leaves and degenerate cases
- *  may use a negative offset.
+ *  Without a comparefn, values compare by their ToString() coercions, but
+ *  how depends on the values:
+ *
+ *    - Strings compare directly, and int32 numbers by their decimal digits
+ *      without creating strings.
+ *
+ *    - Other primitives are coerced once per value before sorting.
+ *
+ *    - If there are objects, each comparison coerces both values, as their
+ *      toString() may have side effects.
+ *
+ *  A comparefn is called with the values from the temporary array, so the
+ *  array isn't read again during the sort.  An error thrown by comparefn or
+ *  ToString() leaves the array untouched.
  */
 
-DUK_LOCAL duk_small_int_t duk__array_sort_compare(duk_hthread *thr, duk_int_t idx1, duk_int_t idx2) {
-	duk_bool_t have1, have2;
-	duk_bool_t undef1, undef2;
-	duk_small_int_t ret;
-	duk_idx_t idx_obj = 1;  /* fixed offsets in valstack */
-	duk_idx_t idx_fn = 0;
-	duk_hstring *h1, *h2;
-
-	/* Fast exit if indices are identical.  This is valid for a non-existent property,
-	 * for an undefined value, and almost always for ToString() coerced comparison of
-	 * arbitrary values (corner cases where this is not the case include e.g. a an
-	 * object with varying ToString() coercion).
-	 *
-	 * The specification does not prohibit "caching" of values read from the array, so
-	 * assuming equality for comparing an index with itself falls into the category of
-	 * "caching".
-	 *
-	 * Also, compareFn may be inconsistent, so skipping a call to compareFn here may
-	 * have an effect on the final result.  The specification does not require any
-	 * specific behavior for inconsistent compare functions, so again, this fast path
-	 * is OK.
-	 */
+#define DUK__SORT_KEY_INT       0  /* int32 numbers, compared as decimal strings */
+#define DUK__SORT_KEY_STRING    1  /* strings, or the coerced strings of primitives */
+#define DUK__SORT_KEY_TOSTRING  2  /* coerce both values on every comparison */
+#define DUK__SORT_KEY_COMPAREFN 3
 
-	if (idx1 == idx2) {
-		DUK_DDD(DUK_DDDPRINT("duk__array_sort_compare: idx1=%ld, idx2=%ld -> indices identical, quick exit",
-		                     (long) idx1, (long) idx2));
-		return 0;
-	}
+#define DUK__SORT_RUN           8  /* length of runs insertion sorted before merging */
 
-	have1 = duk_get_prop_index(thr, idx_obj, (duk_uarridx_t) idx1);
-	have2 = duk_get_prop_index(thr, idx_obj, (duk_uarridx_t) idx2);
+/* Fixed value stack offsets. */
+#define DUK__SORT_IDX_FN        0
+#define DUK__SORT_IDX_OBJ       1
+#define DUK__SORT_IDX_VALS      3
 
-	DUK_DDD(DUK_DDDPRINT("duk__array_sort_compare: idx1=%ld, idx2=%ld, have1=%ld, have2=%ld, val1=%!T, val2=%!T",
-	                     (long) idx1, (long) idx2, (long) have1, (long) have2,
-	                     (duk_tval *) duk_get_tval(thr, -2), (duk_tval *) duk_get_tval(thr, -1)));
+typedef struct {
+	duk_hthread *thr;
+	duk_small_uint_t key_type;
+	duk_harray *h_vals;      /* values being sorted, reachable from the value stack */
+	duk_harray *h_keys;      /* strings compared for DUK__SORT_KEY_STRING, may be h_vals */
+	duk_int32_t *ints;       /* values for DUK__SORT_KEY_INT */
+} duk__array_sort_state;
 
-	if (have1) {
-		if (have2) {
-			;
-		} else {
-			ret = -1;
-			goto pop_ret;
-		}
-	} else {
-		if (have2) {
-			ret = 1;
-			goto pop_ret;
-		} else {
-			ret = 0;
-			goto pop_ret;
-		}
+/* Compare the decimal strings of two int32 values without creating them. */
+DUK_LOCAL duk_small_int_t duk__array_sort_compare_ints(duk_int32_t x, duk_int32_t y) {
+	duk_uint32_t ux, uy, t;
+	duk_small_int_t len_diff = 0;  /* digits in x minus digits in y */
+
+	if (x == y) {
+		return 0;
 	}
+	if ((x < 0) != (y < 0)) {
+		return (x < 0 ? -1 : 1);  /* '-' sorts before digits */
+	}
+	ux = (x < 0 ? (duk_uint32_t) -(x + 1) + 1U : (duk_uint32_t) x);
+	uy = (y < 0 ? (duk_uint32_t) -(y + 1) + 1U : (duk_uint32_t) y);
 
-	undef1 = duk_is_undefined(thr, -2);
-	undef2 = duk_is_undefined(thr, -1);
-	if (undef1) {
-		if (undef2) {
-			ret = 0;
-			goto pop_ret;
-		} else {
-			ret = 1;
-			goto pop_ret;
+	/* Cut the longer one to the length of the shorter one and compare
+	 * those; if they're equal, the shorter string sorts first.
+	 */
+	for (t = ux; t >= 10U; t /= 10U) {
+		len_diff++;
+	}
+	for (t = uy; t >= 10U; t /= 10U) {
+		len_diff--;
+	}
+	for (; len_diff > 0; len_diff--) {
+		ux /= 10U;
+		if (ux == uy) {
+			return 1;
 		}
-	} else {
-		if (undef2) {
-			ret = -1;
-			goto pop_ret;
-		} else {
-			;
+	}
+	for (; len_diff < 0; len_diff++) {
+		uy /= 10U;
+		if (ux == uy) {
+			return -1;
 		}
 	}
+	return (ux < uy ? -1 : 1);
+}
 
-	if (!duk_is_undefined(thr, idx_fn)) {
+/* Compare values 'i1' and 'i2' of the temporary array; comparefn and
+ * ToString() may have side effects, including garbage collection, so the
+ * array part is looked up again after them.
+ */
+DUK_LOCAL duk_small_int_t duk__array_sort_compare(duk__array_sort_state *st, duk_uint32_t i1, duk_uint32_t i2) {
+	duk_hthread *thr = st->thr;
+	duk_tval *tv_vals;
+	duk_small_int_t ret;
+
+	switch (st->key_type) {
+	case DUK__SORT_KEY_INT: {
+		return duk__array_sort_compare_ints(st->ints[i1], st->ints[i2]);
+	}
+	case DUK__SORT_KEY_STRING: {
+		duk_tval *tv_keys = DUK_HOBJECT_A_GET_BASE(thr->heap, (duk_hobject *) st->h_keys);
+		duk_hstring *h1 = DUK_TVAL_GET_STRING(tv_keys + i1);
+		duk_hstring *h2 = DUK_TVAL_GET_STRING(tv_keys + i2);
+		return (h1 == h2 ? 0 : duk_js_string_compare(h1, h2));
+	}
+	case DUK__SORT_KEY_TOSTRING: {
+		duk_hstring *h1, *h2;
+
+		tv_vals = DUK_HOBJECT_A_GET_BASE(thr->heap, (duk_hobject *) st->h_vals);
+		duk_push_tval(thr, tv_vals + i1);
+		tv_vals = DUK_HOBJECT_A_GET_BASE(thr->heap, (duk_hobject *) st->h_vals);
+		duk_push_tval(thr, tv_vals + i2);
+		h1 = duk_to_hstring(thr, -2);
+		h2 = duk_to_hstring_m1(thr);
+		ret = duk_js_string_compare(h1, h2);
+		duk_pop_2_unsafe(thr);
+		return ret;
+	}
+	default: {
 		duk_double_t d;
 
+		DUK_ASSERT(st->key_type == DUK__SORT_KEY_COMPAREFN);
+
 		/* No need to check callable; duk_call() will do that. */
-		duk_dup(thr, idx_fn);    /* -> [ ... x y fn ] */
-		duk_insert(thr, -3);     /* -> [ ... fn x y ] */
-		duk_call(thr, 2);        /* -> [ ... res ] */
+		duk_dup(thr, DUK__SORT_IDX_FN);
+		tv_vals = DUK_HOBJECT_A_GET_BASE(thr->heap, (duk_hobject *) st->h_vals);
+		duk_push_tval(thr, tv_vals + i1);
+		duk_push_tval(thr, tv_vals + i2);
+		duk_call(thr, 2);
 
 		/* ES5 is a bit vague about what to do if the return value is
 		 * not a number.  ES2015 provides a concrete description:
 		 * http://www.ecma-international.org/ecma-262/6.0/#sec-sortcompare.
+		 * NaN compares false both ways, so it's treated as equal.
 		 */
-
 		d = duk_to_number_m1(thr);
-		if (d < 0.0) {
-			ret = -1;
-		} else if (d > 0.0) {
-			ret = 1;
-		} else {
-			/* Because NaN compares to false, NaN is handled here
-			 * without an explicit check above.
-			 */
-			ret = 0;
-		}
-
 		duk_pop_nodecref_unsafe(thr);
-		DUK_DDD(DUK_DDDPRINT("-> result %ld (from comparefn, after coercion)", (long) ret));
-		return ret;
+		return (d < 0.0 ? -1 : (d > 0.0 ? 1 : 0));
+	}
 	}
-
-	/* string compare is the default (a bit oddly) */
-
-	/* XXX: any special handling for plain array; causes repeated coercion now? */
-	h1 = duk_to_hstring(thr, -2);
-	h2 = duk_to_hstring_m1(thr);
-	DUK_ASSERT(h1 != NULL);
-	DUK_ASSERT(h2 != NULL);
-
-	ret = duk_js_string_compare(h1, h2);  /* retval is directly usable */
-	goto pop_ret;
-
- pop_ret:
-	duk_pop_2_unsafe(thr);
-	DUK_DDD(DUK_DDDPRINT("-> result %ld", (long) ret));
-	return ret;
 }
 
-DUK_LOCAL void duk__array_sort_swap(duk_hthread *thr, duk_int_t l, duk_int_t r) {
-	duk_bool_t have_l, have_r;
-	duk_idx_t idx_obj = 1;  /* fixed offset in valstack */
+/* Sort the permutation 'perm' of 'n' values with 'tmp' as scratch space:
+ * insertion sort short runs, then merge them bottom-up.  A merge is skipped
+ * when its halves are already in order, so sorted input costs n - 1
+ * comparisons.  Only a strictly smaller element moves ahead of another,
+ * which keeps the sort stable.
+ */
+DUK_LOCAL void duk__array_merge_sort(duk__array_sort_state *st, duk_uint32_t *perm, duk_uint32_t *tmp, duk_uint32_t n) {
+	duk_uint32_t *src = perm;
+	duk_uint32_t *dst = tmp;
+	duk_uint32_t width;
+	duk_uint32_t lo, mid, hi;
+	duk_uint32_t i, j, k;
 
-	if (l == r) {
-		return;
+	for (lo = 0; lo < n; lo = hi) {
+		hi = (n - lo > DUK__SORT_RUN ? lo + DUK__SORT_RUN : n);
+		for (i = lo + 1; i < hi; i++) {
+			duk_uint32_t x = perm[i];
+			for (j = i; j > lo && duk__array_sort_compare(st, perm[j - 1], x) > 0; j--) {
+				perm[j] = perm[j - 1];
+			}
+			perm[j] = x;
+		}
 	}
 
-	/* swap elements; deal with non-existent elements correctly */
-	have_l = duk_get_prop_index(thr, idx_obj, (duk_uarridx_t) l);
-	have_r = duk_get_prop_index(thr, idx_obj, (duk_uarridx_t) r);
-
-	if (have_r) {
-		/* right exists, [[Put]] regardless whether or not left exists */
-		duk_put_prop_index(thr, idx_obj, (duk_uarridx_t) l);
-	} else {
-		duk_del_prop_index(thr, idx_obj, (duk_uarridx_t) l);
-		duk_pop_undefined(thr);
-	}
+	for (width = DUK__SORT_RUN; width < n; width *= 2U) {
+		for (lo = 0; lo < n; lo = hi) {
+			mid = (n - lo > width ? lo + width : n);
+			hi = (n - mid > width ? mid + width : n);
 
-	if (have_l) {
-		duk_put_prop_index(thr, idx_obj, (duk_uarridx_t) r);
-	} else {
-		duk_del_prop_index(thr, idx_obj, (duk_uarridx_t) r);
-		duk_pop_undefined(thr);
-	}
-}
+			if (mid == hi || duk__array_sort_compare(st, src[mid - 1], src[mid]) <= 0) {
+				duk_memcpy((void *) (dst + lo), (const void *) (src + lo), (size_t) (hi - lo) * sizeof(duk_uint32_t));
+				continue;
+			}
 
-#if defined(DUK_USE_DEBUG_LEVEL) && (DUK_USE_DEBUG_LEVEL >= 2)
-/* Debug print which visualizes the qsort partitioning process. */
-DUK_LOCAL void duk__debuglog_qsort_state(duk_hthread *thr, duk_int_t lo, duk_int_t hi, duk_int_t pivot) {
-	char buf[4096];
-	char *ptr = buf;
-	duk_int_t i, n;
-	n = (duk_int_t) duk_get_length(thr, 1);
-	if (n > 4000) {
-		n = 4000;
-	}
-	*ptr++ = '[';
-	for (i = 0; i < n; i++) {
-		if (i == pivot) {
-			*ptr++ = '|';
-		} else if (i == lo) {
-			*ptr++ = '<';
-		} else if (i == hi) {
-			*ptr++ = '>';
-		} else if (i >= lo && i <= hi) {
-			*ptr++ = '-';
-		} else {
-			*ptr++ = ' ';
+			i = lo;
+			j = mid;
+			k = lo;
+			while (i < mid && j < hi) {
+				if (duk__array_sort_compare(st, src[j], src[i]) < 0) {
+					dst[k++] = src[j++];
+				} else {
+					dst[k++] = src[i++];
+				}
+			}
+			while (i < mid) {
+				dst[k++] = src[i++];
+			}
+			while (j < hi) {
+				dst[k++] = src[j++];
+			}
 		}
+
+		src = dst;
+		dst = (src == perm ? tmp : perm);
 	}
-	*ptr++ = ']';
-	*ptr++ = '\0';
 
-	DUK_DDD(DUK_DDDPRINT("%s   (lo=%ld, hi=%ld, pivot=%ld)",
-	                     (const char *) buf, (long) lo, (long) hi, (long) pivot));
+	if (src != perm) {
+		duk_memcpy((void *) perm, (const void *) src, (size_t) n * sizeof(duk_uint32_t));
+	}
 }
-#endif
-
-DUK_LOCAL void duk__array_qsort(duk_hthread *thr, duk_int_t lo, duk_int_t hi) {
-	duk_int_t p, l, r;
 
-	/* The lo/hi indices may be crossed and hi < 0 is possible at entry. */
-
-	DUK_DDD(DUK_DDDPRINT("duk__array_qsort: lo=%ld, hi=%ld, obj=%!T",
-	                     (long) lo, (long) hi, (duk_tval *) duk_get_tval(thr, 1)));
+DUK_INTERNAL duk_ret_t duk_bi_array_prototype_sort(duk_hthread *thr) {
+	duk__array_sort_state st;
+	duk_uint32_t len;
+	duk_uint32_t num_vals = 0;
+	duk_uint32_t num_undefined = 0;
+	duk_uint32_t *perm;
+	duk_uint32_t i;
+	duk_tval *tv;
+	duk_bool_t all_strings = 1;
+	duk_bool_t all_ints = 1;
+	duk_bool_t any_objects = 0;
+	duk_bool_t collected = 0;
+#if defined(DUK_USE_ARRAY_FASTPATH)
+	duk_harray *h_arr;
+#endif
 
-	DUK_ASSERT_TOP(thr, 3);
+	len = duk__push_this_obj_len_u32_limited(thr);
 
-	/* In some cases it may be that lo > hi, or hi < 0; these
-	 * degenerate cases happen e.g. for empty arrays, and in
-	 * recursion leaves.
+	/* stack[0] = compareFn
+	 * stack[1] = ToObject(this)
+	 * stack[2] = ToUint32(length)
 	 */
 
-	/* trivial cases */
-	if (hi - lo < 1) {
-		DUK_DDD(DUK_DDDPRINT("degenerate case, return immediately"));
-		return;
-	}
-	DUK_ASSERT(hi > lo);
-	DUK_ASSERT(hi - lo + 1 >= 2);
-
-	/* randomized pivot selection */
-	p = lo + (duk_int_t) (DUK_UTIL_GET_RANDOM_DOUBLE(thr) * (duk_double_t) (hi - lo + 1));
-	DUK_ASSERT(p >= lo && p <= hi);
-	DUK_DDD(DUK_DDDPRINT("lo=%ld, hi=%ld, chose pivot p=%ld", (long) lo, (long) hi, (long) p));
-
-	/* move pivot out of the way */
-	duk__array_sort_swap(thr, p, lo);
-	p = lo;
-	DUK_DDD(DUK_DDDPRINT("pivot moved out of the way: %!T", (duk_tval *) duk_get_tval(thr, 1)));
+	/* Collect the values.  Holes must be looked up from the prototype
+	 * chain, so only arrays without them are copied directly.
+	 */
+#if defined(DUK_USE_ARRAY_FASTPATH)
+	h_arr = duk__arraypart_fastpath_this(thr);
+	if (h_arr != NULL && len <= h_arr->length) {
+		duk_tval *tv_src = DUK_HOBJECT_A_GET_BASE(thr->heap, (duk_hobject *) h_arr);
 
-	l = lo + 1;
-	r = hi;
-	for (;;) {
-		/* find elements to swap */
-		for (;;) {
-			DUK_DDD(DUK_DDDPRINT("left scan: l=%ld, r=%ld, p=%ld",
-			                     (long) l, (long) r, (long) p));
-			if (l >= hi) {
+		for (i = 0; i < len; i++) {
+			if (DUK_TVAL_IS_UNUSED(tv_src + i)) {
 				break;
 			}
-			if (duk__array_sort_compare(thr, l, p) >= 0) {  /* !(l < p) */
-				break;
+		}
+		if (i == len) {
+			st.h_vals = duk_push_harray_with_size(thr, len);
+			tv = DUK_HOBJECT_A_GET_BASE(thr->heap, (duk_hobject *) st.h_vals);
+			tv_src = DUK_HOBJECT_A_GET_BASE(thr->heap, (duk_hobject *) h_arr);
+			for (i = 0; i < len; i++) {
+				if (DUK_TVAL_IS_UNDEFINED(tv_src + i)) {
+					num_undefined++;
+				} else {
+					DUK_TVAL_SET_TVAL(tv + num_vals, tv_src + i);
+					DUK_TVAL_INCREF(thr, tv + num_vals);
+					num_vals++;
+				}
 			}
-			l++;
+			collected = 1;
 		}
-		for (;;) {
-			DUK_DDD(DUK_DDDPRINT("right scan: l=%ld, r=%ld, p=%ld",
-			                     (long) l, (long) r, (long) p));
-			if (r <= lo) {
+	}
+#endif
+	if (!collected) {
+		st.h_vals = duk_push_harray(thr);
+		for (i = 0; i < len; i++) {
+			if (duk_get_prop_index(thr, DUK__SORT_IDX_OBJ, (duk_uarridx_t) i)) {
+				if (duk_is_undefined(thr, -1)) {
+					num_undefined++;
+				} else {
+					duk_put_prop_index(thr, DUK__SORT_IDX_VALS, (duk_uarridx_t) num_vals++);
+					continue;
+				}
+			}
+			duk_pop_unsafe(thr);
+		}
+	}
+	DUK_ASSERT_TOP(thr, DUK__SORT_IDX_VALS + 1);
+	st.thr = thr;
+	st.h_keys = st.h_vals;
+	st.ints = NULL;
+
+	/* Choose how to compare. */
+	tv = DUK_HOBJECT_A_GET_BASE(thr->heap, (duk_hobject *) st.h_vals);
+	for (i = 0; i < num_vals; i++) {
+		if (DUK_TVAL_IS_STRING(tv + i)) {
+			if (DUK_UNLIKELY(DUK_HSTRING_HAS_SYMBOL(DUK_TVAL_GET_STRING(tv + i)))) {
+				/* ToString() throws for symbols, so leave that to the comparisons. */
+				any_objects = 1;
 				break;
 			}
-			if (duk__array_sort_compare(thr, p, r) >= 0) {  /* !(p < r) */
+			all_ints = 0;
+		} else {
+			all_strings = 0;
+			if (DUK_TVAL_IS_OBJECT(tv + i) || DUK_TVAL_IS_BUFFER(tv + i) || DUK_TVAL_IS_LIGHTFUNC(tv + i)) {
+				/* Buffers and lightfuncs coerce through their prototypes. */
+				any_objects = 1;
 				break;
 			}
-			r--;
-		}
-		if (l >= r) {
-			goto done;
+			if (all_ints) {
+				duk_int32_t ival;
+				all_ints = DUK_TVAL_IS_NUMBER(tv + i) && duk_is_whole_get_int32(DUK_TVAL_GET_NUMBER(tv + i), &ival);
+			}
 		}
-		DUK_ASSERT(l < r);
-
-		DUK_DDD(DUK_DDDPRINT("swap %ld and %ld", (long) l, (long) r));
+	}
 
-		duk__array_sort_swap(thr, l, r);
+	if (!duk_is_undefined(thr, DUK__SORT_IDX_FN)) {
+		st.key_type = DUK__SORT_KEY_COMPAREFN;
+	} else if (any_objects) {
+		st.key_type = DUK__SORT_KEY_TOSTRING;
+	} else if (all_strings) {
+		st.key_type = DUK__SORT_KEY_STRING;
+	} else if (all_ints) {
+		st.key_type = DUK__SORT_KEY_INT;
+		st.ints = (duk_int32_t *) duk_push_fixed_buffer_nozero(thr, (duk_size_t) num_vals * sizeof(duk_int32_t));
+		tv = DUK_HOBJECT_A_GET_BASE(thr->heap, (duk_hobject *) st.h_vals);
+		for (i = 0; i < num_vals; i++) {
+			(void) duk_is_whole_get_int32(DUK_TVAL_GET_NUMBER(tv + i), st.ints + i);
+		}
+	} else {
+		st.key_type = DUK__SORT_KEY_STRING;
+		st.h_keys = duk_push_harray_with_size(thr, 0);
+		for (i = 0; i < num_vals; i++) {
+			tv = DUK_HOBJECT_A_GET_BASE(thr->heap, (duk_hobject *) st.h_vals);
+			duk_push_tval(thr, tv + i);
+			(void) duk_to_hstring_m1(thr);
+			duk_put_prop_index(thr, -2, (duk_uarridx_t) i);
+		}
+	}
 
-		DUK_DDD(DUK_DDDPRINT("after swap: %!T", (duk_tval *) duk_get_tval(thr, 1)));
-		l++;
-		r--;
+	/* Sort the permutation; the second half is scratch space. */
+	perm = (duk_uint32_t *) duk_push_fixed_buffer_nozero(thr, (duk_size_t) num_vals * 2U * sizeof(duk_uint32_t));
+	for (i = 0; i < num_vals; i++) {
+		perm[i] = i;
 	}
- done:
-	/* Note that 'l' and 'r' may cross, i.e. r < l */
-	DUK_ASSERT(l >= lo && l <= hi);
-	DUK_ASSERT(r >= lo && r <= hi);
+	duk__array_merge_sort(&st, perm, perm + num_vals, num_vals);
 
-	/* XXX: there's no explicit recursion bound here now.  For the average
-	 * qsort recursion depth O(log n) that's not really necessary: e.g. for
-	 * 2**32 recursion depth would be about 32 which is OK.  However, qsort
-	 * worst case recursion depth is O(n) which may be a problem.
+	/* Write back.  The comparefn may have changed the array, so check
+	 * again whether it can be written directly.
 	 */
+#if defined(DUK_USE_ARRAY_FASTPATH)
+	h_arr = duk__arraypart_fastpath_this(thr);
+	if (h_arr != NULL && num_vals + num_undefined == len && len <= h_arr->length) {
+		duk_tval *tv_dst = DUK_HOBJECT_A_GET_BASE(thr->heap, (duk_hobject *) h_arr);
 
-	/* move pivot to its final place */
-	DUK_DDD(DUK_DDDPRINT("before final pivot swap: %!T", (duk_tval *) duk_get_tval(thr, 1)));
-	duk__array_sort_swap(thr, lo, r);
-
-#if defined(DUK_USE_DEBUG_LEVEL) && (DUK_USE_DEBUG_LEVEL >= 2)
-	duk__debuglog_qsort_state(thr, lo, hi, r);
+		tv = DUK_HOBJECT_A_GET_BASE(thr->heap, (duk_hobject *) st.h_vals);
+		for (i = 0; i < num_vals; i++) {
+			DUK_TVAL_SET_TVAL_UPDREF_NORZ(thr, tv_dst + i, tv + perm[i]);
+		}
+		for (; i < len; i++) {
+			DUK_TVAL_SET_UNDEFINED_UPDREF_NORZ(thr, tv_dst + i);
+		}
+		DUK_REFZERO_CHECK_SLOW(thr);
+	} else
 #endif
-
-	DUK_DDD(DUK_DDDPRINT("recurse: pivot=%ld, obj=%!T", (long) r, (duk_tval *) duk_get_tval(thr, 1)));
-	duk__array_qsort(thr, lo, r - 1);
-	duk__array_qsort(thr, r + 1, hi);
-}
-
-DUK_INTERNAL duk_ret_t duk_bi_array_prototype_sort(duk_hthread *thr) {
-	duk_uint32_t len;
-
-	/* XXX: len >= 0x80000000 won't work below because a signed type
-	 * is needed by qsort.
-	 */
-	len = duk__push_this_obj_len_u32_limited(thr);
-
-	/* stack[0] = compareFn
-	 * stack[1] = ToObject(this)
-	 * stack[2] = ToUint32(length)
-	 */
-
-	if (len > 0) {
-		/* avoid degenerate cases, so that (len - 1) won't underflow */
-		duk__array_qsort(thr, (duk_int_t) 0, (duk_int_t) (len - 1));
+	{
+		for (i = 0; i < num_vals; i++) {
+			tv = DUK_HOBJECT_A_GET_BASE(thr->heap, (duk_hobject *) st.h_vals);
+			duk_push_tval(thr, tv + perm[i]);
+			duk_put_prop_index(thr, DUK__SORT_IDX_OBJ, (duk_uarridx_t) i);
+		}
+		for (; i < num_vals + num_undefined; i++) {
+			duk_push_undefined(thr);
+			duk_put_prop_index(thr, DUK__SORT_IDX_OBJ, (duk_uarridx_t) i);
+		}
+		for (; i < len; i++) {
+			duk_del_prop_index(thr, DUK__SORT_IDX_OBJ, (duk_uarridx_t) i);
+		}
 	}
 
-	DUK_ASSERT_TOP(thr, 3);
-	duk_pop_nodecref_unsafe(thr);
+	duk_set_top(thr, DUK__SORT_IDX_OBJ + 1);
 	return 1;  /* return ToObject(this) */
 }
 
@@ -26786,7 +27143,7 @@ DUK_INTERNAL duk_ret_t duk_bi_boolean_constructor(duk_hthread *thr) {
 		h_this = duk_known_hobject(thr, -1);
 		DUK_ASSERT(DUK_HOBJECT_GET_PROTOTYPE(thr->heap, h_this) == thr->builtins[DUK_BIDX_BOOLEAN_PROTOTYPE]);
 
-		DUK_HOBJECT_SET_CLASS_NUMBER(h_this, DUK_HOBJECT_CLASS_BOOLEAN);
+		duk_heap_hobject_set_class(thr->heap, h_this, DUK_HOBJECT_CLASS_BOOLEAN);
 
 		duk_dup_0(thr);  /* -> [ val obj val ] */
 		duk_xdef_prop_stridx_short(thr, -2, DUK_STRIDX_INT_VALUE, DUK_PROPDESC_FLAGS_NONE);  /* XXX: proper flags? */
@@ -27327,6 +27684,170 @@ DUK_INTERNAL void duk_hbufobj_validated_write(duk_hthread *thr, duk_hbufobj *h_b
 	duk_memcpy((void *) p, (const void *) du.uc, (size_t) elem_size);
 }
 
+#if !defined(DUK_USE_PREFER_SIZE)
+/* Element conversion helpers for copies between views which aren't byte
+ * copy compatible, and from dense arrays of numbers.  Elements go through
+ * a small buffer of doubles a chunk at a time, which represents every
+ * element type exactly; each loop then handles a single element type so
+ * that compilers can vectorize it, and nothing touches the value stack.
+ */
+#define DUK__CONVERT_CHUNK  64
+
+#define DUK__LOAD_DOUBLES(ctype)  do { \
+		for (i = 0; i < n; i++) { \
+			ctype duk__v; \
+			duk_memcpy((void *) &duk__v, (const void *) (p_src + i * sizeof(ctype)), sizeof(ctype)); \
+			out[i] = (duk_double_t) duk__v; \
+		} \
+	} while (0)
+
+#define DUK__STORE_DOUBLES(ctype,expr)  do { \
+		for (i = 0; i < n; i++) { \
+			duk_double_t d = in[i]; \
+			ctype duk__v = (ctype) (expr); \
+			duk_memcpy((void *) (p_dst + i * sizeof(ctype)), (const void *) &duk__v, sizeof(ctype)); \
+		} \
+	} while (0)
+
+DUK_LOCAL void duk__hbufobj_load_doubles(duk_double_t *out, const duk_uint8_t *p_src, duk_small_uint_t elem_type, duk_uint_t n) {
+	duk_uint_t i;
+
+	switch (elem_type) {
+	case DUK_HBUFOBJ_ELEM_UINT8:
+	case DUK_HBUFOBJ_ELEM_UINT8CLAMPED:
+		DUK__LOAD_DOUBLES(duk_uint8_t);
+		break;
+	case DUK_HBUFOBJ_ELEM_INT8:
+		DUK__LOAD_DOUBLES(duk_int8_t);
+		break;
+	case DUK_HBUFOBJ_ELEM_UINT16:
+		DUK__LOAD_DOUBLES(duk_uint16_t);
+		break;
+	case DUK_HBUFOBJ_ELEM_INT16:
+		DUK__LOAD_DOUBLES(duk_int16_t);
+		break;
+	case DUK_HBUFOBJ_ELEM_UINT32:
+		DUK__LOAD_DOUBLES(duk_uint32_t);
+		break;
+	case DUK_HBUFOBJ_ELEM_INT32:
+		DUK__LOAD_DOUBLES(duk_int32_t);
+		break;
+	case DUK_HBUFOBJ_ELEM_FLOAT32:
+		DUK__LOAD_DOUBLES(duk_float_t);
+		break;
+	case DUK_HBUFOBJ_ELEM_FLOAT64:
+		DUK__LOAD_DOUBLES(duk_double_t);
+		break;
+	default:
+		DUK_UNREACHABLE();
+	}
+}
+
+/* ToUint32() of a number; integer element types keep its low bits, which
+ * matches ToInt8(), ToUint16() etc.
+ */
+DUK_LOCAL DUK_ALWAYS_INLINE duk_uint32_t duk__hbufobj_double_to_uint32(duk_hthread *thr, duk_double_t d) {
+	duk_tval tv;
+
+	if (DUK_LIKELY(d >= -2147483648.0 && d < 4294967296.0)) {
+		/* Casts truncate towards zero, like ToUint32(). */
+		return (d < 0.0 ? (duk_uint32_t) (duk_int32_t) d : (duk_uint32_t) d);
+	}
+	DUK_TVAL_SET_NUMBER(&tv, d);
+	return duk_js_touint32(thr, &tv);  /* NaN, infinities and large values, no side effects */
+}
+
+DUK_LOCAL void duk__hbufobj_store_doubles(duk_hthread *thr, duk_uint8_t *p_dst, duk_small_uint_t elem_type, const duk_double_t *in, duk_uint_t n) {
+	duk_uint_t i;
+
+	switch (elem_type) {
+	case DUK_HBUFOBJ_ELEM_UINT8:
+	case DUK_HBUFOBJ_ELEM_INT8:
+		DUK__STORE_DOUBLES(duk_uint8_t, duk__hbufobj_double_to_uint32(thr, d));
+		break;
+	case DUK_HBUFOBJ_ELEM_UINT8CLAMPED:
+		DUK__STORE_DOUBLES(duk_uint8_t, duk_double_to_uint8clamped(d));
+		break;
+	case DUK_HBUFOBJ_ELEM_UINT16:
+	case DUK_HBUFOBJ_ELEM_INT16:
+		DUK__STORE_DOUBLES(duk_uint16_t, duk__hbufobj_double_to_uint32(thr, d));
+		break;
+	case DUK_HBUFOBJ_ELEM_UINT32:
+	case DUK_HBUFOBJ_ELEM_INT32:
+		DUK__STORE_DOUBLES(duk_uint32_t, duk__hbufobj_double_to_uint32(thr, d));
+		break;
+	case DUK_HBUFOBJ_ELEM_FLOAT32:
+		DUK__STORE_DOUBLES(duk_float_t, duk_double_to_float_t(d));
+		break;
+	case DUK_HBUFOBJ_ELEM_FLOAT64:
+		DUK__STORE_DOUBLES(duk_double_t, d);
+		break;
+	default:
+		DUK_UNREACHABLE();
+	}
+}
+
+/* Convert 'count' elements from 'h_src' to 'h_dst' element type.  The
+ * areas must not overlap; the caller must have validated both.
+ */
+DUK_LOCAL void duk__hbufobj_convert_elems(duk_hthread *thr, duk_hbufobj *h_dst, duk_uint8_t *p_dst, duk_hbufobj *h_src, const duk_uint8_t *p_src, duk_uint_t count) {
+	duk_double_t tmp[DUK__CONVERT_CHUNK];
+	duk_small_uint_t dst_elem_size = (duk_small_uint_t) (1U << h_dst->shift);
+	duk_small_uint_t src_elem_size = (duk_small_uint_t) (1U << h_src->shift);
+	duk_uint_t n;
+
+	while (count > 0) {
+		n = (count < DUK__CONVERT_CHUNK ? count : DUK__CONVERT_CHUNK);
+		duk__hbufobj_load_doubles(tmp, p_src, h_src->elem_type, n);
+		duk__hbufobj_store_doubles(thr, p_dst, h_dst->elem_type, tmp, n);
+		p_src += n * src_elem_size;
+		p_dst += n * dst_elem_size;
+		count -= n;
+	}
+}
+
+/* Copy 'count' elements from a dense array of numbers, such as the argument
+ * of new Float32Array([ ... ]), without property reads.  Returns 0 if the
+ * array doesn't qualify, and the caller must then use index reads and
+ * writes instead.  The caller must have validated the target.
+ */
+DUK_LOCAL duk_bool_t duk__hbufobj_convert_from_array(duk_hthread *thr, duk_hbufobj *h_dst, duk_uint8_t *p_dst, duk_hobject *h_src, duk_uint_t count) {
+	duk_double_t tmp[DUK__CONVERT_CHUNK];
+	duk_small_uint_t dst_elem_size = (duk_small_uint_t) (1U << h_dst->shift);
+	duk_tval *tv_src;
+	duk_uint_t i, n;
+
+	if (!DUK_HOBJECT_IS_ARRAY(h_src) ||
+	    !DUK_HOBJECT_HAS_ARRAY_PART(h_src) ||
+	    count > ((duk_harray *) h_src)->length ||
+	    count > DUK_HOBJECT_GET_ASIZE(h_src)) {
+		return 0;
+	}
+
+	/* Holes and non-numbers would need lookups or coercions with side
+	 * effects, so check everything before writing anything.
+	 */
+	tv_src = DUK_HOBJECT_A_GET_BASE(thr->heap, h_src);
+	for (i = 0; i < count; i++) {
+		if (!DUK_TVAL_IS_NUMBER(tv_src + i)) {
+			return 0;
+		}
+	}
+
+	while (count > 0) {
+		n = (count < DUK__CONVERT_CHUNK ? count : DUK__CONVERT_CHUNK);
+		for (i = 0; i < n; i++) {
+			tmp[i] = DUK_TVAL_GET_NUMBER(tv_src + i);
+		}
+		duk__hbufobj_store_doubles(thr, p_dst, h_dst->elem_type, tmp, n);
+		tv_src += n;
+		p_dst += n * dst_elem_size;
+		count -= n;
+	}
+	return 1;
+}
+#endif  /* !DUK_USE_PREFER_SIZE */
+
 /* Helper to create a fixed buffer from argument value at index 0.
  * Node.js and allocPlain() compatible.
  */
@@ -27757,12 +28278,9 @@ DUK_INTERNAL duk_ret_t duk_bi_typedarray_constructor(duk_hthread *thr) {
 		break;
 	}
 	case 1: {
-		/* Copy values through direct validated reads and writes. */
+		/* Convert values directly between the element types. */
 
-		duk_small_uint_t src_elem_size;
-		duk_small_uint_t dst_elem_size;
 		duk_uint8_t *p_src;
-		duk_uint8_t *p_src_end;
 		duk_uint8_t *p_dst;
 
 		DUK_ASSERT(h_bufobj != NULL);
@@ -27772,31 +28290,13 @@ DUK_INTERNAL duk_ret_t duk_bi_typedarray_constructor(duk_hthread *thr) {
 		DUK_ASSERT(h_bufarg->buf != NULL);
 		DUK_ASSERT(DUK_HBUFOBJ_VALID_SLICE(h_bufarg));
 
-		src_elem_size = (duk_small_uint_t) (1U << h_bufarg->shift);
-		dst_elem_size = elem_size;
-
 		p_src = DUK_HBUFOBJ_GET_SLICE_BASE(thr->heap, h_bufarg);
 		p_dst = DUK_HBUFOBJ_GET_SLICE_BASE(thr->heap, h_bufobj);
-		p_src_end = p_src + h_bufarg->length;
 
-		DUK_DDD(DUK_DDDPRINT("using fast copy: p_src=%p, p_src_end=%p, p_dst=%p, "
-		                     "src_elem_size=%d, dst_elem_size=%d",
-		                     (void *) p_src, (void *) p_src_end, (void *) p_dst,
-		                     (int) src_elem_size, (int) dst_elem_size));
+		DUK_DDD(DUK_DDDPRINT("using fast copy: p_src=%p, p_dst=%p, elem_length=%ld",
+		                     (void *) p_src, (void *) p_dst, (long) elem_length));
 
-		while (p_src != p_src_end) {
-			DUK_DDD(DUK_DDDPRINT("fast path per element copy loop: "
-			                     "p_src=%p, p_src_end=%p, p_dst=%p",
-			                     (void *) p_src, (void *) p_src_end, (void *) p_dst));
-			/* A validated read() is always a number, so it's write coercion
-			 * is always side effect free an won't invalidate pointers etc.
-			 */
-			duk_hbufobj_push_validated_read(thr, h_bufarg, p_src, src_elem_size);
-			duk_hbufobj_validated_write(thr, h_bufobj, p_dst, dst_elem_size);
-			duk_pop(thr);
-			p_src += src_elem_size;
-			p_dst += dst_elem_size;
-		}
+		duk__hbufobj_convert_elems(thr, h_bufobj, p_dst, h_bufarg, p_src, elem_length);
 		break;
 	}
 #endif  /* !DUK_USE_PREFER_SIZE */
@@ -27806,6 +28306,15 @@ DUK_INTERNAL duk_ret_t duk_bi_typedarray_constructor(duk_hthread *thr) {
 		 */
 		duk_uint_t i;
 
+#if !defined(DUK_USE_PREFER_SIZE)
+		/* Dense arrays of numbers don't need the property code. */
+		DUK_ASSERT(DUK_HBUFOBJ_VALID_SLICE(h_bufobj));
+		if (duk__hbufobj_convert_from_array(thr, h_bufobj, DUK_HBUFOBJ_GET_SLICE_BASE(thr->heap, h_bufobj), duk_require_hobject(thr, 0), elem_length)) {
+			DUK_DDD(DUK_DDDPRINT("using array copy"));
+			break;
+		}
+#endif
+
 		DUK_DDD(DUK_DDDPRINT("using slow copy"));
 
 		for (i = 0; i < elem_length; i++) {
@@ -28448,12 +28957,14 @@ DUK_INTERNAL duk_ret_t duk_bi_typedarray_set(duk_hthread *thr) {
 		duk_uint_t dst_length;
 		duk_uint_t dst_length_elems;
 		duk_uint8_t *p_src_base;
+		duk_uint8_t *p_dst_base;
+#if defined(DUK_USE_PREFER_SIZE)
 		duk_uint8_t *p_src_end;
 		duk_uint8_t *p_src;
-		duk_uint8_t *p_dst_base;
 		duk_uint8_t *p_dst;
 		duk_small_uint_t src_elem_size;
 		duk_small_uint_t dst_elem_size;
+#endif
 
 		h_bufarg = (duk_hbufobj *) h_obj;
 		DUK_HBUFOBJ_ASSERT_VALID(h_bufarg);
@@ -28581,10 +29092,14 @@ DUK_INTERNAL duk_ret_t duk_bi_typedarray_set(duk_hthread *thr) {
 		 * and must avoid any side effects that might cause the buffer
 		 * validity check above to become invalid.
 		 *
-		 * Although we work through the value stack here, only plain
-		 * numbers are handled which should be side effect safe.
+		 * The element conversions are side effect free.  The size
+		 * optimized variant works through the value stack, but only
+		 * plain numbers are handled which should be side effect safe.
 		 */
 
+#if !defined(DUK_USE_PREFER_SIZE)
+		duk__hbufobj_convert_elems(thr, h_this, p_dst_base, h_bufarg, p_src_base, dst_length_elems);
+#else
 		src_elem_size = (duk_small_uint_t) (1U << h_bufarg->shift);
 		dst_elem_size = (duk_small_uint_t) (1U << h_this->shift);
 		p_src = p_src_base;
@@ -28604,6 +29119,7 @@ DUK_INTERNAL duk_ret_t duk_bi_typedarray_set(duk_hthread *thr) {
 			p_src += src_elem_size;
 			p_dst += dst_elem_size;
 		}
+#endif  /* !DUK_USE_PREFER_SIZE */
 
 		return 0;
 	} else {
@@ -28633,6 +29149,16 @@ DUK_INTERNAL duk_ret_t duk_bi_typedarray_set(duk_hthread *thr) {
 		 * the results anyway.
 		 */
 
+#if !defined(DUK_USE_PREFER_SIZE)
+		/* Dense arrays of numbers can be written directly, after
+		 * checking the target now that the length has been read.
+		 */
+		if (DUK_HBUFOBJ_VALID_BYTEOFFSET_EXCL(h_this, offset_bytes + (n << h_this->shift)) &&
+		    duk__hbufobj_convert_from_array(thr, h_this, DUK_HBUFOBJ_GET_SLICE_BASE(thr->heap, h_this) + offset_bytes, h_obj, (duk_uint_t) n)) {
+			return 0;
+		}
+#endif
+
 		DUK_ASSERT_TOP(thr, 2);
 		duk_push_this(thr);
 
@@ -32511,6 +33037,25 @@ DUK_LOCAL duk_ret_t duk__decode_helper(duk_hthread *thr, duk__decode_context *de
 	in = input;
 	out = output;
 	while (in < input + len) {
+#if !defined(DUK_USE_PREFER_SIZE)
+		if (dec_ctx->needed == 0 && *in <= 0x7fU) {
+			/* Fast path for a run of ASCII outside a multibyte
+			 * sequence: copy it as is.  An ASCII codepoint can't
+			 * be a BOM, so the BOM check is settled as well.
+			 */
+			duk_size_t run;
+
+			run = duk_unicode_ascii_prefix_length(in, (duk_size_t) (input + len - in));
+			DUK_ASSERT(run >= 1);
+			duk_memcpy((void *) out, (const void *) in, run);
+			in += run;
+			out += run;
+			dec_ctx->bom_handled = 1;
+			DUK_ASSERT(out <= output + (3 + (3 * len)));
+			continue;
+		}
+#endif
+
 		codepoint = duk__utf8_decode_next(dec_ctx, *in++);
 		if (codepoint < 0) {
 			if (codepoint == DUK__CP_CONTINUE) {
@@ -32588,16 +33133,16 @@ DUK_INTERNAL duk_ret_t duk_bi_textencoder_prototype_encoding_getter(duk_hthread
 
 DUK_INTERNAL duk_ret_t duk_bi_textencoder_prototype_encode(duk_hthread *thr) {
 	duk__encode_context enc_ctx;
+	duk_hstring *h_input;
 	duk_size_t len;
 	duk_size_t final_len;
 	duk_uint8_t *output;
 
 	DUK_ASSERT_TOP(thr, 1);
 	if (duk_is_undefined(thr, 0)) {
+		h_input = NULL;
 		len = 0;
 	} else {
-		duk_hstring *h_input;
-
 		h_input = duk_to_hstring(thr, 0);
 		DUK_ASSERT(h_input != NULL);
 
@@ -32637,7 +33182,21 @@ DUK_INTERNAL duk_ret_t duk_bi_textencoder_prototype_encode(duk_hthread *thr) {
 		 */
 		enc_ctx.lead = 0x0000L;
 		enc_ctx.out = output;
+#if !defined(DUK_USE_PREFER_SIZE)
+		DUK_ASSERT(h_input != NULL);
+		if (duk_unicode_ascii_prefix_length(DUK_HSTRING_GET_DATA(h_input), DUK_HSTRING_GET_BYTELEN(h_input)) == DUK_HSTRING_GET_BYTELEN(h_input)) {
+			/* Fast path for pure ASCII, whose UTF-8 encoding is the
+			 * string data itself.
+			 */
+			DUK_ASSERT(DUK_HSTRING_GET_BYTELEN(h_input) == len);
+			duk_memcpy((void *) output, (const void *) DUK_HSTRING_GET_DATA(h_input), len);
+			enc_ctx.out += len;
+		} else {
+			duk_decode_string(thr, 0, duk__utf8_encode_char, (void *) &enc_ctx);
+		}
+#else
 		duk_decode_string(thr, 0, duk__utf8_encode_char, (void *) &enc_ctx);
+#endif
 		if (enc_ctx.lead != 0x0000L) {
 			/* unpaired high surrogate at end of string */
 			enc_ctx.out = duk__utf8_emit_repl(enc_ctx.out);
@@ -38207,7 +38766,7 @@ DUK_INTERNAL duk_ret_t duk_bi_number_constructor(duk_hthread *thr) {
 	/* XXX: helper */
 	duk_push_this(thr);
 	h_this = duk_known_hobject(thr, -1);
-	DUK_HOBJECT_SET_CLASS_NUMBER(h_this, DUK_HOBJECT_CLASS_NUMBER);
+	duk_heap_hobject_set_class(thr->heap, h_this, DUK_HOBJECT_CLASS_NUMBER);
 
 	DUK_ASSERT(DUK_HOBJECT_GET_PROTOTYPE(thr->heap, h_this) == thr->builtins[DUK_BIDX_NUMBER_PROTOTYPE]);
 	DUK_ASSERT(DUK_HOBJECT_GET_CLASS_NUMBER(h_this) == DUK_HOBJECT_CLASS_NUMBER);
@@ -39851,11 +40410,24 @@ DUK_LOCAL duk_int_t duk__str_search_shared(duk_hthread *thr, duk_hstring *h_this
 	p_end = p_start + DUK_HSTRING_GET_BYTELEN(h_this);
 	p = p_start + bpos;
 
-	/* This loop is optimized for size.  For speed, there should be
-	 * two separate loops, and we should ensure that memcmp() can be
-	 * used without an extra "will searchstring fit" check.  Doing
-	 * the preconditioning for 'p' and 'p_end' is easy but cpos
-	 * must be updated if 'p' is wound back (backward scanning).
+	if (!backwards) {
+		/* Find the match first and only then count the characters
+		 * leading to it.
+		 */
+		const duk_uint8_t *p_match;
+
+		p_match = duk_memmem(p, (duk_size_t) (p_end - p), q_start, (duk_size_t) q_blen);
+		if (p_match == NULL) {
+			return -1;
+		}
+		return cpos + (duk_int_t) duk_unicode_unvalidated_utf8_length(p, (duk_size_t) (p_match - p));
+	}
+
+	/* Backwards search.  This loop is optimized for size; for speed,
+	 * we should ensure that memcmp() can be used without an extra
+	 * "will searchstring fit" check.  Doing the preconditioning for
+	 * 'p' and 'p_end' is easy but cpos must be updated if 'p' is
+	 * wound back.
 	 */
 
 	firstbyte = q_start[0];  /* leading byte of match string */
@@ -39874,23 +40446,15 @@ DUK_LOCAL duk_int_t duk__str_search_shared(duk_hthread *thr, duk_hstring *h_this
 			}
 		}
 
-		/* track cpos while scanning */
-		if (backwards) {
-			/* when going backwards, we decrement cpos 'early';
-			 * 'p' may point to a continuation byte of the char
-			 * at offset 'cpos', but that's OK because we'll
-			 * backtrack all the way to the initial byte.
-			 */
-			if ((t & 0xc0) != 0x80) {
-				cpos--;
-			}
-			p--;
-		} else {
-			if ((t & 0xc0) != 0x80) {
-				cpos++;
-			}
-			p++;
+		/* Track cpos while scanning.  We decrement cpos 'early';
+		 * 'p' may point to a continuation byte of the char at
+		 * offset 'cpos', but that's OK because we'll backtrack
+		 * all the way to the initial byte.
+		 */
+		if ((t & 0xc0) != 0x80) {
+			cpos--;
 		}
+		p--;
 	}
 
 	/* Not found.  Empty string case is handled specially above. */
@@ -40449,48 +41013,38 @@ DUK_INTERNAL duk_ret_t duk_bi_string_prototype_replace(duk_hthread *thr) {
 #else  /* DUK_USE_REGEXP_SUPPORT */
 		{  /* unconditionally */
 #endif  /* DUK_USE_REGEXP_SUPPORT */
-			const duk_uint8_t *p_start, *p_end, *p;   /* input string scan */
-			const duk_uint8_t *q_start;               /* match string */
-			duk_size_t q_blen;
+			const duk_uint8_t *p_start, *p;   /* input string scan */
+			const duk_uint8_t *q_start;       /* match string */
+			duk_size_t p_len, q_blen;
 
 #if defined(DUK_USE_REGEXP_SUPPORT)
 			DUK_ASSERT(!is_global);  /* single match always */
 #endif
 
 			p_start = DUK_HSTRING_GET_DATA(h_input);
-			p_end = p_start + DUK_HSTRING_GET_BYTELEN(h_input);
-			p = p_start;
+			p_len = (duk_size_t) DUK_HSTRING_GET_BYTELEN(h_input);
 
 			h_search = duk_known_hstring(thr, 0);
 			q_start = DUK_HSTRING_GET_DATA(h_search);
 			q_blen = (duk_size_t) DUK_HSTRING_GET_BYTELEN(h_search);
 
-			p_end -= q_blen;  /* ensure full memcmp() fits in while */
-
-			match_start_coff = 0;
-
-			while (p <= p_end) {
-				DUK_ASSERT(p + q_blen <= DUK_HSTRING_GET_DATA(h_input) + DUK_HSTRING_GET_BYTELEN(h_input));
-				if (duk_memcmp((const void *) p, (const void *) q_start, (size_t) q_blen) == 0) {
-					duk_dup_0(thr);
-					h_match = duk_known_hstring(thr, -1);
-#if defined(DUK_USE_REGEXP_SUPPORT)
-					match_caps = 0;
-#endif
-					goto found;
-				}
-
-				/* track utf-8 non-continuation bytes */
-				if ((p[0] & 0xc0) != 0x80) {
-					match_start_coff++;
+			if (q_blen == 0) {
+				p = p_start;  /* empty search string matches at the start */
+			} else {
+				p = duk_memmem(p_start, p_len, q_start, q_blen);
+				if (p == NULL) {
+					/* not found */
+					break;
 				}
-				p++;
 			}
 
-			/* not found */
-			break;
+			match_start_coff = (duk_uint32_t) duk_unicode_unvalidated_utf8_length(p_start, (duk_size_t) (p - p_start));
+			duk_dup_0(thr);
+			h_match = duk_known_hstring(thr, -1);
+#if defined(DUK_USE_REGEXP_SUPPORT)
+			match_caps = 0;
+#endif
 		}
-	 found:
 
 		/* stack[0] = search value
 		 * stack[1] = replace value
@@ -40810,6 +41364,7 @@ DUK_INTERNAL duk_ret_t duk_bi_string_prototype_split(duk_hthread *thr) {
 		{  /* unconditionally */
 #endif  /* DUK_USE_REGEXP_SUPPORT */
 			const duk_uint8_t *p_start, *p_end, *p;   /* input string scan */
+			const duk_uint8_t *p_match;
 			const duk_uint8_t *q_start;               /* match string */
 			duk_size_t q_blen, q_clen;
 
@@ -40822,8 +41377,6 @@ DUK_INTERNAL duk_ret_t duk_bi_string_prototype_split(duk_hthread *thr) {
 			q_blen = (duk_size_t) DUK_HSTRING_GET_BYTELEN(h_sep);
 			q_clen = (duk_size_t) DUK_HSTRING_GET_CHARLEN(h_sep);
 
-			p_end -= q_blen;  /* ensure full memcmp() fits in while */
-
 			match_start_coff = prev_match_end_coff;
 
 			if (q_blen == 0) {
@@ -40849,19 +41402,12 @@ DUK_INTERNAL duk_ret_t duk_bi_string_prototype_split(duk_hthread *thr) {
 			}
 
 			DUK_ASSERT(q_blen > 0 && q_clen > 0);
-			while (p <= p_end) {
-				DUK_ASSERT(p + q_blen <= DUK_HSTRING_GET_DATA(h_input) + DUK_HSTRING_GET_BYTELEN(h_input));
-				DUK_ASSERT(q_blen > 0);  /* no issues with empty memcmp() */
-				if (duk_memcmp((const void *) p, (const void *) q_start, (size_t) q_blen) == 0) {
-					/* never an empty match, so step 13.c.iii can't be triggered */
-					goto found;
-				}
-
-				/* track utf-8 non-continuation bytes */
-				if ((p[0] & 0xc0) != 0x80) {
-					match_start_coff++;
-				}
-				p++;
+			p_match = duk_memmem(p, (duk_size_t) (p_end - p), q_start, q_blen);
+			if (p_match != NULL) {
+				/* never an empty match, so step 13.c.iii can't be triggered */
+				match_start_coff += (duk_uint32_t) duk_unicode_unvalidated_utf8_length(p, (duk_size_t) (p_match - p));
+				p = p_match;
+				goto found;
 			}
 
 		 not_found:
@@ -42049,7 +42595,7 @@ DUK_LOCAL const char * const duk__bc_optab[256] = {
 
 	"NEWOBJ", "NEWARR", "MPUTOBJ", "MPUTOBJI", "INITSET", "INITGET", "MPUTARR", "MPUTARRI",
 	"SETALEN", "INITENUM", "NEXTENUM", "NEWTARGET", "DEBUGGER", "NOP", "INVALID", "UNUSED207",
-	"GETPROPC_RR", "GETPROPC_CR", "GETPROPC_RC", "GETPROPC_CC", "UNUSED212", "UNUSED213", "UNUSED214", "UNUSED215",
+	"GETPROPC_RR", "GETPROPC_CR", "GETPROPC_RC", "GETPROPC_CC", "SWITCHINT", "SWITCHSTR", "UNUSED214", "UNUSED215",
 	"UNUSED216", "UNUSED217", "UNUSED218", "UNUSED219", "UNUSED220", "UNUSED221", "UNUSED222", "UNUSED223",
 
 	"UNUSED224", "UNUSED225", "UNUSED226", "UNUSED227", "UNUSED228", "UNUSED229", "UNUSED230", "UNUSED231",
@@ -47074,6 +47620,9 @@ DUK_INTERNAL duk_hbuffer *duk_hbuffer_alloc(duk_heap *heap, duk_size_t size, duk
 	}
         DUK_HEAP_INSERT_INTO_HEAP_ALLOCATED(heap, &res->hdr);
 
+	heap->hs_buf_count++;
+	heap->hs_buf_bytes += duk_heap_hbuffer_alloc_size(res);
+
 	DUK_DDD(DUK_DDDPRINT("allocated hbuffer: %p", (void *) res));
 	return res;
 
@@ -47164,6 +47713,9 @@ DUK_INTERNAL void duk_hbuffer_resize(duk_hthread *thr, duk_hbuffer_dynamic *buf,
 #endif
 		}
 
+		thr->heap->hs_buf_bytes += new_size;
+		thr->heap->hs_buf_bytes -= prev_size;
+
 		DUK_HBUFFER_DYNAMIC_SET_SIZE(buf, new_size);
 		DUK_HBUFFER_DYNAMIC_SET_DATA_PTR(thr->heap, buf, res);
 	} else {
@@ -47222,10 +47774,25 @@ DUK_INTERNAL duk_uint_t duk_hbufobj_clamp_bytelength(duk_hbufobj *h_bufobj, duk_
  *  been already dealt with.
  */
 
+/* Frees while mark-and-sweep is running are sweeps; others are refzero
+ * frees (or heap destruction).
+ */
+#define DUK__HEAP_STATS_COUNT_FREE(heap) do { \
+		if ((heap)->ms_running) { \
+			(heap)->hs_ms_free++; \
+		} else { \
+			(heap)->hs_refzero_free++; \
+		} \
+	} while (0)
+
 DUK_INTERNAL void duk_free_hobject(duk_heap *heap, duk_hobject *h) {
 	DUK_ASSERT(heap != NULL);
 	DUK_ASSERT(h != NULL);
 
+	heap->hs_obj_count[DUK_HOBJECT_GET_CLASS_NUMBER(h)]--;
+	heap->hs_obj_bytes[DUK_HOBJECT_GET_CLASS_NUMBER(h)] -= duk_heap_hobject_alloc_size(h);
+	DUK__HEAP_STATS_COUNT_FREE(heap);
+
 	DUK_FREE(heap, DUK_HOBJECT_GET_PROPS(heap, h));
 
 	if (DUK_HOBJECT_IS_COMPFUNC(h)) {
@@ -47282,6 +47849,10 @@ DUK_INTERNAL void duk_free_hbuffer(duk_heap *heap, duk_hbuffer *h) {
 	DUK_ASSERT(heap != NULL);
 	DUK_ASSERT(h != NULL);
 
+	heap->hs_buf_count--;
+	heap->hs_buf_bytes -= duk_heap_hbuffer_alloc_size(h);
+	DUK__HEAP_STATS_COUNT_FREE(heap);
+
 	if (DUK_HBUFFER_HAS_DYNAMIC(h) && !DUK_HBUFFER_HAS_EXTERNAL(h)) {
 		duk_hbuffer_dynamic *g = (duk_hbuffer_dynamic *) h;
 		DUK_DDD(DUK_DDDPRINT("free dynamic buffer %p", (void *) DUK_HBUFFER_DYNAMIC_GET_DATA_PTR(heap, g)));
@@ -47294,8 +47865,9 @@ DUK_INTERNAL void duk_free_hstring(duk_heap *heap, duk_hstring *h) {
 	DUK_ASSERT(heap != NULL);
 	DUK_ASSERT(h != NULL);
 
-	DUK_UNREF(heap);
-	DUK_UNREF(h);
+	heap->hs_str_count--;
+	heap->hs_str_bytes -= duk_heap_hstring_alloc_size(h);
+	DUK__HEAP_STATS_COUNT_FREE(heap);
 
 #if defined(DUK_USE_HSTRING_EXTDATA) && defined(DUK_USE_EXTSTR_FREE)
 	if (DUK_HSTRING_HAS_EXTDATA(h)) {
@@ -48159,6 +48731,12 @@ duk_heap *duk_heap_alloc(duk_alloc_function alloc_func,
 	res->dbg_udata = NULL;
 	res->dbg_pause_act = NULL;
 #endif
+#if defined(DUK_USE_INTERRUPT_COUNTER)
+	res->interrupt_func = NULL;
+	res->interrupt_udata = NULL;
+#endif
+	res->ms_pause_func = NULL;
+	res->ms_pause_udata = NULL;
 #endif  /* DUK_USE_EXPLICIT_NULL_INIT */
 
 	res->alloc_func = alloc_func;
@@ -48173,6 +48751,10 @@ duk_heap *duk_heap_alloc(duk_alloc_function alloc_func,
 	 */
 
 	/* res->ms_trigger_counter == 0 -> now causes immediate GC; which is OK */
+#if defined(DUK_USE_VOLUNTARY_GC)
+	res->ms_trigger_mult = (duk_int_t) DUK_HEAP_MARK_AND_SWEEP_TRIGGER_MULT;
+	res->ms_trigger_add = (duk_int_t) DUK_HEAP_MARK_AND_SWEEP_TRIGGER_ADD;
+#endif
 
 	/* Prevent mark-and-sweep and finalizer execution until heap is completely
 	 * initialized.
@@ -50195,6 +50777,7 @@ DUK_INTERNAL void duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t flags
 #if defined(DUK_USE_VOLUNTARY_GC)
 	duk_size_t tmp;
 #endif
+	duk_double_t pause_start = 0.0;
 
 	DUK_STATS_INC(heap, stats_ms_try_count);
 #if defined(DUK_USE_DEBUG)
@@ -50227,6 +50810,11 @@ DUK_INTERNAL void duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t flags
 	DUK_ASSERT(heap->heap_thread != NULL);
 	DUK_ASSERT(heap->heap_thread->valstack != NULL);
 
+	if (heap->ms_pause_func != NULL) {
+		pause_start = duk_time_get_monotonic_time(heap->heap_thread);
+	}
+	heap->hs_ms_count++;
+
 	DUK_D(DUK_DPRINT("garbage collect (mark-and-sweep) starting, requested flags: 0x%08lx, effective flags: 0x%08lx",
 	                 (unsigned long) flags, (unsigned long) (flags | heap->ms_base_flags)));
 
@@ -50422,10 +51010,13 @@ DUK_INTERNAL void duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t flags
 	 */
 
 #if defined(DUK_USE_VOLUNTARY_GC)
-	tmp = (count_keep_obj + count_keep_str) / 256;
-	heap->ms_trigger_counter = (duk_int_t) (
-	    (tmp * DUK_HEAP_MARK_AND_SWEEP_TRIGGER_MULT) +
-	    DUK_HEAP_MARK_AND_SWEEP_TRIGGER_ADD);
+	if (heap->ms_trigger_mult < 0) {
+		heap->ms_trigger_counter = DUK_INT_MAX;
+	} else {
+		tmp = (count_keep_obj + count_keep_str) / 256;
+		tmp = tmp * (duk_size_t) heap->ms_trigger_mult + (duk_size_t) heap->ms_trigger_add;
+		heap->ms_trigger_counter = (duk_int_t) (tmp > (duk_size_t) DUK_INT_MAX ? DUK_INT_MAX : tmp);
+	}
 	DUK_D(DUK_DPRINT("garbage collect (mark-and-sweep) finished: %ld objects kept, %ld strings kept, trigger reset to %ld",
 	                 (long) count_keep_obj, (long) count_keep_str, (long) heap->ms_trigger_counter));
 #else
@@ -50474,6 +51065,13 @@ DUK_INTERNAL void duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t flags
 	 */
 	duk_heap_process_finalize_list(heap);
 #endif  /* DUK_USE_FINALIZER_SUPPORT */
+
+	/* The pause includes finalizer execution, as seen by the caller. */
+	if (heap->ms_pause_func != NULL) {
+		heap->ms_pause_func(heap->ms_pause_udata,
+		                    (duk_uint_t) flags,
+		                    duk_time_get_monotonic_time(heap->heap_thread) - pause_start);
+	}
 }
 /*
  *  Memory allocation handling.
@@ -50496,6 +51094,14 @@ DUK_LOCAL DUK_INLINE void duk__check_voluntary_gc(duk_heap *heap) {
 		}
 #endif
 
+		/* Voluntary GC may have been disabled after the counter was
+		 * last reset; just rearm the counter.
+		 */
+		if (heap->ms_trigger_mult < 0) {
+			heap->ms_trigger_counter = DUK_INT_MAX;
+			return;
+		}
+
 		/* Prevention checks in the call target handle cases where
 		 * voluntary GC is not allowed.  The voluntary GC trigger
 		 * counter is only rewritten if mark-and-sweep actually runs.
@@ -50846,6 +51452,76 @@ DUK_INTERNAL void duk_heap_mem_free(duk_heap *heap, void *ptr) {
 
 /* #include duk_internal.h -> already included */
 
+/*
+ *  Live heap accounting helpers.  The sizes must be computable both at
+ *  allocation and at free time, so they're derived from the flags and
+ *  current sizes only.
+ */
+
+DUK_INTERNAL duk_size_t duk_heap_hobject_alloc_size(duk_hobject *h) {
+	duk_size_t size;
+
+	if (DUK_HOBJECT_IS_ARRAY(h)) {
+		size = sizeof(duk_harray);
+	} else if (DUK_HOBJECT_IS_COMPFUNC(h)) {
+		size = sizeof(duk_hcompfunc);
+	} else if (DUK_HOBJECT_IS_NATFUNC(h)) {
+		size = sizeof(duk_hnatfunc);
+	} else if (DUK_HOBJECT_IS_BOUNDFUNC(h)) {
+		size = sizeof(duk_hboundfunc);
+	} else if (DUK_HOBJECT_IS_THREAD(h)) {
+		size = sizeof(duk_hthread);
+#if defined(DUK_USE_BUFFEROBJECT_SUPPORT)
+	} else if (DUK_HOBJECT_IS_BUFOBJ(h)) {
+		size = sizeof(duk_hbufobj);
+#endif
+	} else if (DUK_HOBJECT_IS_DECENV(h)) {
+		size = sizeof(duk_hdecenv);
+	} else if (DUK_HOBJECT_IS_OBJENV(h)) {
+		size = sizeof(duk_hobjenv);
+	} else if (DUK_HOBJECT_IS_PROXY(h)) {
+		size = sizeof(duk_hproxy);
+	} else {
+		size = sizeof(duk_hobject);
+	}
+
+	return size + DUK_HOBJECT_P_ALLOC_SIZE(h);
+}
+
+DUK_INTERNAL duk_size_t duk_heap_hstring_alloc_size(duk_hstring *h) {
+#if defined(DUK_USE_HSTRING_EXTDATA)
+	if (DUK_HSTRING_HAS_EXTDATA(h)) {
+		return sizeof(duk_hstring_external);
+	}
+#endif
+	return sizeof(duk_hstring) + DUK_HSTRING_GET_BYTELEN(h) + 1;
+}
+
+DUK_INTERNAL duk_size_t duk_heap_hbuffer_alloc_size(duk_hbuffer *h) {
+	if (DUK_HBUFFER_HAS_DYNAMIC(h)) {
+		if (DUK_HBUFFER_HAS_EXTERNAL(h)) {
+			return sizeof(duk_hbuffer_external);
+		}
+		return sizeof(duk_hbuffer_dynamic) + DUK_HBUFFER_GET_SIZE(h);
+	}
+	return sizeof(duk_hbuffer_fixed) + DUK_HBUFFER_GET_SIZE(h);
+}
+
+/* Change the class of a live object, moving it between class counters. */
+DUK_INTERNAL void duk_heap_hobject_set_class(duk_heap *heap, duk_hobject *h, duk_small_uint_t class_num) {
+	duk_small_uint_t old_class;
+	duk_size_t size;
+
+	old_class = (duk_small_uint_t) DUK_HOBJECT_GET_CLASS_NUMBER(h);
+	size = duk_heap_hobject_alloc_size(h);
+
+	heap->hs_obj_count[old_class]--;
+	heap->hs_obj_bytes[old_class] -= size;
+	DUK_HOBJECT_SET_CLASS_NUMBER(h, class_num);
+	heap->hs_obj_count[class_num]++;
+	heap->hs_obj_bytes[class_num] += size;
+}
+
 DUK_INTERNAL void duk_heap_insert_into_heap_allocated(duk_heap *heap, duk_heaphdr *hdr) {
 	duk_heaphdr *root;
 
@@ -52434,6 +53110,9 @@ DUK_LOCAL duk_hstring *duk__strtable_alloc_hstring(duk_heap *heap,
 	                     (long) (DUK_HSTRING_HAS_ARRIDX(res) ? 1 : 0),
 	                     (long) (DUK_HSTRING_HAS_EXTDATA(res) ? 1 : 0)));
 
+	heap->hs_str_count++;
+	heap->hs_str_bytes += duk_heap_hstring_alloc_size(res);
+
 	DUK_ASSERT(res != NULL);
 	return res;
 
@@ -53020,6 +53699,7 @@ DUK_INTERNAL duk_hstring *duk_heap_strtable_intern_literal_checked(duk_hthread *
 		DUK_ASSERT(ent->h != NULL);
 		DUK_ASSERT(DUK_HSTRING_HAS_PINNED_LITERAL(ent->h));
 		DUK_STATS_INC(thr->heap, stats_strtab_litcache_hit);
+		thr->heap->hs_litcache_hit++;
 		return ent->h;
 	}
 
@@ -53028,6 +53708,7 @@ DUK_INTERNAL duk_hstring *duk_heap_strtable_intern_literal_checked(duk_hthread *
 	ent->addr = str;
 	ent->h = h;
 	DUK_STATS_INC(thr->heap, stats_strtab_litcache_miss);
+	thr->heap->hs_litcache_miss++;
 
 	/* Pin the duk_hstring until the next mark-and-sweep.  This means
 	 * litcache entries don't need to be invalidated until the next
@@ -53348,6 +54029,9 @@ DUK_LOCAL void duk__init_object_parts(duk_heap *heap, duk_uint_t hobject_flags,
 	DUK_HEAPHDR_ASSERT_LINKS(heap, &obj->hdr);
 	DUK_HEAP_INSERT_INTO_HEAP_ALLOCATED(heap, &obj->hdr);
 
+	heap->hs_obj_count[DUK_HOBJECT_GET_CLASS_NUMBER(obj)]++;
+	heap->hs_obj_bytes[DUK_HOBJECT_GET_CLASS_NUMBER(obj)] += duk_heap_hobject_alloc_size(obj);
+
 	/* obj->props is intentionally left as NULL, and duk_hobject_props.c must deal
 	 * with this properly.  This is intentional: empty objects consume a minimum
 	 * amount of memory.  Further, an initial allocation might fail and cause
@@ -54712,6 +55396,22 @@ DUK_INTERNAL duk_uint_fast32_t duk_hobject_pc2line_query(duk_hthread *thr, duk_i
 	return line;
 }
 
+/* Same as duk_hobject_pc2line_query() but for a function pointer, without
+ * using the value stack.  Returns 0 if the function has no pc2line data.
+ */
+DUK_INTERNAL duk_uint_fast32_t duk_hobject_pc2line_query_raw_func(duk_hthread *thr, duk_hobject *func, duk_uint_fast32_t pc) {
+	duk_tval *tv;
+
+	DUK_ASSERT(func != NULL);
+
+	tv = duk_hobject_find_entry_tval_ptr_stridx(thr->heap, func, DUK_STRIDX_INT_PC2LINE);
+	if (tv == NULL || !DUK_TVAL_IS_BUFFER(tv)) {
+		return 0;
+	}
+	DUK_ASSERT(!DUK_HBUFFER_HAS_DYNAMIC(DUK_TVAL_GET_BUFFER(tv)) && !DUK_HBUFFER_HAS_EXTERNAL(DUK_TVAL_GET_BUFFER(tv)));
+	return duk__hobject_pc2line_query_raw(thr, (duk_hbuffer_fixed *) (void *) DUK_TVAL_GET_BUFFER(tv), pc);
+}
+
 #endif  /* DUK_USE_PC2LINE */
 /*
  *  duk_hobject property access functionality.
@@ -55719,6 +56419,8 @@ DUK_INTERNAL void duk_hobject_realloc_props(duk_hthread *thr,
 	 *  All done, switch properties ('p') allocation to new one.
 	 */
 
+	thr->heap->hs_obj_bytes[DUK_HOBJECT_GET_CLASS_NUMBER(obj)] -= DUK_HOBJECT_P_ALLOC_SIZE(obj);
+
 	DUK_FREE_CHECKED(thr, DUK_HOBJECT_GET_PROPS(thr->heap, obj));  /* NULL obj->p is OK */
 	DUK_HOBJECT_SET_PROPS(thr->heap, obj, new_p);
 	DUK_HOBJECT_SET_ESIZE(obj, new_e_size_adjusted);
@@ -55726,6 +56428,8 @@ DUK_INTERNAL void duk_hobject_realloc_props(duk_hthread *thr,
 	DUK_HOBJECT_SET_ASIZE(obj, new_a_size);
 	DUK_HOBJECT_SET_HSIZE(obj, new_h_size);
 
+	thr->heap->hs_obj_bytes[DUK_HOBJECT_GET_CLASS_NUMBER(obj)] += DUK_HOBJECT_P_ALLOC_SIZE(obj);
+
 	/* Clear array part flag only after switching. */
 	if (abandon_array) {
 		DUK_HOBJECT_CLEAR_ARRAY_PART(obj);
@@ -57589,6 +58293,18 @@ DUK_INTERNAL duk_bool_t duk_hobject_getprop(duk_hthread *thr, duk_tval *tv_obj,
 			DUK_ASSERT(((desc.flags & DUK_PROPDESC_FLAG_ACCESSOR) == 0) ||
 			           (desc.get == NULL));
 
+#if defined(DUK_USE_EXEC_PROPCACHE_SIZE)
+			/* Own data property of the original object: let the
+			 * executor remember where it was found.
+			 */
+			if (desc.e_idx >= 0 &&
+			    (desc.flags & DUK_PROPDESC_FLAG_ACCESSOR) == 0 &&
+			    DUK_TVAL_IS_OBJECT(tv_obj) &&
+			    DUK_TVAL_GET_OBJECT(tv_obj) == curr) {
+				thr->heap->propcache_e_idx = desc.e_idx;
+			}
+#endif
+
 			/* if accessor without getter, return value is undefined */
 			DUK_ASSERT(((desc.flags & DUK_PROPDESC_FLAG_ACCESSOR) == 0) ||
 			           duk_is_undefined(thr, -1));
@@ -58757,6 +59473,9 @@ DUK_INTERNAL duk_bool_t duk_hobject_putprop(duk_hthread *thr, duk_tval *tv_obj,
 	DUK_ASSERT(!(DUK_HOBJECT_IS_ARRAY(orig) && key == DUK_HTHREAD_STRING_LENGTH(thr)));
 
 	if (desc.e_idx >= 0) {
+#if defined(DUK_USE_EXEC_PROPCACHE_SIZE)
+		thr->heap->propcache_e_idx = desc.e_idx;  /* before side effects */
+#endif
 		tv = DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(thr->heap, orig, desc.e_idx);
 		DUK_DDD(DUK_DDDPRINT("previous entry value: %!iT", (duk_tval *) tv));
 		DUK_TVAL_SET_TVAL_UPDREF(thr, tv, tv_val);  /* side effects; e_idx may be invalidated */
@@ -61282,6 +62001,7 @@ DUK_LOCAL void duk__duplicate_ram_global_object(duk_hthread *thr) {
 	DUK_HOBJECT_SET_ENEXT(h_global, DUK_HOBJECT_GET_ENEXT(h_oldglobal));
 	DUK_HOBJECT_SET_ASIZE(h_global, DUK_HOBJECT_GET_ASIZE(h_oldglobal));
 	DUK_HOBJECT_SET_HSIZE(h_global, DUK_HOBJECT_GET_HSIZE(h_oldglobal));
+	thr->heap->hs_obj_bytes[DUK_HOBJECT_CLASS_GLOBAL] += alloc_size;
 #else
 #error internal error in config defines
 #endif
@@ -61513,7 +62233,7 @@ DUK_INTERNAL void duk_hthread_create_builtin_objects(duk_hthread *thr) {
 		}
 
 		h = duk_known_hobject(thr, -1);
-		DUK_HOBJECT_SET_CLASS_NUMBER(h, class_num);
+		duk_heap_hobject_set_class(thr->heap, h, class_num);
 
 		if (i < DUK_NUM_BUILTINS) {
 			thr->builtins[i] = h;
@@ -64440,6 +65160,9 @@ DUK_LOCAL void duk__call_setup_act_not_tailcall(duk_hthread *thr,
 	new_act->parent = act;
 	thr->callstack_curr = new_act;
 	thr->callstack_top++;
+	if (DUK_UNLIKELY(thr->callstack_top > thr->heap->hs_callstack_peak)) {
+		thr->heap->hs_callstack_peak = thr->callstack_top;
+	}
 	act = new_act;
 	*out_act = act;
 
@@ -67441,6 +68164,151 @@ DUK_LOCAL void duk__emit_invalid(duk_compiler_ctx *comp_ctx) {
 	duk__emit_op_only(comp_ctx, DUK_OP_INVALID);
 }
 
+/*
+ *  Switch dispatch tables.
+ *
+ *  A switch statement compiles to a chain of SEQ comparisons, one per case
+ *  clause, so dispatch is linear in the number of cases.  When all cases
+ *  are integer constants from a dense range, or all are string constants,
+ *  and there are enough of them, a DUK_OP_SWITCHINT or DUK_OP_SWITCHSTR
+ *  with an inline table is emitted after the switch body, and the start of
+ *  the chain is overwritten with a jump to it.  The rest of the chain is
+ *  left behind as dead code (DUK_COMPILE_OPTIMIZE removes it).  Constant
+ *  case values have no side effects, so not evaluating them is unobservable,
+ *  and a case value appearing twice only matches its first clause, like in
+ *  the chain.
+ */
+
+#define DUK__SWITCH_TABLE_MIN_CASES       8
+#define DUK__SWITCH_TABLE_MAX_SPARSITY    2  /* integer table may be up to this many times the number of cases */
+
+/* Emit a dispatch table for 'num_cases' cases, given as (constant index, pc
+ * of clause body) pairs in 'cases', in source order.  'pc_nomatch' is where
+ * to go if no case matches, or -1 for right after the table.  Returns the pc
+ * of the SWITCHxxx, or -1 if no table suits the cases.
+ */
+DUK_LOCAL duk_int_t duk__emit_switch_table(duk_compiler_ctx *comp_ctx, duk_regconst_t reg_switch, const duk_int_t *cases, duk_int_t num_cases, duk_int_t pc_nomatch) {
+	duk_hthread *thr = comp_ctx->thr;
+	duk_idx_t consts_idx = comp_ctx->curr_func.consts_idx;
+	duk_int_t num_int = 0;
+	duk_int_t num_str = 0;
+	duk_double_t low = 0.0;
+	duk_double_t high = 0.0;
+	duk_int_t pc_table;
+	duk_int_t pc_slots;
+	duk_int_t size;
+	duk_int_t i;
+
+	if (num_cases < DUK__SWITCH_TABLE_MIN_CASES) {
+		return -1;
+	}
+
+	duk_require_stack(thr, 2);
+
+	for (i = 0; i < num_cases; i++) {
+		duk_get_prop_index(thr, consts_idx, (duk_uarridx_t) cases[i * 2]);
+		if (duk_is_string(thr, -1)) {
+			num_str++;
+		} else if (duk_is_number(thr, -1)) {
+			duk_double_t d = duk_get_number(thr, -1);
+			if (d == DUK_FLOOR(d) && d >= -(duk_double_t) DUK_BC_JUMP_BIAS && d < (duk_double_t) DUK_BC_JUMP_BIAS) {
+				low = (num_int == 0 || d < low) ? d : low;
+				high = (num_int == 0 || d > high) ? d : high;
+				num_int++;
+			}
+		}
+		duk_pop(thr);
+	}
+
+	pc_table = duk__get_current_pc(comp_ctx);
+
+	if (num_int == num_cases && high - low < (duk_double_t) (num_cases * DUK__SWITCH_TABLE_MAX_SPARSITY)) {
+		size = (duk_int_t) (high - low) + 1;
+		pc_slots = pc_table + 3;
+		if (pc_nomatch < 0) {
+			pc_nomatch = pc_slots + size + 1;
+		}
+
+		duk__emit_bc(comp_ctx, DUK_OP_SWITCHINT, reg_switch);
+		duk__emit(comp_ctx, DUK_ENC_OP_ABC(DUK_OP_NOP, size));
+		duk__emit(comp_ctx, DUK_ENC_OP_ABC(DUK_OP_NOP, (duk_int_t) low + DUK_BC_JUMP_BIAS));
+		for (i = 0; i <= size; i++) {
+			duk__emit_invalid(comp_ctx);  /* no case yet */
+		}
+
+		for (i = 0; i < num_cases; i++) {
+			duk_int_t pc_entry;
+
+			duk_get_prop_index(thr, consts_idx, (duk_uarridx_t) cases[i * 2]);
+			pc_entry = pc_slots + ((duk_int_t) duk_get_number(thr, -1) - (duk_int_t) low);
+			duk_pop(thr);
+			if (DUK_DEC_OP(duk__get_instr_ptr(comp_ctx, pc_entry)->ins) == DUK_OP_INVALID) {
+				duk__patch_jump(comp_ctx, pc_entry, cases[i * 2 + 1]);
+			}
+		}
+	} else if (num_str == num_cases) {
+		duk_uint32_t mask;
+
+		size = 16;
+		while (size < num_cases * 2) {
+			size *= 2;
+		}
+		mask = (duk_uint32_t) size - 1U;
+		pc_slots = pc_table + 2;
+		if (pc_nomatch < 0) {
+			pc_nomatch = pc_slots + size * 2 + 1;
+		}
+
+		duk__emit_bc(comp_ctx, DUK_OP_SWITCHSTR, reg_switch);
+		duk__emit(comp_ctx, DUK_ENC_OP_ABC(DUK_OP_NOP, mask));
+		for (i = 0; i < size; i++) {
+			duk__emit(comp_ctx, DUK_ENC_OP_A_BC(DUK_OP_NOP, 0, 0));  /* unused slot */
+			duk__emit_invalid(comp_ctx);
+		}
+		duk__emit_invalid(comp_ctx);
+
+		for (i = 0; i < num_cases; i++) {
+			duk_hstring *h_case;
+			duk_uint32_t slot;
+
+			duk_get_prop_index(thr, consts_idx, (duk_uarridx_t) cases[i * 2]);
+			h_case = duk_known_hstring(thr, -1);
+			slot = duk_js_switch_hash(DUK_HSTRING_GET_DATA(h_case), DUK_HSTRING_GET_BYTELEN(h_case)) & mask;
+
+			for (;;) {
+				duk_compiler_instr *key = duk__get_instr_ptr(comp_ctx, pc_slots + (duk_int_t) slot * 2);
+				duk_bool_t same;
+
+				if (DUK_DEC_A(key->ins) == 0) {
+					key->ins = DUK_ENC_OP_A_BC(DUK_OP_NOP, 1, cases[i * 2]);
+					duk__patch_jump(comp_ctx, pc_slots + (duk_int_t) slot * 2 + 1, cases[i * 2 + 1]);
+					break;
+				}
+				duk_get_prop_index(thr, consts_idx, (duk_uarridx_t) DUK_DEC_BC(key->ins));
+				same = (duk_known_hstring(thr, -1) == h_case);
+				duk_pop(thr);
+				if (same) {
+					break;  /* duplicate case, the first one matches */
+				}
+				slot = (slot + 1U) & mask;
+			}
+			duk_pop(thr);
+		}
+	} else {
+		return -1;
+	}
+
+	for (i = pc_slots; i < duk__get_current_pc(comp_ctx); i++) {
+		if (DUK_DEC_OP(duk__get_instr_ptr(comp_ctx, i)->ins) == DUK_OP_INVALID) {
+			duk__patch_jump(comp_ctx, i, pc_nomatch);
+		}
+	}
+
+	DUK_DD(DUK_DDPRINT("switch with %ld cases dispatched with a %s table at pc %ld",
+	                   (long) num_cases, (num_int == num_cases ? "integer" : "string"), (long) pc_table));
+	return pc_table;
+}
+
 /*
  *  Peephole optimizer for finished bytecode.
  *
@@ -67508,6 +68376,755 @@ DUK_LOCAL void duk__peephole_optimize_bytecode(duk_compiler_ctx *comp_ctx) {
 	}
 }
 
+/*
+ *  Bytecode optimizer for finished bytecode.
+ *
+ *  Only run when the caller asks for it with DUK_COMPILE_OPTIMIZE, which is
+ *  intended for code that is compiled once and then cached or run many
+ *  times.  The pass works on the final instruction stream of a function
+ *  and makes a few rounds of local rewrites:
+ *
+ *    - Jumps to a return are replaced with a copy of the return, and jumps
+ *      to the next instruction are removed.
+ *
+ *    - "IFxxx; JUMP +1; insn" becomes "IFyyy; insn" with the condition
+ *      inverted, which is what an early return in an 'if' compiles to.
+ *
+ *    - An LNOT into a temporary which only feeds an IFxxx is folded into
+ *      the IFxxx by inverting it.
+ *
+ *    - Register moves through temporaries are coalesced: a value produced
+ *      into a temporary and then copied with LDREG is produced directly in
+ *      the copy's target, and a temporary copy of a register which is read
+ *      once is replaced with the register itself.
+ *
+ *    - Unary operators on LDINT values and numeric binary operators on two
+ *      constants are folded into LDINT, LDTRUE or LDFALSE.
+ *
+ *    - Unreachable instructions and the NOPs left behind by the rewrites
+ *      are removed, and the jumps are relocated.
+ *
+ *  Only temporaries (registers >= temp_first) are ever eliminated, because
+ *  variables can be observed by closures while an instruction runs user
+ *  code, and temporaries can't.  A temporary is considered dead after an
+ *  instruction when every path from there writes it before reading it
+ *  within a few instructions whose operands are known here; anything else
+ *  keeps it alive.  Instructions skipped by IFxxx or NEXTENUM, and the jump
+ *  slots following LABEL and TRYCATCH, are never removed because the
+ *  executor addresses them relative to the instruction before them.
+ */
+
+#define DUK__OPTIMIZE_MAXROUNDS          4
+#define DUK__OPTIMIZE_LIVENESS_STEPS     16
+
+/* Instruction fields holding register numbers. */
+#define DUK__OPTIMIZE_FIELD_A            (1U << 0)
+#define DUK__OPTIMIZE_FIELD_B            (1U << 1)
+#define DUK__OPTIMIZE_FIELD_C            (1U << 2)
+#define DUK__OPTIMIZE_FIELD_BC           (1U << 3)
+#define DUK__OPTIMIZE_UNKNOWN            (1U << 4)  /* register usage not known, assume anything is read */
+
+/* Per instruction marks. */
+#define DUK__OPTIMIZE_MARK_TARGET        (1U << 0)  /* execution may continue here from elsewhere than pc - 1 */
+#define DUK__OPTIMIZE_MARK_PINNED        (1U << 1)  /* addressed relative to pc - 1 or pc - 2, must not be removed */
+#define DUK__OPTIMIZE_MARK_SLOT          (1U << 2)  /* LABEL or TRYCATCH jump slot */
+#define DUK__OPTIMIZE_MARK_REACHABLE     (1U << 3)
+
+/* Return the register fields read by an instruction, and the field of the
+ * register it writes (0 if none) in 'out_write'.
+ */
+DUK_LOCAL duk_small_uint_t duk__optimize_get_operands(duk_instr_t ins, duk_small_uint_t *out_write) {
+	duk_small_uint_t op;
+
+	op = (duk_small_uint_t) DUK_DEC_OP(ins);
+	*out_write = 0;
+
+	if ((op >= DUK_OP_EQ_RR && op <= DUK_OP_LE_CC) ||
+	    (op >= DUK_OP_ADD_RR && op <= DUK_OP_IN_CC) ||
+	    (op >= DUK_OP_GETPROP_RR && op <= DUK_OP_GETPROP_CC)) {
+		*out_write = DUK__OPTIMIZE_FIELD_A;
+		return ((op & DUK_BC_REGCONST_B) ? 0 : DUK__OPTIMIZE_FIELD_B) |
+		       ((op & DUK_BC_REGCONST_C) ? 0 : DUK__OPTIMIZE_FIELD_C);
+	}
+	if (op >= DUK_OP_PUTPROP_RR && op <= DUK_OP_PUTPROP_CC) {
+		return DUK__OPTIMIZE_FIELD_A |
+		       ((op & DUK_BC_REGCONST_B) ? 0 : DUK__OPTIMIZE_FIELD_B) |
+		       ((op & DUK_BC_REGCONST_C) ? 0 : DUK__OPTIMIZE_FIELD_C);
+	}
+
+	switch (op) {
+	case DUK_OP_LDREG:
+	case DUK_OP_PREINCR:  /* also writes BC, which is read first */
+	case DUK_OP_PREDECR:
+	case DUK_OP_POSTINCR:
+	case DUK_OP_POSTDECR:
+	case DUK_OP_BNOT:
+	case DUK_OP_LNOT:
+	case DUK_OP_UNM:
+	case DUK_OP_UNP:
+	case DUK_OP_TYPEOF:
+		*out_write = DUK__OPTIMIZE_FIELD_A;
+		return DUK__OPTIMIZE_FIELD_BC;
+	case DUK_OP_LDCONST:
+	case DUK_OP_LDINT:
+		*out_write = DUK__OPTIMIZE_FIELD_A;
+		return 0;
+	case DUK_OP_LDTHIS:
+	case DUK_OP_LDUNDEF:
+	case DUK_OP_LDNULL:
+	case DUK_OP_LDTRUE:
+	case DUK_OP_LDFALSE:
+		*out_write = DUK__OPTIMIZE_FIELD_BC;
+		return 0;
+	case DUK_OP_IFTRUE_R:
+	case DUK_OP_IFFALSE_R:
+	case DUK_OP_RETREG:
+		return DUK__OPTIMIZE_FIELD_BC;
+	case DUK_OP_NOP:
+	case DUK_OP_JUMP:
+	case DUK_OP_LABEL:
+	case DUK_OP_ENDLABEL:
+	case DUK_OP_IFTRUE_C:
+	case DUK_OP_IFFALSE_C:
+	case DUK_OP_RETUNDEF:
+	case DUK_OP_RETCONST:
+	case DUK_OP_RETCONSTN:
+		return 0;
+	default:
+		return DUK__OPTIMIZE_UNKNOWN;
+	}
+}
+
+DUK_LOCAL duk_regconst_t duk__optimize_get_field(duk_instr_t ins, duk_small_uint_t field) {
+	switch (field) {
+	case DUK__OPTIMIZE_FIELD_A:
+		return (duk_regconst_t) DUK_DEC_A(ins);
+	case DUK__OPTIMIZE_FIELD_B:
+		return (duk_regconst_t) DUK_DEC_B(ins);
+	case DUK__OPTIMIZE_FIELD_C:
+		return (duk_regconst_t) DUK_DEC_C(ins);
+	default:
+		return (duk_regconst_t) DUK_DEC_BC(ins);
+	}
+}
+
+/* Replace the register in a field; returns 0 if it doesn't fit the field. */
+DUK_LOCAL duk_bool_t duk__optimize_set_field(duk_instr_t *ins, duk_small_uint_t field, duk_regconst_t reg) {
+	switch (field) {
+	case DUK__OPTIMIZE_FIELD_A:
+		if (reg > DUK_BC_A_MAX) {
+			return 0;
+		}
+		*ins = (*ins & ~DUK_BC_SHIFTED_MASK_A) | ((duk_instr_t) reg << DUK_BC_SHIFT_A);
+		return 1;
+	case DUK__OPTIMIZE_FIELD_B:
+		if (reg > DUK_BC_B_MAX) {
+			return 0;
+		}
+		*ins = (*ins & ~DUK_BC_SHIFTED_MASK_B) | ((duk_instr_t) reg << DUK_BC_SHIFT_B);
+		return 1;
+	case DUK__OPTIMIZE_FIELD_C:
+		if (reg > DUK_BC_C_MAX) {
+			return 0;
+		}
+		*ins = (*ins & ~DUK_BC_SHIFTED_MASK_C) | ((duk_instr_t) reg << DUK_BC_SHIFT_C);
+		return 1;
+	default:
+		if (reg > DUK_BC_BC_MAX) {
+			return 0;
+		}
+		*ins = (*ins & ~DUK_BC_SHIFTED_MASK_BC) | ((duk_instr_t) reg << DUK_BC_SHIFT_BC);
+		return 1;
+	}
+}
+
+/* Return the fields in 'fields' which name register 'reg'. */
+DUK_LOCAL duk_small_uint_t duk__optimize_match_fields(duk_instr_t ins, duk_small_uint_t fields, duk_regconst_t reg) {
+	duk_small_uint_t field;
+	duk_small_uint_t ret = 0;
+
+	for (field = DUK__OPTIMIZE_FIELD_A; field <= DUK__OPTIMIZE_FIELD_BC; field <<= 1) {
+		if ((fields & field) && duk__optimize_get_field(ins, field) == reg) {
+			ret |= field;
+		}
+	}
+	return ret;
+}
+
+/* Check that every path starting from 'pc' writes 'reg' before reading it.
+ * 'budget' limits the number of instructions looked at over all paths.
+ */
+DUK_LOCAL duk_bool_t duk__optimize_is_dead(duk_compiler_instr *bc, duk_int_t n, duk_int_t pc, duk_regconst_t reg, duk_int_t *budget) {
+	for (;;) {
+		duk_instr_t ins;
+		duk_small_uint_t op;
+		duk_small_uint_t reads;
+		duk_small_uint_t write;
+
+		if (pc < 0 || pc >= n || --(*budget) < 0) {
+			return 0;
+		}
+
+		ins = bc[pc].ins;
+		op = (duk_small_uint_t) DUK_DEC_OP(ins);
+		if (op == DUK_OP_JUMP) {
+			pc = pc + 1 + (duk_int_t) DUK_DEC_ABC(ins) - (duk_int_t) DUK_BC_JUMP_BIAS;
+			continue;
+		}
+		if (op == DUK_OP_LABEL) {
+			/* Falls through past its jump slots; 'break' and
+			 * 'continue' enter the slots.
+			 */
+			if (!duk__optimize_is_dead(bc, n, pc + 1, reg, budget) ||
+			    !duk__optimize_is_dead(bc, n, pc + 2, reg, budget)) {
+				return 0;
+			}
+			pc += 3;
+			continue;
+		}
+
+		reads = duk__optimize_get_operands(ins, &write);
+		if ((reads & DUK__OPTIMIZE_UNKNOWN) || duk__optimize_match_fields(ins, reads, reg) != 0) {
+			return 0;
+		}
+		if (write != 0 && duk__optimize_get_field(ins, write) == reg) {
+			return 1;
+		}
+		if (op >= DUK_OP_RETREG && op <= DUK_OP_RETCONSTN) {
+			return 1;
+		}
+		if (op >= DUK_OP_IFTRUE_R && op <= DUK_OP_IFFALSE_C) {
+			if (!duk__optimize_is_dead(bc, n, pc + 2, reg, budget)) {
+				return 0;
+			}
+		}
+		pc++;
+	}
+}
+
+DUK_LOCAL duk_bool_t duk__optimize_is_dead_after(duk_compiler_instr *bc, duk_int_t n, duk_int_t pc, duk_regconst_t reg) {
+	duk_int_t budget = DUK__OPTIMIZE_LIVENESS_STEPS;
+	return duk__optimize_is_dead(bc, n, pc, reg, &budget);
+}
+
+/* Get constant 'idx' as a number; returns 0 if it's not a number. */
+DUK_LOCAL duk_bool_t duk__optimize_get_number_const(duk_compiler_ctx *comp_ctx, duk_regconst_t idx, duk_double_t *out_d) {
+	duk_hthread *thr = comp_ctx->thr;
+	duk_bool_t ret;
+
+	duk_get_prop_index(thr, comp_ctx->curr_func.consts_idx, (duk_uarridx_t) idx);
+	ret = duk_is_number(thr, -1);
+	*out_d = duk_get_number(thr, -1);
+	duk_pop(thr);
+	return ret;
+}
+
+/* Fold a binary operator with two constant operands into an instruction
+ * loading the result into 'reg'.  Only numeric operands and results which
+ * fit LDINT (or are booleans) are handled; returns 0 if not folded.
+ */
+DUK_LOCAL duk_bool_t duk__optimize_fold_binary(duk_compiler_ctx *comp_ctx, duk_instr_t ins, duk_instr_t *out_ins) {
+	duk_small_uint_t op;
+	duk_regconst_t reg;
+	duk_double_t d1, d2, d3;
+	duk_int32_t i1, i2;
+
+	op = (duk_small_uint_t) DUK_BC_NOREGCONST_OP(DUK_DEC_OP(ins));
+	reg = (duk_regconst_t) DUK_DEC_A(ins);
+
+	if (!duk__optimize_get_number_const(comp_ctx, (duk_regconst_t) DUK_DEC_B(ins), &d1) ||
+	    !duk__optimize_get_number_const(comp_ctx, (duk_regconst_t) DUK_DEC_C(ins), &d2)) {
+		return 0;
+	}
+
+	switch (op) {
+	case DUK_OP_EQ_RR:
+	case DUK_OP_SEQ_RR:
+		*out_ins = DUK_ENC_OP_BC(d1 == d2 ? DUK_OP_LDTRUE : DUK_OP_LDFALSE, reg);
+		return 1;
+	case DUK_OP_NEQ_RR:
+	case DUK_OP_SNEQ_RR:
+		*out_ins = DUK_ENC_OP_BC(d1 == d2 ? DUK_OP_LDFALSE : DUK_OP_LDTRUE, reg);
+		return 1;
+	case DUK_OP_GT_RR:
+		*out_ins = DUK_ENC_OP_BC(d1 > d2 ? DUK_OP_LDTRUE : DUK_OP_LDFALSE, reg);
+		return 1;
+	case DUK_OP_GE_RR:
+		*out_ins = DUK_ENC_OP_BC(d1 >= d2 ? DUK_OP_LDTRUE : DUK_OP_LDFALSE, reg);
+		return 1;
+	case DUK_OP_LT_RR:
+		*out_ins = DUK_ENC_OP_BC(d1 < d2 ? DUK_OP_LDTRUE : DUK_OP_LDFALSE, reg);
+		return 1;
+	case DUK_OP_LE_RR:
+		*out_ins = DUK_ENC_OP_BC(d1 <= d2 ? DUK_OP_LDTRUE : DUK_OP_LDFALSE, reg);
+		return 1;
+	default:
+		break;
+	}
+
+	/* Arithmetic is only folded for int32 operands, so that ToInt32()
+	 * and ToUint32() coercions are identities.
+	 */
+	i1 = (duk_int32_t) (DUK_ISNAN(d1) || d1 < -2147483648.0 || d1 > 2147483647.0 ? 0 : d1);
+	i2 = (duk_int32_t) (DUK_ISNAN(d2) || d2 < -2147483648.0 || d2 > 2147483647.0 ? 0 : d2);
+	if ((duk_double_t) i1 != d1 || (duk_double_t) i2 != d2 ||
+	    (d1 == 0.0 && DUK_SIGNBIT(d1)) || (d2 == 0.0 && DUK_SIGNBIT(d2))) {
+		return 0;
+	}
+
+	switch (op) {
+	case DUK_OP_ADD_RR:
+		d3 = d1 + d2;
+		break;
+	case DUK_OP_SUB_RR:
+		d3 = d1 - d2;
+		break;
+	case DUK_OP_MUL_RR:
+		d3 = d1 * d2;
+		break;
+	case DUK_OP_BAND_RR:
+		d3 = (duk_double_t) (i1 & i2);
+		break;
+	case DUK_OP_BOR_RR:
+		d3 = (duk_double_t) (i1 | i2);
+		break;
+	case DUK_OP_BXOR_RR:
+		d3 = (duk_double_t) (i1 ^ i2);
+		break;
+	case DUK_OP_BASL_RR:
+		d3 = (duk_double_t) (duk_int32_t) ((duk_uint32_t) i1 << ((duk_uint32_t) i2 & 0x1fUL));
+		break;
+	case DUK_OP_BLSR_RR:
+		d3 = (duk_double_t) ((duk_uint32_t) i1 >> ((duk_uint32_t) i2 & 0x1fUL));
+		break;
+	case DUK_OP_BASR_RR:
+		d3 = (duk_double_t) (i1 >> ((duk_uint32_t) i2 & 0x1fUL));
+		break;
+	default:
+		return 0;
+	}
+
+	if (!(d3 >= -(duk_double_t) DUK_BC_LDINT_BIAS && d3 < (duk_double_t) DUK_BC_LDINT_BIAS) ||
+	    d3 != (duk_double_t) (duk_int32_t) d3 || (d3 == 0.0 && DUK_SIGNBIT(d3))) {
+		return 0;
+	}
+	*out_ins = DUK_ENC_OP_A_BC(DUK_OP_LDINT, reg, (duk_int32_t) d3 + DUK_BC_LDINT_BIAS);
+	return 1;
+}
+
+/* Fold a unary operator applied to the value loaded by LDINT 'ldint' into
+ * an instruction loading the result into the operator's target.
+ */
+DUK_LOCAL duk_bool_t duk__optimize_fold_unary(duk_instr_t ldint, duk_instr_t ins, duk_instr_t *out_ins) {
+	duk_int32_t val;
+	duk_regconst_t reg;
+
+	val = (duk_int32_t) DUK_DEC_BC(ldint) - (duk_int32_t) DUK_BC_LDINT_BIAS;
+	reg = (duk_regconst_t) DUK_DEC_A(ins);
+
+	switch (DUK_DEC_OP(ins)) {
+	case DUK_OP_BNOT:
+		val = ~val;
+		break;
+	case DUK_OP_UNM:
+		if (val == 0 || val == -DUK_BC_LDINT_BIAS) {
+			return 0;  /* -0 and 32768 don't fit LDINT */
+		}
+		val = -val;
+		break;
+	case DUK_OP_UNP:
+		break;
+	case DUK_OP_LNOT:
+		*out_ins = DUK_ENC_OP_BC(val == 0 ? DUK_OP_LDTRUE : DUK_OP_LDFALSE, reg);
+		return 1;
+	default:
+		return 0;
+	}
+
+	*out_ins = DUK_ENC_OP_A_BC(DUK_OP_LDINT, reg, val + DUK_BC_LDINT_BIAS);
+	return 1;
+}
+
+DUK_LOCAL void duk__optimize_mark(duk_compiler_instr *bc, duk_int_t n, duk_uint8_t *marks) {
+	duk_int_t i;
+	duk_bool_t changed;
+
+	duk_memzero((void *) marks, (duk_size_t) n);
+
+	for (i = 0; i < n; i++) {
+		duk_small_uint_t op = (duk_small_uint_t) DUK_DEC_OP(bc[i].ins);
+
+		if (op == DUK_OP_JUMP) {
+			duk_int_t target = i + 1 + (duk_int_t) DUK_DEC_ABC(bc[i].ins) - (duk_int_t) DUK_BC_JUMP_BIAS;
+			DUK_ASSERT(target >= 0 && target < n);
+			marks[target] |= DUK__OPTIMIZE_MARK_TARGET;
+		} else if ((op >= DUK_OP_IFTRUE_R && op <= DUK_OP_IFFALSE_C) || op == DUK_OP_NEXTENUM) {
+			/* The skip target needs no mark: the skipped instruction
+			 * is pinned, so no pair ending there is rewritten.
+			 */
+			if (i + 1 < n) {
+				marks[i + 1] |= DUK__OPTIMIZE_MARK_PINNED;
+			}
+		} else if (op == DUK_OP_LABEL || op == DUK_OP_TRYCATCH) {
+			if (i + 2 < n) {
+				marks[i + 1] |= DUK__OPTIMIZE_MARK_PINNED | DUK__OPTIMIZE_MARK_SLOT | DUK__OPTIMIZE_MARK_TARGET;
+				marks[i + 2] |= DUK__OPTIMIZE_MARK_PINNED | DUK__OPTIMIZE_MARK_SLOT | DUK__OPTIMIZE_MARK_TARGET;
+			}
+		} else if (op == DUK_OP_SWITCHINT || op == DUK_OP_SWITCHSTR) {
+			/* The whole dispatch table is addressed relative to the
+			 * SWITCHxxx and stays as it is; its jumps are marked above
+			 * like any other.
+			 */
+			duk_int_t end = i + 1 + DUK_BC_SWITCH_TABLE_LENGTH(bc[i].ins, bc[i + 1].ins);
+			DUK_ASSERT(end <= n);
+			while (++i < end) {
+				marks[i] |= DUK__OPTIMIZE_MARK_PINNED | DUK__OPTIMIZE_MARK_SLOT | DUK__OPTIMIZE_MARK_TARGET;
+				if (DUK_DEC_OP(bc[i].ins) == DUK_OP_JUMP) {
+					duk_int_t target = i + 1 + (duk_int_t) DUK_DEC_ABC(bc[i].ins) - (duk_int_t) DUK_BC_JUMP_BIAS;
+					marks[target] |= DUK__OPTIMIZE_MARK_TARGET;
+				}
+			}
+			i--;
+		}
+	}
+
+	/* Reachability: iterate until backward jumps stop adding anything. */
+	marks[0] |= DUK__OPTIMIZE_MARK_REACHABLE;
+	do {
+		changed = 0;
+		for (i = 0; i < n; i++) {
+			duk_small_uint_t op;
+			duk_int_t succ[3];
+			duk_small_uint_t num_succ;
+			duk_small_uint_t j;
+
+			if (!(marks[i] & DUK__OPTIMIZE_MARK_REACHABLE)) {
+				continue;
+			}
+
+			op = (duk_small_uint_t) DUK_DEC_OP(bc[i].ins);
+			num_succ = 0;
+			if (op == DUK_OP_SWITCHINT || op == DUK_OP_SWITCHSTR) {
+				/* Every jump in the table is a successor; the data
+				 * in between is marked too, so it's kept.
+				 */
+				duk_int_t k = i + 1 + DUK_BC_SWITCH_TABLE_LENGTH(bc[i].ins, bc[i + 1].ins);
+				while (--k > i) {
+					marks[k] |= DUK__OPTIMIZE_MARK_REACHABLE;
+				}
+			} else if (op == DUK_OP_JUMP) {
+				succ[num_succ++] = i + 1 + (duk_int_t) DUK_DEC_ABC(bc[i].ins) - (duk_int_t) DUK_BC_JUMP_BIAS;
+			} else if ((op >= DUK_OP_RETREG && op <= DUK_OP_RETCONSTN) || op == DUK_OP_THROW) {
+				;
+			} else {
+				succ[num_succ++] = i + 1;
+				if ((op >= DUK_OP_IFTRUE_R && op <= DUK_OP_IFFALSE_C) || op == DUK_OP_NEXTENUM ||
+				    op == DUK_OP_LABEL || op == DUK_OP_TRYCATCH) {
+					succ[num_succ++] = i + 2;
+				}
+				if (op == DUK_OP_LABEL || op == DUK_OP_TRYCATCH) {
+					succ[num_succ++] = i + 3;
+				}
+			}
+
+			for (j = 0; j < num_succ; j++) {
+				if (succ[j] < n && !(marks[succ[j]] & DUK__OPTIMIZE_MARK_REACHABLE)) {
+					marks[succ[j]] |= DUK__OPTIMIZE_MARK_REACHABLE;
+					if (succ[j] < i) {
+						changed = 1;
+					}
+				}
+			}
+		}
+	} while (changed);
+}
+
+/* Apply the rewrites once over the whole function; returns the number of
+ * rewrites made.
+ */
+DUK_LOCAL duk_int_t duk__optimize_rewrite(duk_compiler_ctx *comp_ctx, duk_compiler_instr *bc, duk_int_t n, duk_uint8_t *marks) {
+	duk_regconst_t temp_first;
+	duk_int_t count = 0;
+	duk_int_t i;
+
+	temp_first = comp_ctx->curr_func.temp_first;
+
+	for (i = 0; i < n; i++) {
+		duk_instr_t ins;
+		duk_instr_t next;
+		duk_instr_t folded;
+		duk_small_uint_t op;
+		duk_small_uint_t next_op;
+		duk_small_uint_t reads;
+		duk_small_uint_t write;
+		duk_small_uint_t next_reads;
+		duk_small_uint_t next_write;
+		duk_regconst_t reg;
+
+		if (!(marks[i] & DUK__OPTIMIZE_MARK_REACHABLE)) {
+			continue;
+		}
+
+		ins = bc[i].ins;
+		op = (duk_small_uint_t) DUK_DEC_OP(ins);
+
+		if (op == DUK_OP_JUMP) {
+			duk_int_t target = i + 1 + (duk_int_t) DUK_DEC_ABC(ins) - (duk_int_t) DUK_BC_JUMP_BIAS;
+			duk_small_uint_t target_op = (duk_small_uint_t) DUK_DEC_OP(bc[target].ins);
+
+			if (marks[i] & DUK__OPTIMIZE_MARK_SLOT) {
+				continue;
+			}
+			if (target_op >= DUK_OP_RETREG && target_op <= DUK_OP_RETCONSTN) {
+				/* JUMP to a return: return directly. */
+				bc[i].ins = bc[target].ins;
+				count++;
+			} else if (target == i + 1 && !(marks[i] & DUK__OPTIMIZE_MARK_PINNED)) {
+				/* JUMP to the next instruction. */
+				bc[i].ins = DUK_ENC_OP(DUK_OP_NOP);
+				count++;
+			}
+			continue;
+		}
+
+		if (op >= DUK_OP_EQ_RR && DUK_BC_NOREGCONST_OP(op) <= DUK_OP_IN_RR &&
+		    !(op >= DUK_OP_IFTRUE_R && op <= DUK_OP_IFFALSE_C) &&
+		    (op & (DUK_BC_REGCONST_B | DUK_BC_REGCONST_C)) == (DUK_BC_REGCONST_B | DUK_BC_REGCONST_C)) {
+			/* Binary operator on two constants. */
+			if (duk__optimize_fold_binary(comp_ctx, ins, &folded)) {
+				bc[i].ins = folded;
+				count++;
+			}
+			continue;
+		}
+
+		if (i + 2 >= n) {
+			continue;
+		}
+		next = bc[i + 1].ins;
+		next_op = (duk_small_uint_t) DUK_DEC_OP(next);
+
+		if (op >= DUK_OP_IFTRUE_R && op <= DUK_OP_IFFALSE_C) {
+			/* IFxxx; JUMP +1; insn -> IFyyy; insn.  The moved
+			 * instruction must not skip or own jump slots itself,
+			 * nor jump to itself, because the NOP left behind it
+			 * gets removed.
+			 */
+			duk_small_uint_t moved_op = (duk_small_uint_t) DUK_DEC_OP(bc[i + 2].ins);
+
+			if (next == DUK_ENC_OP_ABC(DUK_OP_JUMP, 1 + DUK_BC_JUMP_BIAS) &&
+			    !(marks[i + 1] & DUK__OPTIMIZE_MARK_TARGET) &&
+			    !(marks[i + 2] & DUK__OPTIMIZE_MARK_TARGET) &&
+			    !(moved_op >= DUK_OP_IFTRUE_R && moved_op <= DUK_OP_IFFALSE_C) &&
+			    moved_op != DUK_OP_NEXTENUM && moved_op != DUK_OP_LABEL && moved_op != DUK_OP_TRYCATCH &&
+			    bc[i + 2].ins != DUK_ENC_OP_ABC(DUK_OP_JUMP, -1 + DUK_BC_JUMP_BIAS)) {
+				bc[i].ins = ins ^ (DUK_OP_IFTRUE_R ^ DUK_OP_IFFALSE_R);
+				bc[i + 1] = bc[i + 2];
+				if (moved_op == DUK_OP_JUMP) {
+					bc[i + 1].ins += (duk_instr_t) 1 << DUK_BC_SHIFT_ABC;  /* same target from one slot earlier */
+				}
+				bc[i + 2].ins = DUK_ENC_OP(DUK_OP_NOP);
+				count++;
+			}
+			continue;
+		}
+
+		/* The rest rewrite pairs where the first instruction writes
+		 * a temporary.  It must not be skippable, since the second one
+		 * would then see the temporary's old value.
+		 */
+		if (marks[i] & (DUK__OPTIMIZE_MARK_PINNED | DUK__OPTIMIZE_MARK_SLOT)) {
+			continue;
+		}
+		if (marks[i + 1] & DUK__OPTIMIZE_MARK_TARGET) {
+			continue;
+		}
+
+		reads = duk__optimize_get_operands(ins, &write);
+		if ((reads & DUK__OPTIMIZE_UNKNOWN) || write == 0) {
+			continue;
+		}
+		reg = duk__optimize_get_field(ins, write);
+		if (reg < temp_first) {
+			continue;
+		}
+		next_reads = duk__optimize_get_operands(next, &next_write);
+
+		if ((next_op == DUK_OP_IFTRUE_R || next_op == DUK_OP_IFFALSE_R) && DUK_DEC_BC(next) == (duk_uint_t) reg &&
+		    (op == DUK_OP_LDTRUE || op == DUK_OP_LDFALSE || op == DUK_OP_LDNULL ||
+		     op == DUK_OP_LDUNDEF || op == DUK_OP_LDINT)) {
+			/* IFxxx on a known value: jump over the next
+			 * instruction or fall through to it.
+			 */
+			duk_bool_t truthy;
+
+			truthy = (op == DUK_OP_LDTRUE ||
+			          (op == DUK_OP_LDINT && (duk_int32_t) DUK_DEC_BC(ins) != (duk_int32_t) DUK_BC_LDINT_BIAS));
+			if (truthy == (next_op == DUK_OP_IFTRUE_R)) {
+				bc[i + 1].ins = DUK_ENC_OP_ABC(DUK_OP_JUMP, 1 + DUK_BC_JUMP_BIAS);
+			} else {
+				bc[i + 1].ins = DUK_ENC_OP(DUK_OP_NOP);
+			}
+			if (duk__optimize_is_dead_after(bc, n, i + 1, reg)) {
+				bc[i].ins = DUK_ENC_OP(DUK_OP_NOP);
+			}
+			count++;
+			continue;
+		}
+
+		if (op == DUK_OP_LDINT && (next_op == DUK_OP_BNOT || next_op == DUK_OP_UNM ||
+		                           next_op == DUK_OP_UNP || next_op == DUK_OP_LNOT) &&
+		    DUK_DEC_BC(next) == (duk_uint_t) reg &&
+		    duk__optimize_fold_unary(ins, next, &folded)) {
+			/* Unary operator on an integer. */
+			bc[i + 1].ins = folded;
+			if ((duk_regconst_t) DUK_DEC_A(next) == reg || duk__optimize_is_dead_after(bc, n, i + 2, reg)) {
+				bc[i].ins = DUK_ENC_OP(DUK_OP_NOP);
+			}
+			count++;
+			continue;
+		}
+
+		if (op == DUK_OP_LNOT && (next_op == DUK_OP_IFTRUE_R || next_op == DUK_OP_IFFALSE_R) &&
+		    DUK_DEC_BC(next) == (duk_uint_t) reg &&
+		    duk__optimize_is_dead_after(bc, n, i + 2, reg) &&
+		    duk__optimize_is_dead_after(bc, n, i + 3, reg)) {
+			/* LNOT only feeding an IFxxx: test the operand directly. */
+			bc[i].ins = DUK_ENC_OP(DUK_OP_NOP);
+			bc[i + 1].ins = DUK_ENC_OP_BC(next_op ^ (DUK_OP_IFTRUE_R ^ DUK_OP_IFFALSE_R), DUK_DEC_BC(ins));
+			count++;
+			continue;
+		}
+
+		if (next_op == DUK_OP_LDREG && DUK_DEC_BC(next) == (duk_uint_t) reg &&
+		    (duk_regconst_t) DUK_DEC_A(next) != reg &&
+		    duk__optimize_is_dead_after(bc, n, i + 2, reg) &&
+		    duk__optimize_set_field(&ins, write, (duk_regconst_t) DUK_DEC_A(next))) {
+			/* Value produced into a temporary and then copied:
+			 * produce it in the copy's target directly.
+			 */
+			bc[i].ins = ins;
+			bc[i + 1].ins = DUK_ENC_OP(DUK_OP_NOP);
+			count++;
+			continue;
+		}
+
+		if (op == DUK_OP_LDREG && (duk_regconst_t) DUK_DEC_BC(ins) != reg &&
+		    next_reads != 0 && !(next_reads & DUK__OPTIMIZE_UNKNOWN) &&
+		    duk__optimize_match_fields(next, next_reads, reg) == next_reads &&
+		    (next_write != 0 || next_op == DUK_OP_IFTRUE_R || next_op == DUK_OP_IFFALSE_R || next_op == DUK_OP_RETREG)) {
+			/* Temporary copy of a register, read by an instruction
+			 * which reads no other register (so no user code can
+			 * run between reading its operands): read the register
+			 * directly.
+			 */
+			duk_bool_t dead;
+			duk_small_uint_t field;
+
+			if (next_op == DUK_OP_RETREG) {
+				dead = 1;
+			} else if (next_write != 0 && duk__optimize_get_field(next, next_write) == reg) {
+				dead = 1;
+			} else if (next_write == 0) {
+				dead = duk__optimize_is_dead_after(bc, n, i + 2, reg) &&
+				       duk__optimize_is_dead_after(bc, n, i + 3, reg);
+			} else {
+				dead = duk__optimize_is_dead_after(bc, n, i + 2, reg);
+			}
+
+			for (field = DUK__OPTIMIZE_FIELD_A; dead && field <= DUK__OPTIMIZE_FIELD_BC; field <<= 1) {
+				if ((next_reads & field) && !duk__optimize_set_field(&next, field, (duk_regconst_t) DUK_DEC_BC(ins))) {
+					dead = 0;
+				}
+			}
+			if (dead) {
+				bc[i].ins = DUK_ENC_OP(DUK_OP_NOP);
+				bc[i + 1].ins = next;
+				count++;
+			}
+			continue;
+		}
+	}
+
+	return count;
+}
+
+/* Remove unreachable instructions and NOPs which aren't pinned, relocating
+ * jumps.  Returns the number of instructions removed.
+ */
+DUK_LOCAL duk_int_t duk__optimize_compact(duk_compiler_instr *bc, duk_int_t n, duk_uint8_t *marks, duk_int_t *new_pc) {
+	duk_int_t i, j;
+
+	for (i = 0, j = 0; i < n; i++) {
+		new_pc[i] = j;
+		if ((marks[i] & DUK__OPTIMIZE_MARK_REACHABLE) &&
+		    !(DUK_DEC_OP(bc[i].ins) == DUK_OP_NOP && !(marks[i] & DUK__OPTIMIZE_MARK_PINNED))) {
+			j++;
+		} else {
+			marks[i] = (duk_uint8_t) (marks[i] & ~DUK__OPTIMIZE_MARK_REACHABLE);
+		}
+	}
+	new_pc[n] = j;
+
+	if (j == n) {
+		return 0;
+	}
+
+	for (i = 0; i < n; i++) {
+		if (!(marks[i] & DUK__OPTIMIZE_MARK_REACHABLE)) {
+			continue;
+		}
+		if (DUK_DEC_OP(bc[i].ins) == DUK_OP_JUMP) {
+			duk_int_t target = i + 1 + (duk_int_t) DUK_DEC_ABC(bc[i].ins) - (duk_int_t) DUK_BC_JUMP_BIAS;
+			bc[i].ins = DUK_ENC_OP_ABC(DUK_OP_JUMP, new_pc[target] - (new_pc[i] + 1) + DUK_BC_JUMP_BIAS);
+		}
+		bc[new_pc[i]] = bc[i];
+	}
+
+	return n - j;
+}
+
+DUK_LOCAL void duk__optimize_bytecode(duk_compiler_ctx *comp_ctx) {
+	duk_hthread *thr = comp_ctx->thr;
+	duk_compiler_instr *bc;
+	duk_int_t *new_pc;
+	duk_uint8_t *marks;
+	duk_int_t n;
+	duk_small_uint_t round;
+
+	n = (duk_int_t) (DUK_BW_GET_SIZE(thr, &comp_ctx->curr_func.bw_code) / sizeof(duk_compiler_instr));
+	if (n == 0) {
+		return;
+	}
+
+	duk_require_stack(thr, 2);  /* work buffer, constant lookups */
+	new_pc = (duk_int_t *) duk_push_fixed_buffer_nozero(thr, (duk_size_t) (n + 1) * (sizeof(duk_int_t) + 1));
+	marks = (duk_uint8_t *) (new_pc + n + 1);
+
+	for (round = 0; round < DUK__OPTIMIZE_MAXROUNDS; round++) {
+		duk_int_t count_rewrite;
+		duk_int_t count_removed;
+
+		bc = (duk_compiler_instr *) (void *) DUK_BW_GET_BASEPTR(thr, &comp_ctx->curr_func.bw_code);
+
+		duk__optimize_mark(bc, n, marks);
+		count_rewrite = duk__optimize_rewrite(comp_ctx, bc, n, marks);
+		count_removed = duk__optimize_compact(bc, n, marks, new_pc);
+
+		DUK_DD(DUK_DDPRINT("bytecode optimizer round %ld: %ld rewrites, %ld instructions removed",
+		                   (long) (round + 1), (long) count_rewrite, (long) count_removed));
+
+		n -= count_removed;
+		DUK_BW_SET_SIZE(thr, &comp_ctx->curr_func.bw_code, (duk_size_t) n * sizeof(duk_compiler_instr));
+
+		if (count_rewrite == 0 && count_removed == 0) {
+			break;
+		}
+	}
+
+	duk_pop(thr);
+}
+
 /*
  *  Intermediate value helpers
  */
@@ -71186,6 +72803,11 @@ DUK_LOCAL void duk__parse_switch_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *re
 	duk_int_t pc_prevcase = -1;
 	duk_int_t pc_prevstmt = -1;
 	duk_int_t pc_default = -1;   /* -1 == not set, -2 == pending (next statement list) */
+	duk_int_t pc_first;          /* start of the case chain */
+	duk_idx_t idx_cases;         /* (constant, body pc) pairs for a dispatch table */
+	duk_int_t num_cases = 0;
+	duk_bool_t table_ok;         /* all cases so far are constants */
+	duk_int_t pc_table;
 
 	/* Note: negative pc values are ignored when patching jumps, so no explicit checks needed */
 
@@ -71223,6 +72845,13 @@ DUK_LOCAL void duk__parse_switch_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *re
 
 	temp_at_loop = DUK__GETTEMP(comp_ctx);
 
+	/* Cases are recorded for a dispatch table, see duk__emit_switch_table(). */
+	duk_require_stack(thr, 1);
+	duk_push_dynamic_buffer(thr, 0);
+	idx_cases = duk_get_top_index(thr);
+	table_ok = DUK__ISREG(rc_switch);
+	pc_first = duk__get_current_pc(comp_ctx);
+
 	for (;;) {
 		duk_int_t num_stmts;
 		duk_small_uint_t tok;
@@ -71239,6 +72868,8 @@ DUK_LOCAL void duk__parse_switch_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *re
 		 */
 
 		if (comp_ctx->curr_token.t == DUK_TOK_CASE) {
+			duk_int_t pc_case;
+
 			/*
 			 *  Case clause.
 			 *
@@ -71251,9 +72882,17 @@ DUK_LOCAL void duk__parse_switch_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *re
 			                                               */
 
 			duk__advance(comp_ctx);
+			pc_case = duk__get_current_pc(comp_ctx);
 			rc_case = duk__exprtop_toregconst(comp_ctx, res, DUK__BP_FOR_EXPR /*rbp_flags*/);
 			duk__advance_expect(comp_ctx, DUK_TOK_COLON);
 
+			/* A case value which is a constant and emitted no code can't
+			 * have side effects.
+			 */
+			if (!DUK__ISCONST(rc_case) || duk__get_current_pc(comp_ctx) != pc_case) {
+				table_ok = 0;
+			}
+
 			reg_temp = DUK__ALLOCTEMP(comp_ctx);
 			duk__emit_a_b_c(comp_ctx,
 			                DUK_OP_SEQ | DUK__EMIT_FLAG_BC_REGCONST,
@@ -71265,6 +72904,15 @@ DUK_LOCAL void duk__parse_switch_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *re
 			/* jump to next case clause */
 			pc_prevcase = duk__emit_jump_empty(comp_ctx);  /* no match, next case */
 
+			if (table_ok) {
+				duk_int_t *cases;
+
+				cases = (duk_int_t *) duk_resize_buffer(thr, idx_cases, (duk_size_t) (num_cases + 1) * 2 * sizeof(duk_int_t));
+				cases[num_cases * 2] = (duk_int_t) (rc_case & ~DUK__CONST_MARKER);
+				cases[num_cases * 2 + 1] = duk__get_current_pc(comp_ctx);
+				num_cases++;
+			}
+
 			/* statements go here (if any) on next loop */
 		} else if (comp_ctx->curr_token.t == DUK_TOK_DEFAULT) {
 			/*
@@ -71344,6 +72992,19 @@ DUK_LOCAL void duk__parse_switch_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *re
 	comp_ctx->curr_func.allow_regexp_in_adv = 1;
 	duk__advance(comp_ctx);  /* Allow RegExp as part of next stmt. */
 
+	/* Dispatch table, if the cases suit one.  The last clause ends in a
+	 * jump, so the table isn't entered by falling through to it.
+	 */
+	pc_table = -1;
+	if (table_ok) {
+		pc_table = duk__emit_switch_table(comp_ctx,
+		                                  rc_switch,
+		                                  (const duk_int_t *) duk_get_buffer(thr, idx_cases, NULL),
+		                                  num_cases,
+		                                  pc_default);
+	}
+	duk_pop(thr);
+
 	/* default case control flow patchup; note that if pc_prevcase < 0
 	 * (i.e. no case clauses), control enters default case automatically.
 	 */
@@ -71362,6 +73023,11 @@ DUK_LOCAL void duk__parse_switch_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *re
 	 */
 	duk__patch_jump_here(comp_ctx, pc_prevstmt);
 
+	/* start of the case chain, which is now dead code */
+	if (pc_table >= 0) {
+		duk__patch_jump(comp_ctx, pc_first, pc_table);
+	}
+
 	/* continue jump not patched, an INVALID opcode remains there */
 	duk__patch_jump_here(comp_ctx, pc_label_site + 1);  /* break jump */
 
@@ -73151,11 +74817,16 @@ DUK_LOCAL void duk__parse_func_body(duk_compiler_ctx *comp_ctx, duk_bool_t expec
 	}
 
 	/*
-	 *  Peephole optimize JUMP chains.
+	 *  Peephole optimize JUMP chains, and run the bytecode optimizer
+	 *  if requested.
 	 */
 
 	duk__peephole_optimize_bytecode(comp_ctx);
 
+	if (comp_ctx->optimize) {
+		duk__optimize_bytecode(comp_ctx);
+	}
+
 	/*
 	 *  comp_ctx->curr_func is now ready to be converted into an actual
 	 *  function template.
@@ -73560,6 +75231,7 @@ DUK_LOCAL duk_ret_t duk__js_compile_raw(duk_hthread *thr, void *udata) {
 	comp_ctx->tok21_idx = entry_top + 3;
 	comp_ctx->tok22_idx = entry_top + 4;
 	comp_ctx->recursion_limit = DUK_USE_COMPILER_RECLIMIT;
+	comp_ctx->optimize = (flags & DUK_COMPILE_OPTIMIZE ? 1 : 0);
 
 	/* comp_ctx->lex has been pre-initialized by caller: it has been
 	 * zeroed and input/input_length has been set.
@@ -73747,6 +75419,17 @@ DUK_INTERNAL void duk_js_compile(duk_hthread *thr, const duk_uint8_t *src_buffer
 #undef DUK__MK_LBP
 #undef DUK__MK_LBP_FLAGS
 #undef DUK__OBJ_LIT_KEY_GET
+#undef DUK__OPTIMIZE_FIELD_A
+#undef DUK__OPTIMIZE_FIELD_B
+#undef DUK__OPTIMIZE_FIELD_BC
+#undef DUK__OPTIMIZE_FIELD_C
+#undef DUK__OPTIMIZE_LIVENESS_STEPS
+#undef DUK__OPTIMIZE_MARK_PINNED
+#undef DUK__OPTIMIZE_MARK_REACHABLE
+#undef DUK__OPTIMIZE_MARK_SLOT
+#undef DUK__OPTIMIZE_MARK_TARGET
+#undef DUK__OPTIMIZE_MAXROUNDS
+#undef DUK__OPTIMIZE_UNKNOWN
 #undef DUK__OBJ_LIT_KEY_PLAIN
 #undef DUK__OBJ_LIT_KEY_SET
 #undef DUK__PARSE_EXPR_SLOTS
@@ -75798,6 +77481,20 @@ DUK_LOCAL DUK__NOINLINE_PERF DUK_COLD duk_small_uint_t duk__executor_interrupt(d
 	}
 #endif  /* DUK_USE_DEBUGGER_SUPPORT */
 
+	/*
+	 *  Application interrupt handler
+	 *
+	 *  The handler may use the value stack but must leave it balanced,
+	 *  and must not throw.  Nested interrupts are suppressed by the
+	 *  INTERRUPT_RUNNING flag, so any calls it makes run uninterrupted.
+	 */
+
+	if (thr->heap->interrupt_func != NULL) {
+		thr->heap->interrupt_func((duk_context *) thr, thr->heap->interrupt_udata);
+		DUK_ASSERT(act == thr->callstack_curr);
+		ctr = thr->heap->interrupt_interval;
+	}
+
 	/*
 	 *  Update the interrupt counter
 	 */
@@ -76796,6 +78493,139 @@ DUK_INTERNAL void duk_js_execute_bytecode(duk_hthread *exec_thr) {
 	DUK_WO_NORETURN(return;);
 }
 
+#if defined(DUK_USE_EXEC_PROPCACHE_SIZE)
+/* Property access cache.  Objects built by the same code get their keys
+ * in the same order, so the entry part index where a call site last found
+ * its key is a good guess for the next receiver too.  A guess is only used
+ * if the receiver really has the key at that index as a plain own data
+ * property; anything else (prototype hits, accessors, exotic index keys,
+ * non-object bases) goes through the generic lookup, which reports back
+ * the index for the next time.
+ */
+#define DUK__PROPCACHE_SLOT(heap,pc) \
+	((heap)->propcache[((duk_uintptr_t) (pc) / sizeof(duk_instr_t)) & (DUK_USE_EXEC_PROPCACHE_SIZE - 1)])
+
+DUK_LOCAL DUK_ALWAYS_INLINE duk_int_t duk__propcache_find(duk_heap *heap, const duk_uint16_t *slot, duk_hobject *obj, duk_hstring *key, duk_small_uint_t required_flags) {
+	duk_hstring **keys;
+	duk_uint_fast32_t e_next;
+	duk_small_uint_t i;
+
+	if (DUK_HSTRING_HAS_ARRIDX(key)) {
+		/* Arguments and buffer objects have exotic index behavior. */
+		return -1;
+	}
+#if !defined(DUK_USE_NONSTD_FUNC_CALLER_PROPERTY)
+	if (key == DUK_HEAP_STRING_CALLER(heap)) {
+		return -1;
+	}
+#endif
+#if defined(DUK_USE_ES6_PROXY)
+	if (DUK_HOBJECT_HAS_EXOTIC_PROXYOBJ(obj)) {
+		return -1;
+	}
+#endif
+	keys = DUK_HOBJECT_E_GET_KEY_BASE(heap, obj);
+	e_next = DUK_HOBJECT_GET_ENEXT(obj);
+	for (i = 0; i < 2; i++) {
+		duk_uint_fast32_t e_idx = slot[i];
+		if (e_idx < e_next && keys[e_idx] == key &&
+		    (DUK_HOBJECT_E_GET_FLAGS(heap, obj, e_idx) & (DUK_PROPDESC_FLAG_ACCESSOR | required_flags)) == required_flags) {
+			heap->hs_propcache_hit++;
+			return (duk_int_t) e_idx;
+		}
+	}
+	return -1;
+}
+
+DUK_LOCAL DUK_ALWAYS_INLINE duk_int_t duk__propcache_lookup(duk_heap *heap, const duk_uint16_t *slot, duk_tval *tv_obj, duk_tval *tv_key, duk_small_uint_t required_flags) {
+	if (!DUK_TVAL_IS_OBJECT(tv_obj) || !DUK_TVAL_IS_STRING(tv_key)) {
+		return -1;
+	}
+	return duk__propcache_find(heap, slot, DUK_TVAL_GET_OBJECT(tv_obj), DUK_TVAL_GET_STRING(tv_key), required_flags);
+}
+
+/* Identifier lookups use the same cache when the activation's scope chain
+ * has nothing but the global environment left to search: global code, or
+ * a function declared at the top level that hasn't needed an environment
+ * record of its own (no closures, eval, catch or with).  Its register
+ * bindings can't shadow the name, since the generic lookup would have
+ * found them instead of filling the hint.  Returns the global object's
+ * property value slot, or NULL.
+ */
+DUK_LOCAL DUK_ALWAYS_INLINE duk_tval *duk__varcache_lookup(duk_hthread *thr, duk_activation *act, const duk_uint16_t *slot, duk_hstring *name, duk_small_uint_t required_flags) {
+	duk_hobject *env;
+	duk_hobject *target;
+	duk_int_t e_idx;
+
+	env = act->lex_env;
+	if (env == NULL) {
+		DUK_ASSERT(DUK_HOBJECT_IS_COMPFUNC(DUK_ACT_GET_FUNC(act)));
+		env = DUK_HCOMPFUNC_GET_LEXENV(thr->heap, (duk_hcompfunc *) DUK_ACT_GET_FUNC(act));
+		if (env == NULL) {
+			env = thr->builtins[DUK_BIDX_GLOBAL_ENV];
+		}
+	}
+	if (env != thr->builtins[DUK_BIDX_GLOBAL_ENV]) {
+		return NULL;
+	}
+
+	DUK_ASSERT(DUK_HOBJECT_GET_CLASS_NUMBER(env) == DUK_HOBJECT_CLASS_OBJENV);
+	target = ((duk_hobjenv *) env)->target;
+	DUK_ASSERT(target != NULL);
+	e_idx = duk__propcache_find(thr->heap, slot, target, name, required_flags);
+	if (e_idx < 0) {
+		return NULL;
+	}
+	return DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(thr->heap, target, e_idx);
+}
+
+DUK_LOCAL DUK_ALWAYS_INLINE void duk__propcache_update(duk_heap *heap, duk_uint16_t *slot) {
+	duk_int_t e_idx = heap->propcache_e_idx;
+
+	/* Only count misses the cache could have served. */
+	if (e_idx >= 0 && e_idx < 0xffffL) {
+		heap->hs_propcache_miss++;
+		if (slot[0] != (duk_uint16_t) e_idx) {
+			slot[1] = slot[0];
+			slot[0] = (duk_uint16_t) e_idx;
+		}
+	}
+}
+#endif  /* DUK_USE_EXEC_PROPCACHE_SIZE */
+
+/* Opcode dispatch.  With DUK_USE_EXEC_COMPUTED_GOTO on GCC and Clang, the
+ * executor jumps to opcode handlers through a table of label addresses
+ * (labels as values) instead of the switch.  The compiler then copies the
+ * short fetch-and-dispatch sequence to the end of every handler, so each
+ * opcode gets its own indirect branch and the branch predictor can learn
+ * which opcode tends to follow it.  The switch stays: handlers still end
+ * with 'break', and other compilers and DUK_USE_EXEC_PREFER_SIZE builds
+ * dispatch through it as before.  The table needs every opcode to have a
+ * case label, which the non-size-optimized executor provides.
+ */
+#if defined(DUK_USE_EXEC_COMPUTED_GOTO) && !defined(DUK_USE_EXEC_PREFER_SIZE) && (defined(DUK_F_GCC) || defined(DUK_F_CLANG))
+#define DUK__COMPUTED_GOTO
+#define DUK__CASE(op) case op: duk__label_##op:
+#define DUK__OPLABEL(op) &&duk__label_##op
+#else
+#define DUK__CASE(op) case op:
+#endif
+
+/* End of an opcode handler.  When nothing needs to run between opcodes
+ * (interrupt counter, assertions, debug prints), threaded dispatch fetches
+ * and jumps to the next handler right here; otherwise this is a 'break'
+ * back to the top of the dispatch loop.
+ */
+#if defined(DUK__COMPUTED_GOTO) && !defined(DUK_USE_INTERRUPT_COUNTER) && !defined(DUK_USE_ASSERTIONS) && !defined(DUK_USE_DEBUG)
+#define DUK__NEXT() { \
+		ins = *curr_pc++; \
+		op = (duk_uint8_t) DUK_DEC_OP(ins); \
+		goto *duk__opcode_labels[op]; \
+	}
+#else
+#define DUK__NEXT() break
+#endif
+
 /* Inner executor, performance critical. */
 DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *entry_thread, duk_activation *entry_act) {
 	/* Current PC, accessed by other functions through thr->ptr_to_curr_pc.
@@ -76826,6 +78656,268 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 	duk_size_t valstack_top_base;    /* valstack top, should match before interpreting each op (no leftovers) */
 #endif
 
+#if defined(DUK__COMPUTED_GOTO)
+	/* Handler for each opcode, in opcode order. */
+	static const void * const duk__opcode_labels[256] = {
+		DUK__OPLABEL(DUK_OP_LDREG),
+		DUK__OPLABEL(DUK_OP_STREG),
+		DUK__OPLABEL(DUK_OP_JUMP),
+		DUK__OPLABEL(DUK_OP_LDCONST),
+		DUK__OPLABEL(DUK_OP_LDINT),
+		DUK__OPLABEL(DUK_OP_LDINTX),
+		DUK__OPLABEL(DUK_OP_LDTHIS),
+		DUK__OPLABEL(DUK_OP_LDUNDEF),
+		DUK__OPLABEL(DUK_OP_LDNULL),
+		DUK__OPLABEL(DUK_OP_LDTRUE),
+		DUK__OPLABEL(DUK_OP_LDFALSE),
+		DUK__OPLABEL(DUK_OP_GETVAR),
+		DUK__OPLABEL(DUK_OP_BNOT),
+		DUK__OPLABEL(DUK_OP_LNOT),
+		DUK__OPLABEL(DUK_OP_UNM),
+		DUK__OPLABEL(DUK_OP_UNP),
+		DUK__OPLABEL(DUK_OP_EQ_RR),
+		DUK__OPLABEL(DUK_OP_EQ_CR),
+		DUK__OPLABEL(DUK_OP_EQ_RC),
+		DUK__OPLABEL(DUK_OP_EQ_CC),
+		DUK__OPLABEL(DUK_OP_NEQ_RR),
+		DUK__OPLABEL(DUK_OP_NEQ_CR),
+		DUK__OPLABEL(DUK_OP_NEQ_RC),
+		DUK__OPLABEL(DUK_OP_NEQ_CC),
+		DUK__OPLABEL(DUK_OP_SEQ_RR),
+		DUK__OPLABEL(DUK_OP_SEQ_CR),
+		DUK__OPLABEL(DUK_OP_SEQ_RC),
+		DUK__OPLABEL(DUK_OP_SEQ_CC),
+		DUK__OPLABEL(DUK_OP_SNEQ_RR),
+		DUK__OPLABEL(DUK_OP_SNEQ_CR),
+		DUK__OPLABEL(DUK_OP_SNEQ_RC),
+		DUK__OPLABEL(DUK_OP_SNEQ_CC),
+		DUK__OPLABEL(DUK_OP_GT_RR),
+		DUK__OPLABEL(DUK_OP_GT_CR),
+		DUK__OPLABEL(DUK_OP_GT_RC),
+		DUK__OPLABEL(DUK_OP_GT_CC),
+		DUK__OPLABEL(DUK_OP_GE_RR),
+		DUK__OPLABEL(DUK_OP_GE_CR),
+		DUK__OPLABEL(DUK_OP_GE_RC),
+		DUK__OPLABEL(DUK_OP_GE_CC),
+		DUK__OPLABEL(DUK_OP_LT_RR),
+		DUK__OPLABEL(DUK_OP_LT_CR),
+		DUK__OPLABEL(DUK_OP_LT_RC),
+		DUK__OPLABEL(DUK_OP_LT_CC),
+		DUK__OPLABEL(DUK_OP_LE_RR),
+		DUK__OPLABEL(DUK_OP_LE_CR),
+		DUK__OPLABEL(DUK_OP_LE_RC),
+		DUK__OPLABEL(DUK_OP_LE_CC),
+		DUK__OPLABEL(DUK_OP_IFTRUE_R),
+		DUK__OPLABEL(DUK_OP_IFTRUE_C),
+		DUK__OPLABEL(DUK_OP_IFFALSE_R),
+		DUK__OPLABEL(DUK_OP_IFFALSE_C),
+		DUK__OPLABEL(DUK_OP_ADD_RR),
+		DUK__OPLABEL(DUK_OP_ADD_CR),
+		DUK__OPLABEL(DUK_OP_ADD_RC),
+		DUK__OPLABEL(DUK_OP_ADD_CC),
+		DUK__OPLABEL(DUK_OP_SUB_RR),
+		DUK__OPLABEL(DUK_OP_SUB_CR),
+		DUK__OPLABEL(DUK_OP_SUB_RC),
+		DUK__OPLABEL(DUK_OP_SUB_CC),
+		DUK__OPLABEL(DUK_OP_MUL_RR),
+		DUK__OPLABEL(DUK_OP_MUL_CR),
+		DUK__OPLABEL(DUK_OP_MUL_RC),
+		DUK__OPLABEL(DUK_OP_MUL_CC),
+		DUK__OPLABEL(DUK_OP_DIV_RR),
+		DUK__OPLABEL(DUK_OP_DIV_CR),
+		DUK__OPLABEL(DUK_OP_DIV_RC),
+		DUK__OPLABEL(DUK_OP_DIV_CC),
+		DUK__OPLABEL(DUK_OP_MOD_RR),
+		DUK__OPLABEL(DUK_OP_MOD_CR),
+		DUK__OPLABEL(DUK_OP_MOD_RC),
+		DUK__OPLABEL(DUK_OP_MOD_CC),
+		DUK__OPLABEL(DUK_OP_EXP_RR),
+		DUK__OPLABEL(DUK_OP_EXP_CR),
+		DUK__OPLABEL(DUK_OP_EXP_RC),
+		DUK__OPLABEL(DUK_OP_EXP_CC),
+		DUK__OPLABEL(DUK_OP_BAND_RR),
+		DUK__OPLABEL(DUK_OP_BAND_CR),
+		DUK__OPLABEL(DUK_OP_BAND_RC),
+		DUK__OPLABEL(DUK_OP_BAND_CC),
+		DUK__OPLABEL(DUK_OP_BOR_RR),
+		DUK__OPLABEL(DUK_OP_BOR_CR),
+		DUK__OPLABEL(DUK_OP_BOR_RC),
+		DUK__OPLABEL(DUK_OP_BOR_CC),
+		DUK__OPLABEL(DUK_OP_BXOR_RR),
+		DUK__OPLABEL(DUK_OP_BXOR_CR),
+		DUK__OPLABEL(DUK_OP_BXOR_RC),
+		DUK__OPLABEL(DUK_OP_BXOR_CC),
+		DUK__OPLABEL(DUK_OP_BASL_RR),
+		DUK__OPLABEL(DUK_OP_BASL_CR),
+		DUK__OPLABEL(DUK_OP_BASL_RC),
+		DUK__OPLABEL(DUK_OP_BASL_CC),
+		DUK__OPLABEL(DUK_OP_BLSR_RR),
+		DUK__OPLABEL(DUK_OP_BLSR_CR),
+		DUK__OPLABEL(DUK_OP_BLSR_RC),
+		DUK__OPLABEL(DUK_OP_BLSR_CC),
+		DUK__OPLABEL(DUK_OP_BASR_RR),
+		DUK__OPLABEL(DUK_OP_BASR_CR),
+		DUK__OPLABEL(DUK_OP_BASR_RC),
+		DUK__OPLABEL(DUK_OP_BASR_CC),
+		DUK__OPLABEL(DUK_OP_INSTOF_RR),
+		DUK__OPLABEL(DUK_OP_INSTOF_CR),
+		DUK__OPLABEL(DUK_OP_INSTOF_RC),
+		DUK__OPLABEL(DUK_OP_INSTOF_CC),
+		DUK__OPLABEL(DUK_OP_IN_RR),
+		DUK__OPLABEL(DUK_OP_IN_CR),
+		DUK__OPLABEL(DUK_OP_IN_RC),
+		DUK__OPLABEL(DUK_OP_IN_CC),
+		DUK__OPLABEL(DUK_OP_GETPROP_RR),
+		DUK__OPLABEL(DUK_OP_GETPROP_CR),
+		DUK__OPLABEL(DUK_OP_GETPROP_RC),
+		DUK__OPLABEL(DUK_OP_GETPROP_CC),
+		DUK__OPLABEL(DUK_OP_PUTPROP_RR),
+		DUK__OPLABEL(DUK_OP_PUTPROP_CR),
+		DUK__OPLABEL(DUK_OP_PUTPROP_RC),
+		DUK__OPLABEL(DUK_OP_PUTPROP_CC),
+		DUK__OPLABEL(DUK_OP_DELPROP_RR),
+		DUK__OPLABEL(DUK_OP_DELPROP_CR_UNUSED),
+		DUK__OPLABEL(DUK_OP_DELPROP_RC),
+		DUK__OPLABEL(DUK_OP_DELPROP_CC_UNUSED),
+		DUK__OPLABEL(DUK_OP_PREINCR),
+		DUK__OPLABEL(DUK_OP_PREDECR),
+		DUK__OPLABEL(DUK_OP_POSTINCR),
+		DUK__OPLABEL(DUK_OP_POSTDECR),
+		DUK__OPLABEL(DUK_OP_PREINCV),
+		DUK__OPLABEL(DUK_OP_PREDECV),
+		DUK__OPLABEL(DUK_OP_POSTINCV),
+		DUK__OPLABEL(DUK_OP_POSTDECV),
+		DUK__OPLABEL(DUK_OP_PREINCP_RR),
+		DUK__OPLABEL(DUK_OP_PREINCP_CR),
+		DUK__OPLABEL(DUK_OP_PREINCP_RC),
+		DUK__OPLABEL(DUK_OP_PREINCP_CC),
+		DUK__OPLABEL(DUK_OP_PREDECP_RR),
+		DUK__OPLABEL(DUK_OP_PREDECP_CR),
+		DUK__OPLABEL(DUK_OP_PREDECP_RC),
+		DUK__OPLABEL(DUK_OP_PREDECP_CC),
+		DUK__OPLABEL(DUK_OP_POSTINCP_RR),
+		DUK__OPLABEL(DUK_OP_POSTINCP_CR),
+		DUK__OPLABEL(DUK_OP_POSTINCP_RC),
+		DUK__OPLABEL(DUK_OP_POSTINCP_CC),
+		DUK__OPLABEL(DUK_OP_POSTDECP_RR),
+		DUK__OPLABEL(DUK_OP_POSTDECP_CR),
+		DUK__OPLABEL(DUK_OP_POSTDECP_RC),
+		DUK__OPLABEL(DUK_OP_POSTDECP_CC),
+		DUK__OPLABEL(DUK_OP_DECLVAR_RR),
+		DUK__OPLABEL(DUK_OP_DECLVAR_CR),
+		DUK__OPLABEL(DUK_OP_DECLVAR_RC),
+		DUK__OPLABEL(DUK_OP_DECLVAR_CC),
+		DUK__OPLABEL(DUK_OP_REGEXP_RR),
+		DUK__OPLABEL(DUK_OP_REGEXP_CR),
+		DUK__OPLABEL(DUK_OP_REGEXP_RC),
+		DUK__OPLABEL(DUK_OP_REGEXP_CC),
+		DUK__OPLABEL(DUK_OP_CLOSURE),
+		DUK__OPLABEL(DUK_OP_TYPEOF),
+		DUK__OPLABEL(DUK_OP_TYPEOFID),
+		DUK__OPLABEL(DUK_OP_PUTVAR),
+		DUK__OPLABEL(DUK_OP_DELVAR),
+		DUK__OPLABEL(DUK_OP_RETREG),
+		DUK__OPLABEL(DUK_OP_RETUNDEF),
+		DUK__OPLABEL(DUK_OP_RETCONST),
+		DUK__OPLABEL(DUK_OP_RETCONSTN),
+		DUK__OPLABEL(DUK_OP_LABEL),
+		DUK__OPLABEL(DUK_OP_ENDLABEL),
+		DUK__OPLABEL(DUK_OP_BREAK),
+		DUK__OPLABEL(DUK_OP_CONTINUE),
+		DUK__OPLABEL(DUK_OP_TRYCATCH),
+		DUK__OPLABEL(DUK_OP_ENDTRY),
+		DUK__OPLABEL(DUK_OP_ENDCATCH),
+		DUK__OPLABEL(DUK_OP_ENDFIN),
+		DUK__OPLABEL(DUK_OP_THROW),
+		DUK__OPLABEL(DUK_OP_INVLHS),
+		DUK__OPLABEL(DUK_OP_CSREG),
+		DUK__OPLABEL(DUK_OP_CSVAR_RR),
+		DUK__OPLABEL(DUK_OP_CSVAR_CR),
+		DUK__OPLABEL(DUK_OP_CSVAR_RC),
+		DUK__OPLABEL(DUK_OP_CSVAR_CC),
+		DUK__OPLABEL(DUK_OP_CALL0),
+		DUK__OPLABEL(DUK_OP_CALL1),
+		DUK__OPLABEL(DUK_OP_CALL2),
+		DUK__OPLABEL(DUK_OP_CALL3),
+		DUK__OPLABEL(DUK_OP_CALL4),
+		DUK__OPLABEL(DUK_OP_CALL5),
+		DUK__OPLABEL(DUK_OP_CALL6),
+		DUK__OPLABEL(DUK_OP_CALL7),
+		DUK__OPLABEL(DUK_OP_CALL8),
+		DUK__OPLABEL(DUK_OP_CALL9),
+		DUK__OPLABEL(DUK_OP_CALL10),
+		DUK__OPLABEL(DUK_OP_CALL11),
+		DUK__OPLABEL(DUK_OP_CALL12),
+		DUK__OPLABEL(DUK_OP_CALL13),
+		DUK__OPLABEL(DUK_OP_CALL14),
+		DUK__OPLABEL(DUK_OP_CALL15),
+		DUK__OPLABEL(DUK_OP_NEWOBJ),
+		DUK__OPLABEL(DUK_OP_NEWARR),
+		DUK__OPLABEL(DUK_OP_MPUTOBJ),
+		DUK__OPLABEL(DUK_OP_MPUTOBJI),
+		DUK__OPLABEL(DUK_OP_INITSET),
+		DUK__OPLABEL(DUK_OP_INITGET),
+		DUK__OPLABEL(DUK_OP_MPUTARR),
+		DUK__OPLABEL(DUK_OP_MPUTARRI),
+		DUK__OPLABEL(DUK_OP_SETALEN),
+		DUK__OPLABEL(DUK_OP_INITENUM),
+		DUK__OPLABEL(DUK_OP_NEXTENUM),
+		DUK__OPLABEL(DUK_OP_NEWTARGET),
+		DUK__OPLABEL(DUK_OP_DEBUGGER),
+		DUK__OPLABEL(DUK_OP_NOP),
+		DUK__OPLABEL(DUK_OP_INVALID),
+		DUK__OPLABEL(DUK_OP_UNUSED207),
+		DUK__OPLABEL(DUK_OP_GETPROPC_RR),
+		DUK__OPLABEL(DUK_OP_GETPROPC_CR),
+		DUK__OPLABEL(DUK_OP_GETPROPC_RC),
+		DUK__OPLABEL(DUK_OP_GETPROPC_CC),
+		DUK__OPLABEL(DUK_OP_SWITCHINT),
+		DUK__OPLABEL(DUK_OP_SWITCHSTR),
+		DUK__OPLABEL(DUK_OP_UNUSED214),
+		DUK__OPLABEL(DUK_OP_UNUSED215),
+		DUK__OPLABEL(DUK_OP_UNUSED216),
+		DUK__OPLABEL(DUK_OP_UNUSED217),
+		DUK__OPLABEL(DUK_OP_UNUSED218),
+		DUK__OPLABEL(DUK_OP_UNUSED219),
+		DUK__OPLABEL(DUK_OP_UNUSED220),
+		DUK__OPLABEL(DUK_OP_UNUSED221),
+		DUK__OPLABEL(DUK_OP_UNUSED222),
+		DUK__OPLABEL(DUK_OP_UNUSED223),
+		DUK__OPLABEL(DUK_OP_UNUSED224),
+		DUK__OPLABEL(DUK_OP_UNUSED225),
+		DUK__OPLABEL(DUK_OP_UNUSED226),
+		DUK__OPLABEL(DUK_OP_UNUSED227),
+		DUK__OPLABEL(DUK_OP_UNUSED228),
+		DUK__OPLABEL(DUK_OP_UNUSED229),
+		DUK__OPLABEL(DUK_OP_UNUSED230),
+		DUK__OPLABEL(DUK_OP_UNUSED231),
+		DUK__OPLABEL(DUK_OP_UNUSED232),
+		DUK__OPLABEL(DUK_OP_UNUSED233),
+		DUK__OPLABEL(DUK_OP_UNUSED234),
+		DUK__OPLABEL(DUK_OP_UNUSED235),
+		DUK__OPLABEL(DUK_OP_UNUSED236),
+		DUK__OPLABEL(DUK_OP_UNUSED237),
+		DUK__OPLABEL(DUK_OP_UNUSED238),
+		DUK__OPLABEL(DUK_OP_UNUSED239),
+		DUK__OPLABEL(DUK_OP_UNUSED240),
+		DUK__OPLABEL(DUK_OP_UNUSED241),
+		DUK__OPLABEL(DUK_OP_UNUSED242),
+		DUK__OPLABEL(DUK_OP_UNUSED243),
+		DUK__OPLABEL(DUK_OP_UNUSED244),
+		DUK__OPLABEL(DUK_OP_UNUSED245),
+		DUK__OPLABEL(DUK_OP_UNUSED246),
+		DUK__OPLABEL(DUK_OP_UNUSED247),
+		DUK__OPLABEL(DUK_OP_UNUSED248),
+		DUK__OPLABEL(DUK_OP_UNUSED249),
+		DUK__OPLABEL(DUK_OP_UNUSED250),
+		DUK__OPLABEL(DUK_OP_UNUSED251),
+		DUK__OPLABEL(DUK_OP_UNUSED252),
+		DUK__OPLABEL(DUK_OP_UNUSED253),
+		DUK__OPLABEL(DUK_OP_UNUSED254),
+		DUK__OPLABEL(DUK_OP_UNUSED255)
+	};
+#endif
+
 	/* Optimized reg/const access macros assume sizeof(duk_tval) to be
 	 * either 8 or 16.  Heap allocation checks this even without asserts
 	 * enabled now because it can't be autodetected in duk_config.h.
@@ -77055,6 +79147,9 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		 * will (at least usually) omit a bounds check.
 		 */
 		op = (duk_uint8_t) DUK_DEC_OP(ins);
+#if defined(DUK__COMPUTED_GOTO)
+		goto *duk__opcode_labels[op];
+#endif
 		switch (op) {
 
 		/* Some useful macros.  These access inner executor variables
@@ -77071,8 +79166,8 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		DUK__REPLACE_TOP_A_BREAK(); \
 	}
 #else
-#define DUK__REPLACE_TOP_A_BREAK() { DUK__REPLACE_TO_TVPTR(thr, DUK__REGP_A(ins)); break; }
-#define DUK__REPLACE_TOP_BC_BREAK() { DUK__REPLACE_TO_TVPTR(thr, DUK__REGP_BC(ins)); break; }
+#define DUK__REPLACE_TOP_A_BREAK() { DUK__REPLACE_TO_TVPTR(thr, DUK__REGP_A(ins)); DUK__NEXT(); }
+#define DUK__REPLACE_TOP_BC_BREAK() { DUK__REPLACE_TO_TVPTR(thr, DUK__REGP_BC(ins)); DUK__NEXT(); }
 #define DUK__REPLACE_BOOL_A_BREAK(bval) { \
 		duk_bool_t duk__bval; \
 		duk_tval *duk__tvdst; \
@@ -77080,7 +79175,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		DUK_ASSERT(duk__bval == 0 || duk__bval == 1); \
 		duk__tvdst = DUK__REGP_A(ins); \
 		DUK_TVAL_SET_BOOLEAN_UPDREF(thr, duk__tvdst, duk__bval); \
-		break; \
+		DUK__NEXT(); \
 	}
 #endif
 
@@ -77092,31 +79187,31 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		 * duk_dup() + duk_replace(), but because they're used quite a lot
 		 * they're currently intentionally not size optimized.
 		 */
-		case DUK_OP_LDREG: {
+		DUK__CASE(DUK_OP_LDREG) {
 			duk_tval *tv1, *tv2;
 
 			tv1 = DUK__REGP_A(ins);
 			tv2 = DUK__REGP_BC(ins);
 			DUK_TVAL_SET_TVAL_UPDREF_FAST(thr, tv1, tv2);  /* side effects */
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_STREG: {
+		DUK__CASE(DUK_OP_STREG) {
 			duk_tval *tv1, *tv2;
 
 			tv1 = DUK__REGP_A(ins);
 			tv2 = DUK__REGP_BC(ins);
 			DUK_TVAL_SET_TVAL_UPDREF_FAST(thr, tv2, tv1);  /* side effects */
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_LDCONST: {
+		DUK__CASE(DUK_OP_LDCONST) {
 			duk_tval *tv1, *tv2;
 
 			tv1 = DUK__REGP_A(ins);
 			tv2 = DUK__CONSTP_BC(ins);
 			DUK_TVAL_SET_TVAL_UPDREF_FAST(thr, tv1, tv2);  /* side effects */
-			break;
+			DUK__NEXT();
 		}
 
 		/* LDINT and LDINTX are intended to load an arbitrary signed
@@ -77124,14 +79219,14 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		 * This also guarantees all values remain fastints.
 		 */
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_LDINT: {
+		DUK__CASE(DUK_OP_LDINT) {
 			duk_int32_t val;
 
 			val = (duk_int32_t) DUK_DEC_BC(ins) - (duk_int32_t) DUK_BC_LDINT_BIAS;
 			duk_push_int(thr, val);
 			DUK__REPLACE_TOP_A_BREAK();
 		}
-		case DUK_OP_LDINTX: {
+		DUK__CASE(DUK_OP_LDINTX) {
 			duk_int32_t val;
 
 			val = (duk_int32_t) duk_get_int(thr, DUK_DEC_A(ins));
@@ -77140,16 +79235,16 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__REPLACE_TOP_A_BREAK();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_LDINT: {
+		DUK__CASE(DUK_OP_LDINT) {
 			duk_tval *tv1;
 			duk_int32_t val;
 
 			val = (duk_int32_t) DUK_DEC_BC(ins) - (duk_int32_t) DUK_BC_LDINT_BIAS;
 			tv1 = DUK__REGP_A(ins);
 			DUK_TVAL_SET_I32_UPDREF(thr, tv1, val);  /* side effects */
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_LDINTX: {
+		DUK__CASE(DUK_OP_LDINTX) {
 			duk_tval *tv1;
 			duk_int32_t val;
 
@@ -77164,33 +79259,33 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 #endif
 			val = (duk_int32_t) ((duk_uint32_t) val << DUK_BC_LDINTX_SHIFT) + (duk_int32_t) DUK_DEC_BC(ins);  /* no bias */
 			DUK_TVAL_SET_I32_UPDREF(thr, tv1, val);  /* side effects */
-			break;
+			DUK__NEXT();
 		}
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_LDTHIS: {
+		DUK__CASE(DUK_OP_LDTHIS) {
 			duk_push_this(thr);
 			DUK__REPLACE_TOP_BC_BREAK();
 		}
-		case DUK_OP_LDUNDEF: {
+		DUK__CASE(DUK_OP_LDUNDEF) {
 			duk_to_undefined(thr, (duk_idx_t) DUK_DEC_BC(ins));
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_LDNULL: {
+		DUK__CASE(DUK_OP_LDNULL) {
 			duk_to_null(thr, (duk_idx_t) DUK_DEC_BC(ins));
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_LDTRUE: {
+		DUK__CASE(DUK_OP_LDTRUE) {
 			duk_push_true(thr);
 			DUK__REPLACE_TOP_BC_BREAK();
 		}
-		case DUK_OP_LDFALSE: {
+		DUK__CASE(DUK_OP_LDFALSE) {
 			duk_push_false(thr);
 			DUK__REPLACE_TOP_BC_BREAK();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_LDTHIS: {
+		DUK__CASE(DUK_OP_LDTHIS) {
 			/* Note: 'this' may be bound to any value, not just an object */
 			duk_tval *tv1, *tv2;
 
@@ -77198,67 +79293,67 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			tv2 = thr->valstack_bottom - 1;  /* 'this binding' is just under bottom */
 			DUK_ASSERT(tv2 >= thr->valstack);
 			DUK_TVAL_SET_TVAL_UPDREF_FAST(thr, tv1, tv2);  /* side effects */
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_LDUNDEF: {
+		DUK__CASE(DUK_OP_LDUNDEF) {
 			duk_tval *tv1;
 
 			tv1 = DUK__REGP_BC(ins);
 			DUK_TVAL_SET_UNDEFINED_UPDREF(thr, tv1);  /* side effects */
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_LDNULL: {
+		DUK__CASE(DUK_OP_LDNULL) {
 			duk_tval *tv1;
 
 			tv1 = DUK__REGP_BC(ins);
 			DUK_TVAL_SET_NULL_UPDREF(thr, tv1);  /* side effects */
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_LDTRUE: {
+		DUK__CASE(DUK_OP_LDTRUE) {
 			duk_tval *tv1;
 
 			tv1 = DUK__REGP_BC(ins);
 			DUK_TVAL_SET_BOOLEAN_UPDREF(thr, tv1, 1);  /* side effects */
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_LDFALSE: {
+		DUK__CASE(DUK_OP_LDFALSE) {
 			duk_tval *tv1;
 
 			tv1 = DUK__REGP_BC(ins);
 			DUK_TVAL_SET_BOOLEAN_UPDREF(thr, tv1, 0);  /* side effects */
-			break;
+			DUK__NEXT();
 		}
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
-		case DUK_OP_BNOT: {
+		DUK__CASE(DUK_OP_BNOT) {
 			duk__vm_bitwise_not(thr, DUK_DEC_BC(ins), DUK_DEC_A(ins));
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_LNOT: {
+		DUK__CASE(DUK_OP_LNOT) {
 			duk__vm_logical_not(thr, DUK_DEC_BC(ins), DUK_DEC_A(ins));
-			break;
+			DUK__NEXT();
 		}
 
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_UNM:
-		case DUK_OP_UNP: {
+		DUK__CASE(DUK_OP_UNM)
+		DUK__CASE(DUK_OP_UNP) {
 			duk__vm_arith_unary_op(thr, DUK_DEC_BC(ins), DUK_DEC_A(ins), op);
-			break;
+			DUK__NEXT();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_UNM: {
+		DUK__CASE(DUK_OP_UNM) {
 			duk__vm_arith_unary_op(thr, DUK_DEC_BC(ins), DUK_DEC_A(ins), DUK_OP_UNM);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_UNP: {
+		DUK__CASE(DUK_OP_UNP) {
 			duk__vm_arith_unary_op(thr, DUK_DEC_BC(ins), DUK_DEC_A(ins), DUK_OP_UNP);
-			break;
+			DUK__NEXT();
 		}
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_TYPEOF: {
+		DUK__CASE(DUK_OP_TYPEOF) {
 			duk_small_uint_t stridx;
 
 			stridx = duk_js_typeof_stridx(DUK__REGP_BC(ins));
@@ -77267,7 +79362,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__REPLACE_TOP_A_BREAK();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_TYPEOF: {
+		DUK__CASE(DUK_OP_TYPEOF) {
 			duk_tval *tv;
 			duk_small_uint_t stridx;
 			duk_hstring *h_str;
@@ -77278,11 +79373,11 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			h_str = DUK_HTHREAD_GET_STRING(thr, stridx);
 			tv = DUK__REGP_A(ins);
 			DUK_TVAL_SET_STRING_UPDREF(thr, tv, h_str);
-			break;
+			DUK__NEXT();
 		}
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
-		case DUK_OP_TYPEOFID: {
+		DUK__CASE(DUK_OP_TYPEOFID) {
 			duk_small_uint_t stridx;
 #if !defined(DUK_USE_EXEC_PREFER_SIZE)
 			duk_hstring *h_str;
@@ -77318,7 +79413,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			h_str = DUK_HTHREAD_GET_STRING(thr, stridx);
 			tv = DUK__REGP_A(ins);
 			DUK_TVAL_SET_STRING_UPDREF(thr, tv, h_str);
-			break;
+			DUK__NEXT();
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 		}
 
@@ -77351,58 +79446,58 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		DUK__REPLACE_BOOL_A_BREAK(tmp); \
 	}
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_EQ_RR:
-		case DUK_OP_EQ_CR:
-		case DUK_OP_EQ_RC:
-		case DUK_OP_EQ_CC:
+		DUK__CASE(DUK_OP_EQ_RR)
+		DUK__CASE(DUK_OP_EQ_CR)
+		DUK__CASE(DUK_OP_EQ_RC)
+		DUK__CASE(DUK_OP_EQ_CC)
 			DUK__EQ_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
-		case DUK_OP_NEQ_RR:
-		case DUK_OP_NEQ_CR:
-		case DUK_OP_NEQ_RC:
-		case DUK_OP_NEQ_CC:
+		DUK__CASE(DUK_OP_NEQ_RR)
+		DUK__CASE(DUK_OP_NEQ_CR)
+		DUK__CASE(DUK_OP_NEQ_RC)
+		DUK__CASE(DUK_OP_NEQ_CC)
 			DUK__NEQ_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
-		case DUK_OP_SEQ_RR:
-		case DUK_OP_SEQ_CR:
-		case DUK_OP_SEQ_RC:
-		case DUK_OP_SEQ_CC:
+		DUK__CASE(DUK_OP_SEQ_RR)
+		DUK__CASE(DUK_OP_SEQ_CR)
+		DUK__CASE(DUK_OP_SEQ_RC)
+		DUK__CASE(DUK_OP_SEQ_CC)
 			DUK__SEQ_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
-		case DUK_OP_SNEQ_RR:
-		case DUK_OP_SNEQ_CR:
-		case DUK_OP_SNEQ_RC:
-		case DUK_OP_SNEQ_CC:
+		DUK__CASE(DUK_OP_SNEQ_RR)
+		DUK__CASE(DUK_OP_SNEQ_CR)
+		DUK__CASE(DUK_OP_SNEQ_RC)
+		DUK__CASE(DUK_OP_SNEQ_CC)
 			DUK__SNEQ_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_EQ_RR:
+		DUK__CASE(DUK_OP_EQ_RR)
 			DUK__EQ_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_EQ_CR:
+		DUK__CASE(DUK_OP_EQ_CR)
 			DUK__EQ_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_EQ_RC:
+		DUK__CASE(DUK_OP_EQ_RC)
 			DUK__EQ_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_EQ_CC:
+		DUK__CASE(DUK_OP_EQ_CC)
 			DUK__EQ_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_NEQ_RR:
+		DUK__CASE(DUK_OP_NEQ_RR)
 			DUK__NEQ_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_NEQ_CR:
+		DUK__CASE(DUK_OP_NEQ_CR)
 			DUK__NEQ_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_NEQ_RC:
+		DUK__CASE(DUK_OP_NEQ_RC)
 			DUK__NEQ_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_NEQ_CC:
+		DUK__CASE(DUK_OP_NEQ_CC)
 			DUK__NEQ_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_SEQ_RR:
+		DUK__CASE(DUK_OP_SEQ_RR)
 			DUK__SEQ_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_SEQ_CR:
+		DUK__CASE(DUK_OP_SEQ_CR)
 			DUK__SEQ_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_SEQ_RC:
+		DUK__CASE(DUK_OP_SEQ_RC)
 			DUK__SEQ_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_SEQ_CC:
+		DUK__CASE(DUK_OP_SEQ_CC)
 			DUK__SEQ_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_SNEQ_RR:
+		DUK__CASE(DUK_OP_SNEQ_RR)
 			DUK__SNEQ_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_SNEQ_CR:
+		DUK__CASE(DUK_OP_SNEQ_CR)
 			DUK__SNEQ_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_SNEQ_RC:
+		DUK__CASE(DUK_OP_SNEQ_RC)
 			DUK__SNEQ_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_SNEQ_CC:
+		DUK__CASE(DUK_OP_SNEQ_CC)
 			DUK__SNEQ_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
@@ -77417,353 +79512,353 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 #define DUK__LT_BODY(barg,carg) DUK__COMPARE_BODY((barg), (carg), DUK_COMPARE_FLAG_EVAL_LEFT_FIRST)
 #define DUK__LE_BODY(barg,carg) DUK__COMPARE_BODY((carg), (barg), DUK_COMPARE_FLAG_NEGATE)
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_GT_RR:
-		case DUK_OP_GT_CR:
-		case DUK_OP_GT_RC:
-		case DUK_OP_GT_CC:
+		DUK__CASE(DUK_OP_GT_RR)
+		DUK__CASE(DUK_OP_GT_CR)
+		DUK__CASE(DUK_OP_GT_RC)
+		DUK__CASE(DUK_OP_GT_CC)
 			DUK__GT_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
-		case DUK_OP_GE_RR:
-		case DUK_OP_GE_CR:
-		case DUK_OP_GE_RC:
-		case DUK_OP_GE_CC:
+		DUK__CASE(DUK_OP_GE_RR)
+		DUK__CASE(DUK_OP_GE_CR)
+		DUK__CASE(DUK_OP_GE_RC)
+		DUK__CASE(DUK_OP_GE_CC)
 			DUK__GE_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
-		case DUK_OP_LT_RR:
-		case DUK_OP_LT_CR:
-		case DUK_OP_LT_RC:
-		case DUK_OP_LT_CC:
+		DUK__CASE(DUK_OP_LT_RR)
+		DUK__CASE(DUK_OP_LT_CR)
+		DUK__CASE(DUK_OP_LT_RC)
+		DUK__CASE(DUK_OP_LT_CC)
 			DUK__LT_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
-		case DUK_OP_LE_RR:
-		case DUK_OP_LE_CR:
-		case DUK_OP_LE_RC:
-		case DUK_OP_LE_CC:
+		DUK__CASE(DUK_OP_LE_RR)
+		DUK__CASE(DUK_OP_LE_CR)
+		DUK__CASE(DUK_OP_LE_RC)
+		DUK__CASE(DUK_OP_LE_CC)
 			DUK__LE_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_GT_RR:
+		DUK__CASE(DUK_OP_GT_RR)
 			DUK__GT_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_GT_CR:
+		DUK__CASE(DUK_OP_GT_CR)
 			DUK__GT_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_GT_RC:
+		DUK__CASE(DUK_OP_GT_RC)
 			DUK__GT_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_GT_CC:
+		DUK__CASE(DUK_OP_GT_CC)
 			DUK__GT_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_GE_RR:
+		DUK__CASE(DUK_OP_GE_RR)
 			DUK__GE_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_GE_CR:
+		DUK__CASE(DUK_OP_GE_CR)
 			DUK__GE_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_GE_RC:
+		DUK__CASE(DUK_OP_GE_RC)
 			DUK__GE_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_GE_CC:
+		DUK__CASE(DUK_OP_GE_CC)
 			DUK__GE_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_LT_RR:
+		DUK__CASE(DUK_OP_LT_RR)
 			DUK__LT_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_LT_CR:
+		DUK__CASE(DUK_OP_LT_CR)
 			DUK__LT_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_LT_RC:
+		DUK__CASE(DUK_OP_LT_RC)
 			DUK__LT_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_LT_CC:
+		DUK__CASE(DUK_OP_LT_CC)
 			DUK__LT_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_LE_RR:
+		DUK__CASE(DUK_OP_LE_RR)
 			DUK__LE_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_LE_CR:
+		DUK__CASE(DUK_OP_LE_CR)
 			DUK__LE_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_LE_RC:
+		DUK__CASE(DUK_OP_LE_RC)
 			DUK__LE_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_LE_CC:
+		DUK__CASE(DUK_OP_LE_CC)
 			DUK__LE_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
 		/* No size optimized variant at present for IF. */
-		case DUK_OP_IFTRUE_R: {
+		DUK__CASE(DUK_OP_IFTRUE_R) {
 			if (duk_js_toboolean(DUK__REGP_BC(ins)) != 0) {
 				curr_pc++;
 			}
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_IFTRUE_C: {
+		DUK__CASE(DUK_OP_IFTRUE_C) {
 			if (duk_js_toboolean(DUK__CONSTP_BC(ins)) != 0) {
 				curr_pc++;
 			}
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_IFFALSE_R: {
+		DUK__CASE(DUK_OP_IFFALSE_R) {
 			if (duk_js_toboolean(DUK__REGP_BC(ins)) == 0) {
 				curr_pc++;
 			}
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_IFFALSE_C: {
+		DUK__CASE(DUK_OP_IFFALSE_C) {
 			if (duk_js_toboolean(DUK__CONSTP_BC(ins)) == 0) {
 				curr_pc++;
 			}
-			break;
+			DUK__NEXT();
 		}
 
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_ADD_RR:
-		case DUK_OP_ADD_CR:
-		case DUK_OP_ADD_RC:
-		case DUK_OP_ADD_CC: {
+		DUK__CASE(DUK_OP_ADD_RR)
+		DUK__CASE(DUK_OP_ADD_CR)
+		DUK__CASE(DUK_OP_ADD_RC)
+		DUK__CASE(DUK_OP_ADD_CC) {
 			/* XXX: could leave value on stack top and goto replace_top_a; */
 			duk__vm_arith_add(thr, DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins), DUK_DEC_A(ins));
-			break;
+			DUK__NEXT();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_ADD_RR: {
+		DUK__CASE(DUK_OP_ADD_RR) {
 			duk__vm_arith_add(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins));
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_ADD_CR: {
+		DUK__CASE(DUK_OP_ADD_CR) {
 			duk__vm_arith_add(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins));
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_ADD_RC: {
+		DUK__CASE(DUK_OP_ADD_RC) {
 			duk__vm_arith_add(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins));
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_ADD_CC: {
+		DUK__CASE(DUK_OP_ADD_CC) {
 			duk__vm_arith_add(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins));
-			break;
+			DUK__NEXT();
 		}
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_SUB_RR:
-		case DUK_OP_SUB_CR:
-		case DUK_OP_SUB_RC:
-		case DUK_OP_SUB_CC:
-		case DUK_OP_MUL_RR:
-		case DUK_OP_MUL_CR:
-		case DUK_OP_MUL_RC:
-		case DUK_OP_MUL_CC:
-		case DUK_OP_DIV_RR:
-		case DUK_OP_DIV_CR:
-		case DUK_OP_DIV_RC:
-		case DUK_OP_DIV_CC:
-		case DUK_OP_MOD_RR:
-		case DUK_OP_MOD_CR:
-		case DUK_OP_MOD_RC:
-		case DUK_OP_MOD_CC:
+		DUK__CASE(DUK_OP_SUB_RR)
+		DUK__CASE(DUK_OP_SUB_CR)
+		DUK__CASE(DUK_OP_SUB_RC)
+		DUK__CASE(DUK_OP_SUB_CC)
+		DUK__CASE(DUK_OP_MUL_RR)
+		DUK__CASE(DUK_OP_MUL_CR)
+		DUK__CASE(DUK_OP_MUL_RC)
+		DUK__CASE(DUK_OP_MUL_CC)
+		DUK__CASE(DUK_OP_DIV_RR)
+		DUK__CASE(DUK_OP_DIV_CR)
+		DUK__CASE(DUK_OP_DIV_RC)
+		DUK__CASE(DUK_OP_DIV_CC)
+		DUK__CASE(DUK_OP_MOD_RR)
+		DUK__CASE(DUK_OP_MOD_CR)
+		DUK__CASE(DUK_OP_MOD_RC)
+		DUK__CASE(DUK_OP_MOD_CC)
 #if defined(DUK_USE_ES7_EXP_OPERATOR)
-		case DUK_OP_EXP_RR:
-		case DUK_OP_EXP_CR:
-		case DUK_OP_EXP_RC:
-		case DUK_OP_EXP_CC:
+		DUK__CASE(DUK_OP_EXP_RR)
+		DUK__CASE(DUK_OP_EXP_CR)
+		DUK__CASE(DUK_OP_EXP_RC)
+		DUK__CASE(DUK_OP_EXP_CC)
 #endif  /* DUK_USE_ES7_EXP_OPERATOR */
 		{
 			/* XXX: could leave value on stack top and goto replace_top_a; */
 			duk__vm_arith_binary_op(thr, DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins), DUK_DEC_A(ins), op);
-			break;
+			DUK__NEXT();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_SUB_RR: {
+		DUK__CASE(DUK_OP_SUB_RR) {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_SUB);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_SUB_CR: {
+		DUK__CASE(DUK_OP_SUB_CR) {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_SUB);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_SUB_RC: {
+		DUK__CASE(DUK_OP_SUB_RC) {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_SUB);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_SUB_CC: {
+		DUK__CASE(DUK_OP_SUB_CC) {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_SUB);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_MUL_RR: {
+		DUK__CASE(DUK_OP_MUL_RR) {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_MUL);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_MUL_CR: {
+		DUK__CASE(DUK_OP_MUL_CR) {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_MUL);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_MUL_RC: {
+		DUK__CASE(DUK_OP_MUL_RC) {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_MUL);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_MUL_CC: {
+		DUK__CASE(DUK_OP_MUL_CC) {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_MUL);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_DIV_RR: {
+		DUK__CASE(DUK_OP_DIV_RR) {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_DIV);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_DIV_CR: {
+		DUK__CASE(DUK_OP_DIV_CR) {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_DIV);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_DIV_RC: {
+		DUK__CASE(DUK_OP_DIV_RC) {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_DIV);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_DIV_CC: {
+		DUK__CASE(DUK_OP_DIV_CC) {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_DIV);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_MOD_RR: {
+		DUK__CASE(DUK_OP_MOD_RR) {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_MOD);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_MOD_CR: {
+		DUK__CASE(DUK_OP_MOD_CR) {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_MOD);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_MOD_RC: {
+		DUK__CASE(DUK_OP_MOD_RC) {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_MOD);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_MOD_CC: {
+		DUK__CASE(DUK_OP_MOD_CC) {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_MOD);
-			break;
+			DUK__NEXT();
 		}
 #if defined(DUK_USE_ES7_EXP_OPERATOR)
-		case DUK_OP_EXP_RR: {
+		DUK__CASE(DUK_OP_EXP_RR) {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_EXP);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_EXP_CR: {
+		DUK__CASE(DUK_OP_EXP_CR) {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_EXP);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_EXP_RC: {
+		DUK__CASE(DUK_OP_EXP_RC) {
 			duk__vm_arith_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_EXP);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_EXP_CC: {
+		DUK__CASE(DUK_OP_EXP_CC) {
 			duk__vm_arith_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_EXP);
-			break;
+			DUK__NEXT();
 		}
 #endif  /* DUK_USE_ES7_EXP_OPERATOR */
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_BAND_RR:
-		case DUK_OP_BAND_CR:
-		case DUK_OP_BAND_RC:
-		case DUK_OP_BAND_CC:
-		case DUK_OP_BOR_RR:
-		case DUK_OP_BOR_CR:
-		case DUK_OP_BOR_RC:
-		case DUK_OP_BOR_CC:
-		case DUK_OP_BXOR_RR:
-		case DUK_OP_BXOR_CR:
-		case DUK_OP_BXOR_RC:
-		case DUK_OP_BXOR_CC:
-		case DUK_OP_BASL_RR:
-		case DUK_OP_BASL_CR:
-		case DUK_OP_BASL_RC:
-		case DUK_OP_BASL_CC:
-		case DUK_OP_BLSR_RR:
-		case DUK_OP_BLSR_CR:
-		case DUK_OP_BLSR_RC:
-		case DUK_OP_BLSR_CC:
-		case DUK_OP_BASR_RR:
-		case DUK_OP_BASR_CR:
-		case DUK_OP_BASR_RC:
-		case DUK_OP_BASR_CC: {
+		DUK__CASE(DUK_OP_BAND_RR)
+		DUK__CASE(DUK_OP_BAND_CR)
+		DUK__CASE(DUK_OP_BAND_RC)
+		DUK__CASE(DUK_OP_BAND_CC)
+		DUK__CASE(DUK_OP_BOR_RR)
+		DUK__CASE(DUK_OP_BOR_CR)
+		DUK__CASE(DUK_OP_BOR_RC)
+		DUK__CASE(DUK_OP_BOR_CC)
+		DUK__CASE(DUK_OP_BXOR_RR)
+		DUK__CASE(DUK_OP_BXOR_CR)
+		DUK__CASE(DUK_OP_BXOR_RC)
+		DUK__CASE(DUK_OP_BXOR_CC)
+		DUK__CASE(DUK_OP_BASL_RR)
+		DUK__CASE(DUK_OP_BASL_CR)
+		DUK__CASE(DUK_OP_BASL_RC)
+		DUK__CASE(DUK_OP_BASL_CC)
+		DUK__CASE(DUK_OP_BLSR_RR)
+		DUK__CASE(DUK_OP_BLSR_CR)
+		DUK__CASE(DUK_OP_BLSR_RC)
+		DUK__CASE(DUK_OP_BLSR_CC)
+		DUK__CASE(DUK_OP_BASR_RR)
+		DUK__CASE(DUK_OP_BASR_CR)
+		DUK__CASE(DUK_OP_BASR_RC)
+		DUK__CASE(DUK_OP_BASR_CC) {
 			/* XXX: could leave value on stack top and goto replace_top_a; */
 			duk__vm_bitwise_binary_op(thr, DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins), DUK_DEC_A(ins), op);
-			break;
+			DUK__NEXT();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_BAND_RR: {
+		DUK__CASE(DUK_OP_BAND_RR) {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BAND);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BAND_CR: {
+		DUK__CASE(DUK_OP_BAND_CR) {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BAND);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BAND_RC: {
+		DUK__CASE(DUK_OP_BAND_RC) {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BAND);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BAND_CC: {
+		DUK__CASE(DUK_OP_BAND_CC) {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BAND);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BOR_RR: {
+		DUK__CASE(DUK_OP_BOR_RR) {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BOR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BOR_CR: {
+		DUK__CASE(DUK_OP_BOR_CR) {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BOR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BOR_RC: {
+		DUK__CASE(DUK_OP_BOR_RC) {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BOR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BOR_CC: {
+		DUK__CASE(DUK_OP_BOR_CC) {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BOR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BXOR_RR: {
+		DUK__CASE(DUK_OP_BXOR_RR) {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BXOR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BXOR_CR: {
+		DUK__CASE(DUK_OP_BXOR_CR) {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BXOR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BXOR_RC: {
+		DUK__CASE(DUK_OP_BXOR_RC) {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BXOR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BXOR_CC: {
+		DUK__CASE(DUK_OP_BXOR_CC) {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BXOR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BASL_RR: {
+		DUK__CASE(DUK_OP_BASL_RR) {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BASL);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BASL_CR: {
+		DUK__CASE(DUK_OP_BASL_CR) {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BASL);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BASL_RC: {
+		DUK__CASE(DUK_OP_BASL_RC) {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BASL);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BASL_CC: {
+		DUK__CASE(DUK_OP_BASL_CC) {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BASL);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BLSR_RR: {
+		DUK__CASE(DUK_OP_BLSR_RR) {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BLSR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BLSR_CR: {
+		DUK__CASE(DUK_OP_BLSR_CR) {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BLSR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BLSR_RC: {
+		DUK__CASE(DUK_OP_BLSR_RC) {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BLSR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BLSR_CC: {
+		DUK__CASE(DUK_OP_BLSR_CC) {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BLSR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BASR_RR: {
+		DUK__CASE(DUK_OP_BASR_RR) {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BASR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BASR_CR: {
+		DUK__CASE(DUK_OP_BASR_CR) {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__REGP_C(ins), DUK_DEC_A(ins), DUK_OP_BASR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BASR_RC: {
+		DUK__CASE(DUK_OP_BASR_RC) {
 			duk__vm_bitwise_binary_op(thr, DUK__REGP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BASR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_BASR_CC: {
+		DUK__CASE(DUK_OP_BASR_CC) {
 			duk__vm_bitwise_binary_op(thr, DUK__CONSTP_B(ins), DUK__CONSTP_C(ins), DUK_DEC_A(ins), DUK_OP_BASR);
-			break;
+			DUK__NEXT();
 		}
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
@@ -77781,104 +79876,104 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		DUK__REPLACE_BOOL_A_BREAK(tmp); \
 	}
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_INSTOF_RR:
-		case DUK_OP_INSTOF_CR:
-		case DUK_OP_INSTOF_RC:
-		case DUK_OP_INSTOF_CC:
+		DUK__CASE(DUK_OP_INSTOF_RR)
+		DUK__CASE(DUK_OP_INSTOF_CR)
+		DUK__CASE(DUK_OP_INSTOF_RC)
+		DUK__CASE(DUK_OP_INSTOF_CC)
 			DUK__INSTOF_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
-		case DUK_OP_IN_RR:
-		case DUK_OP_IN_CR:
-		case DUK_OP_IN_RC:
-		case DUK_OP_IN_CC:
+		DUK__CASE(DUK_OP_IN_RR)
+		DUK__CASE(DUK_OP_IN_CR)
+		DUK__CASE(DUK_OP_IN_RC)
+		DUK__CASE(DUK_OP_IN_CC)
 			DUK__IN_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_INSTOF_RR:
+		DUK__CASE(DUK_OP_INSTOF_RR)
 			DUK__INSTOF_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_INSTOF_CR:
+		DUK__CASE(DUK_OP_INSTOF_CR)
 			DUK__INSTOF_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_INSTOF_RC:
+		DUK__CASE(DUK_OP_INSTOF_RC)
 			DUK__INSTOF_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_INSTOF_CC:
+		DUK__CASE(DUK_OP_INSTOF_CC)
 			DUK__INSTOF_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_IN_RR:
+		DUK__CASE(DUK_OP_IN_RR)
 			DUK__IN_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_IN_CR:
+		DUK__CASE(DUK_OP_IN_CR)
 			DUK__IN_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_IN_RC:
+		DUK__CASE(DUK_OP_IN_RC)
 			DUK__IN_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_IN_CC:
+		DUK__CASE(DUK_OP_IN_CC)
 			DUK__IN_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
 		/* Pre/post inc/dec for register variables, important for loops. */
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_PREINCR:
-		case DUK_OP_PREDECR:
-		case DUK_OP_POSTINCR:
-		case DUK_OP_POSTDECR: {
+		DUK__CASE(DUK_OP_PREINCR)
+		DUK__CASE(DUK_OP_PREDECR)
+		DUK__CASE(DUK_OP_POSTINCR)
+		DUK__CASE(DUK_OP_POSTDECR) {
 			duk__prepost_incdec_reg_helper(thr, DUK__REGP_A(ins), DUK__REGP_BC(ins), op);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_PREINCV:
-		case DUK_OP_PREDECV:
-		case DUK_OP_POSTINCV:
-		case DUK_OP_POSTDECV: {
+		DUK__CASE(DUK_OP_PREINCV)
+		DUK__CASE(DUK_OP_PREDECV)
+		DUK__CASE(DUK_OP_POSTINCV)
+		DUK__CASE(DUK_OP_POSTDECV) {
 			duk__prepost_incdec_var_helper(thr, DUK_DEC_A(ins), DUK__CONSTP_BC(ins), op, DUK__STRICT());
-			break;
+			DUK__NEXT();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_PREINCR: {
+		DUK__CASE(DUK_OP_PREINCR) {
 			duk__prepost_incdec_reg_helper(thr, DUK__REGP_A(ins), DUK__REGP_BC(ins), DUK_OP_PREINCR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_PREDECR: {
+		DUK__CASE(DUK_OP_PREDECR) {
 			duk__prepost_incdec_reg_helper(thr, DUK__REGP_A(ins), DUK__REGP_BC(ins), DUK_OP_PREDECR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_POSTINCR: {
+		DUK__CASE(DUK_OP_POSTINCR) {
 			duk__prepost_incdec_reg_helper(thr, DUK__REGP_A(ins), DUK__REGP_BC(ins), DUK_OP_POSTINCR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_POSTDECR: {
+		DUK__CASE(DUK_OP_POSTDECR) {
 			duk__prepost_incdec_reg_helper(thr, DUK__REGP_A(ins), DUK__REGP_BC(ins), DUK_OP_POSTDECR);
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_PREINCV: {
+		DUK__CASE(DUK_OP_PREINCV) {
 			duk__prepost_incdec_var_helper(thr, DUK_DEC_A(ins), DUK__CONSTP_BC(ins), DUK_OP_PREINCV, DUK__STRICT());
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_PREDECV: {
+		DUK__CASE(DUK_OP_PREDECV) {
 			duk__prepost_incdec_var_helper(thr, DUK_DEC_A(ins), DUK__CONSTP_BC(ins), DUK_OP_PREDECV, DUK__STRICT());
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_POSTINCV: {
+		DUK__CASE(DUK_OP_POSTINCV) {
 			duk__prepost_incdec_var_helper(thr, DUK_DEC_A(ins), DUK__CONSTP_BC(ins), DUK_OP_POSTINCV, DUK__STRICT());
-			break;
+			DUK__NEXT();
 		}
-		case DUK_OP_POSTDECV: {
+		DUK__CASE(DUK_OP_POSTDECV) {
 			duk__prepost_incdec_var_helper(thr, DUK_DEC_A(ins), DUK__CONSTP_BC(ins), DUK_OP_POSTDECV, DUK__STRICT());
-			break;
+			DUK__NEXT();
 		}
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
 		/* XXX: Move to separate helper, optimize for perf/size separately. */
 		/* Preinc/predec for object properties. */
-		case DUK_OP_PREINCP_RR:
-		case DUK_OP_PREINCP_CR:
-		case DUK_OP_PREINCP_RC:
-		case DUK_OP_PREINCP_CC:
-		case DUK_OP_PREDECP_RR:
-		case DUK_OP_PREDECP_CR:
-		case DUK_OP_PREDECP_RC:
-		case DUK_OP_PREDECP_CC:
-		case DUK_OP_POSTINCP_RR:
-		case DUK_OP_POSTINCP_CR:
-		case DUK_OP_POSTINCP_RC:
-		case DUK_OP_POSTINCP_CC:
-		case DUK_OP_POSTDECP_RR:
-		case DUK_OP_POSTDECP_CR:
-		case DUK_OP_POSTDECP_RC:
-		case DUK_OP_POSTDECP_CC: {
+		DUK__CASE(DUK_OP_PREINCP_RR)
+		DUK__CASE(DUK_OP_PREINCP_CR)
+		DUK__CASE(DUK_OP_PREINCP_RC)
+		DUK__CASE(DUK_OP_PREINCP_CC)
+		DUK__CASE(DUK_OP_PREDECP_RR)
+		DUK__CASE(DUK_OP_PREDECP_CR)
+		DUK__CASE(DUK_OP_PREDECP_RC)
+		DUK__CASE(DUK_OP_PREDECP_CC)
+		DUK__CASE(DUK_OP_POSTINCP_RR)
+		DUK__CASE(DUK_OP_POSTINCP_CR)
+		DUK__CASE(DUK_OP_POSTINCP_RC)
+		DUK__CASE(DUK_OP_POSTINCP_CC)
+		DUK__CASE(DUK_OP_POSTDECP_RR)
+		DUK__CASE(DUK_OP_POSTDECP_CR)
+		DUK__CASE(DUK_OP_POSTDECP_RC)
+		DUK__CASE(DUK_OP_POSTDECP_CC) {
 			duk_tval *tv_obj;
 			duk_tval *tv_key;
 			duk_tval *tv_val;
@@ -77940,7 +80035,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 #else
 			tv_dst = DUK__REGP_A(ins);
 			DUK_TVAL_SET_NUMBER_UPDREF(thr, tv_dst, z);
-			break;
+			DUK__NEXT();
 #endif
 		}
 
@@ -77948,18 +80043,58 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		 * Occurs relatively often in object oriented code.
 		 */
 
+#if defined(DUK_USE_EXEC_PROPCACHE_SIZE)
+#define DUK__PROPCACHE_GET(barg,carg,callable) { \
+		duk_int_t e__idx; \
+		e__idx = duk__propcache_lookup(thr->heap, DUK__PROPCACHE_SLOT(thr->heap, curr_pc), (barg), (carg), 0); \
+		if (e__idx >= 0) { \
+			duk_tval *tv__value; \
+			duk_tval *tv__slot; \
+			tv__value = DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(thr->heap, DUK_TVAL_GET_OBJECT((barg)), e__idx); \
+			if (!(callable) || duk_is_callable_tval(thr, tv__value)) { \
+				tv__slot = DUK__REGP_A(ins); \
+				DUK_TVAL_SET_TVAL_UPDREF(thr, tv__slot, tv__value); \
+				DUK__NEXT(); \
+			} \
+		} \
+		thr->heap->propcache_e_idx = -1; \
+	}
+#define DUK__PROPCACHE_PUT(aarg,barg,carg) { \
+		duk_int_t e__idx; \
+		e__idx = duk__propcache_lookup(thr->heap, DUK__PROPCACHE_SLOT(thr->heap, curr_pc), (aarg), (barg), DUK_PROPDESC_FLAG_WRITABLE); \
+		if (e__idx >= 0) { \
+			duk_tval *tv__value; \
+			duk_tval *tv__slot; \
+			tv__slot = DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(thr->heap, DUK_TVAL_GET_OBJECT((aarg)), e__idx); \
+			tv__value = (carg); \
+			DUK_TVAL_SET_TVAL_UPDREF(thr, tv__slot, tv__value); \
+			DUK__NEXT(); \
+		} \
+		thr->heap->propcache_e_idx = -1; \
+	}
+#define DUK__PROPCACHE_UPDATE() duk__propcache_update(thr->heap, DUK__PROPCACHE_SLOT(thr->heap, curr_pc))
+#else
+#define DUK__PROPCACHE_GET(barg,carg,callable)
+#define DUK__PROPCACHE_PUT(aarg,barg,carg)
+#define DUK__PROPCACHE_UPDATE()
+#endif
+
 #define DUK__GETPROP_BODY(barg,carg) { \
 		/* A -> target reg \
 		 * B -> object reg/const (may be const e.g. in "'foo'[1]") \
 		 * C -> key reg/const \
 		 */ \
+		DUK__PROPCACHE_GET((barg), (carg), 0); \
 		(void) duk_hobject_getprop(thr, (barg), (carg)); \
+		DUK__PROPCACHE_UPDATE(); \
 		DUK__REPLACE_TOP_A_BREAK(); \
 	}
 #define DUK__GETPROPC_BODY(barg,carg) { \
 		/* Same as GETPROP but callability check for property-based calls. */ \
 		duk_tval *tv__targ; \
+		DUK__PROPCACHE_GET((barg), (carg), 1); \
 		(void) duk_hobject_getprop(thr, (barg), (carg)); \
+		DUK__PROPCACHE_UPDATE(); \
 		DUK_GC_TORTURE(thr->heap); \
 		tv__targ = DUK_GET_TVAL_NEGIDX(thr, -1); \
 		if (DUK_UNLIKELY(!duk_is_callable_tval(thr, tv__targ))) { \
@@ -77979,8 +80114,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		 * Note: intentional difference to register arrangement \
 		 * of e.g. GETPROP; 'A' must contain a register-only value. \
 		 */ \
+		DUK__PROPCACHE_PUT((aarg), (barg), (carg)); \
 		(void) duk_hobject_putprop(thr, (aarg), (barg), (carg), DUK__STRICT()); \
-		break; \
+		DUK__PROPCACHE_UPDATE(); \
+		DUK__NEXT(); \
 	}
 #define DUK__DELPROP_BODY(barg,carg) { \
 		/* A -> result reg \
@@ -77993,64 +80130,64 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		DUK__REPLACE_BOOL_A_BREAK(rc); \
 	}
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_GETPROP_RR:
-		case DUK_OP_GETPROP_CR:
-		case DUK_OP_GETPROP_RC:
-		case DUK_OP_GETPROP_CC:
+		DUK__CASE(DUK_OP_GETPROP_RR)
+		DUK__CASE(DUK_OP_GETPROP_CR)
+		DUK__CASE(DUK_OP_GETPROP_RC)
+		DUK__CASE(DUK_OP_GETPROP_CC)
 			DUK__GETPROP_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
 #if defined(DUK_USE_VERBOSE_ERRORS)
-		case DUK_OP_GETPROPC_RR:
-		case DUK_OP_GETPROPC_CR:
-		case DUK_OP_GETPROPC_RC:
-		case DUK_OP_GETPROPC_CC:
+		DUK__CASE(DUK_OP_GETPROPC_RR)
+		DUK__CASE(DUK_OP_GETPROPC_CR)
+		DUK__CASE(DUK_OP_GETPROPC_RC)
+		DUK__CASE(DUK_OP_GETPROPC_CC)
 			DUK__GETPROPC_BODY(DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
 #endif
-		case DUK_OP_PUTPROP_RR:
-		case DUK_OP_PUTPROP_CR:
-		case DUK_OP_PUTPROP_RC:
-		case DUK_OP_PUTPROP_CC:
+		DUK__CASE(DUK_OP_PUTPROP_RR)
+		DUK__CASE(DUK_OP_PUTPROP_CR)
+		DUK__CASE(DUK_OP_PUTPROP_RC)
+		DUK__CASE(DUK_OP_PUTPROP_CC)
 			DUK__PUTPROP_BODY(DUK__REGP_A(ins), DUK__REGCONSTP_B(ins), DUK__REGCONSTP_C(ins));
-		case DUK_OP_DELPROP_RR:
-		case DUK_OP_DELPROP_RC:  /* B is always reg */
+		DUK__CASE(DUK_OP_DELPROP_RR)
+		DUK__CASE(DUK_OP_DELPROP_RC)  /* B is always reg */
 			DUK__DELPROP_BODY(DUK__REGP_B(ins), DUK__REGCONSTP_C(ins));
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_GETPROP_RR:
+		DUK__CASE(DUK_OP_GETPROP_RR)
 			DUK__GETPROP_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_GETPROP_CR:
+		DUK__CASE(DUK_OP_GETPROP_CR)
 			DUK__GETPROP_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_GETPROP_RC:
+		DUK__CASE(DUK_OP_GETPROP_RC)
 			DUK__GETPROP_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_GETPROP_CC:
+		DUK__CASE(DUK_OP_GETPROP_CC)
 			DUK__GETPROP_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
 #if defined(DUK_USE_VERBOSE_ERRORS)
-		case DUK_OP_GETPROPC_RR:
+		DUK__CASE(DUK_OP_GETPROPC_RR)
 			DUK__GETPROPC_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_GETPROPC_CR:
+		DUK__CASE(DUK_OP_GETPROPC_CR)
 			DUK__GETPROPC_BODY(DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_GETPROPC_RC:
+		DUK__CASE(DUK_OP_GETPROPC_RC)
 			DUK__GETPROPC_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_GETPROPC_CC:
+		DUK__CASE(DUK_OP_GETPROPC_CC)
 			DUK__GETPROPC_BODY(DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
 #endif
-		case DUK_OP_PUTPROP_RR:
+		DUK__CASE(DUK_OP_PUTPROP_RR)
 			DUK__PUTPROP_BODY(DUK__REGP_A(ins), DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_PUTPROP_CR:
+		DUK__CASE(DUK_OP_PUTPROP_CR)
 			DUK__PUTPROP_BODY(DUK__REGP_A(ins), DUK__CONSTP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_PUTPROP_RC:
+		DUK__CASE(DUK_OP_PUTPROP_RC)
 			DUK__PUTPROP_BODY(DUK__REGP_A(ins), DUK__REGP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_PUTPROP_CC:
+		DUK__CASE(DUK_OP_PUTPROP_CC)
 			DUK__PUTPROP_BODY(DUK__REGP_A(ins), DUK__CONSTP_B(ins), DUK__CONSTP_C(ins));
-		case DUK_OP_DELPROP_RR:  /* B is always reg */
+		DUK__CASE(DUK_OP_DELPROP_RR)  /* B is always reg */
 			DUK__DELPROP_BODY(DUK__REGP_B(ins), DUK__REGP_C(ins));
-		case DUK_OP_DELPROP_RC:
+		DUK__CASE(DUK_OP_DELPROP_RC)
 			DUK__DELPROP_BODY(DUK__REGP_B(ins), DUK__CONSTP_C(ins));
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
 		/* No fast path for DECLVAR now, it's quite a rare instruction. */
-		case DUK_OP_DECLVAR_RR:
-		case DUK_OP_DECLVAR_CR:
-		case DUK_OP_DECLVAR_RC:
-		case DUK_OP_DECLVAR_CC: {
+		DUK__CASE(DUK_OP_DECLVAR_RR)
+		DUK__CASE(DUK_OP_DECLVAR_CR)
+		DUK__CASE(DUK_OP_DECLVAR_RC)
+		DUK__CASE(DUK_OP_DECLVAR_CC) {
 			duk_activation *act;
 			duk_small_uint_fast_t a = DUK_DEC_A(ins);
 			duk_tval *tv1;
@@ -78096,17 +80233,17 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			}
 
 			duk_pop_unsafe(thr);
-			break;
+			DUK__NEXT();
 		}
 
 #if defined(DUK_USE_REGEXP_SUPPORT)
 		/* The compiler should never emit DUK_OP_REGEXP if there is no
 		 * regexp support.
 		 */
-		case DUK_OP_REGEXP_RR:
-		case DUK_OP_REGEXP_CR:
-		case DUK_OP_REGEXP_RC:
-		case DUK_OP_REGEXP_CC: {
+		DUK__CASE(DUK_OP_REGEXP_RR)
+		DUK__CASE(DUK_OP_REGEXP_CR)
+		DUK__CASE(DUK_OP_REGEXP_RC)
+		DUK__CASE(DUK_OP_REGEXP_CC) {
 			/* A -> target register
 			 * B -> bytecode (also contains flags)
 			 * C -> escaped source
@@ -78120,10 +80257,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 #endif  /* DUK_USE_REGEXP_SUPPORT */
 
 		/* XXX: 'c' is unused, use whole BC, etc. */
-		case DUK_OP_CSVAR_RR:
-		case DUK_OP_CSVAR_CR:
-		case DUK_OP_CSVAR_RC:
-		case DUK_OP_CSVAR_CC: {
+		DUK__CASE(DUK_OP_CSVAR_RR)
+		DUK__CASE(DUK_OP_CSVAR_CR)
+		DUK__CASE(DUK_OP_CSVAR_RC)
+		DUK__CASE(DUK_OP_CSVAR_CC) {
 			/* The speciality of calling through a variable binding is that the
 			 * 'this' value may be provided by the variable lookup: E5 Section 6.b.i.
 			 *
@@ -78153,10 +80290,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			/* Could add direct value stack handling. */
 			duk_replace(thr, (duk_idx_t) (idx + 1));  /* 'this' binding */
 			duk_replace(thr, (duk_idx_t) idx);        /* variable value (function, we hope, not checked here) */
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_CLOSURE: {
+		DUK__CASE(DUK_OP_CLOSURE) {
 			duk_activation *act;
 			duk_hcompfunc *fun_act;
 			duk_small_uint_fast_t bc = DUK_DEC_BC(ins);
@@ -78201,7 +80338,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__REPLACE_TOP_A_BREAK();
 		}
 
-		case DUK_OP_GETVAR: {
+		DUK__CASE(DUK_OP_GETVAR) {
 			duk_activation *act;
 			duk_tval *tv1;
 			duk_hstring *name;
@@ -78212,12 +80349,23 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK_ASSERT(name != NULL);
 			act = thr->callstack_curr;
 			DUK_ASSERT(act != NULL);
+#if defined(DUK_USE_EXEC_PROPCACHE_SIZE)
+			tv1 = duk__varcache_lookup(thr, act, DUK__PROPCACHE_SLOT(thr->heap, curr_pc), name, 0);
+			if (tv1 != NULL) {
+				duk_tval *tv_dst;
+				tv_dst = DUK__REGP_A(ins);
+				DUK_TVAL_SET_TVAL_UPDREF(thr, tv_dst, tv1);
+				DUK__NEXT();
+			}
+			thr->heap->propcache_e_idx = -1;
+#endif
 			(void) duk_js_getvar_activation(thr, act, name, 1 /*throw*/);  /* -> [... val this] */
+			DUK__PROPCACHE_UPDATE();
 			duk_pop_unsafe(thr);  /* 'this' binding is not needed here */
 			DUK__REPLACE_TOP_A_BREAK();
 		}
 
-		case DUK_OP_PUTVAR: {
+		DUK__CASE(DUK_OP_PUTVAR) {
 			duk_activation *act;
 			duk_tval *tv1;
 			duk_hstring *name;
@@ -78233,11 +80381,23 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 
 			tv1 = DUK__REGP_A(ins);  /* val */
 			act = thr->callstack_curr;
+#if defined(DUK_USE_EXEC_PROPCACHE_SIZE)
+			{
+				duk_tval *tv_slot;
+				tv_slot = duk__varcache_lookup(thr, act, DUK__PROPCACHE_SLOT(thr->heap, curr_pc), name, DUK_PROPDESC_FLAG_WRITABLE);
+				if (tv_slot != NULL) {
+					DUK_TVAL_SET_TVAL_UPDREF(thr, tv_slot, tv1);
+					DUK__NEXT();
+				}
+				thr->heap->propcache_e_idx = -1;
+			}
+#endif
 			duk_js_putvar_activation(thr, act, name, tv1, DUK__STRICT());
-			break;
+			DUK__PROPCACHE_UPDATE();
+			DUK__NEXT();
 		}
 
-		case DUK_OP_DELVAR: {
+		DUK__CASE(DUK_OP_DELVAR) {
 			duk_activation *act;
 			duk_tval *tv1;
 			duk_hstring *name;
@@ -78252,13 +80412,68 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__REPLACE_BOOL_A_BREAK(rc);
 		}
 
-		case DUK_OP_JUMP: {
+		DUK__CASE(DUK_OP_JUMP) {
 			/* Note: without explicit cast to signed, MSVC will
 			 * apparently generate a large positive jump when the
 			 * bias-corrected value would normally be negative.
 			 */
 			curr_pc += (duk_int_fast_t) DUK_DEC_ABC(ins) - (duk_int_fast_t) DUK_BC_JUMP_BIAS;
-			break;
+			DUK__NEXT();
+		}
+
+		/* Switch dispatch lands on the JUMP in its inline table (see
+		 * DUK_OP_SWITCHINT) for the matching case, or the last one if
+		 * no case matches.
+		 */
+		DUK__CASE(DUK_OP_SWITCHINT) {
+			duk_tval *tv1 = DUK__REGP_BC(ins);
+			duk_uint_fast32_t size = DUK_DEC_ABC(curr_pc[0]);
+			duk_int_fast_t low = (duk_int_fast_t) DUK_DEC_ABC(curr_pc[1]) - (duk_int_fast_t) DUK_BC_JUMP_BIAS;
+			duk_uint_fast32_t idx = size;
+
+#if defined(DUK_USE_FASTINT)
+			if (DUK_TVAL_IS_FASTINT(tv1)) {
+				duk_int64_t v = DUK_TVAL_GET_FASTINT(tv1) - (duk_int64_t) low;
+				if (v >= 0 && v < (duk_int64_t) size) {
+					idx = (duk_uint_fast32_t) v;
+				}
+			} else
+#endif
+			if (DUK_TVAL_IS_NUMBER(tv1)) {
+				duk_double_t d = DUK_TVAL_GET_NUMBER(tv1) - (duk_double_t) low;
+				if (d >= 0.0 && d < (duk_double_t) size && d == DUK_FLOOR(d)) {
+					idx = (duk_uint_fast32_t) d;
+				}
+			}
+			curr_pc += 2 + idx;
+			DUK__NEXT();
+		}
+
+		DUK__CASE(DUK_OP_SWITCHSTR) {
+			duk_tval *tv1 = DUK__REGP_BC(ins);
+			duk_uint_fast32_t mask = DUK_DEC_ABC(curr_pc[0]);
+			duk_instr_t *slots = curr_pc + 1;
+
+			curr_pc = slots + (mask + 1) * 2;  /* no match */
+			if (DUK_TVAL_IS_STRING(tv1)) {
+				duk_hstring *h_str = DUK_TVAL_GET_STRING(tv1);
+				duk_uint_fast32_t i = duk_js_switch_hash(DUK_HSTRING_GET_DATA(h_str), DUK_HSTRING_GET_BYTELEN(h_str)) & mask;
+
+				/* Strings are interned, so a pointer compare decides.
+				 * The table is at most half full, so an unused slot
+				 * ends the probe.
+				 */
+				while (DUK_DEC_A(slots[i * 2]) != 0) {
+					duk_tval *tv_key = consts + DUK_DEC_BC(slots[i * 2]);
+					DUK_ASSERT(DUK_TVAL_IS_STRING(tv_key));
+					if (DUK_TVAL_GET_STRING(tv_key) == h_str) {
+						curr_pc = slots + i * 2 + 1;
+						break;
+					}
+					i = (i + 1) & mask;
+				}
+			}
+			DUK__NEXT();
 		}
 
 #define DUK__RETURN_SHARED() do { \
@@ -78276,10 +80491,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		return; \
 	} while (0)
 #if defined(DUK_USE_EXEC_PREFER_SIZE)
-		case DUK_OP_RETREG:
-		case DUK_OP_RETCONST:
-		case DUK_OP_RETCONSTN:
-		case DUK_OP_RETUNDEF: {
+		DUK__CASE(DUK_OP_RETREG)
+		DUK__CASE(DUK_OP_RETCONST)
+		DUK__CASE(DUK_OP_RETCONSTN)
+		DUK__CASE(DUK_OP_RETUNDEF) {
 			 /* BC -> return value reg/const */
 
 			DUK__SYNC_AND_NULL_CURR_PC();
@@ -78297,7 +80512,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__RETURN_SHARED();
 		}
 #else  /* DUK_USE_EXEC_PREFER_SIZE */
-		case DUK_OP_RETREG: {
+		DUK__CASE(DUK_OP_RETREG) {
 			duk_tval *tv;
 
 			DUK__SYNC_AND_NULL_CURR_PC();
@@ -78308,7 +80523,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__RETURN_SHARED();
 		}
 		/* This will be unused without refcounting. */
-		case DUK_OP_RETCONST: {
+		DUK__CASE(DUK_OP_RETCONST) {
 			duk_tval *tv;
 
 			DUK__SYNC_AND_NULL_CURR_PC();
@@ -78318,7 +80533,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			thr->valstack_top++;
 			DUK__RETURN_SHARED();
 		}
-		case DUK_OP_RETCONSTN: {
+		DUK__CASE(DUK_OP_RETCONSTN) {
 			duk_tval *tv;
 
 			DUK__SYNC_AND_NULL_CURR_PC();
@@ -78331,7 +80546,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			thr->valstack_top++;
 			DUK__RETURN_SHARED();
 		}
-		case DUK_OP_RETUNDEF: {
+		DUK__CASE(DUK_OP_RETUNDEF) {
 			DUK__SYNC_AND_NULL_CURR_PC();
 			thr->valstack_top++;  /* value at valstack top is already undefined by valstack policy */
 			DUK_ASSERT(DUK_TVAL_IS_UNDEFINED(thr->valstack_top));
@@ -78339,7 +80554,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		}
 #endif  /* DUK_USE_EXEC_PREFER_SIZE */
 
-		case DUK_OP_LABEL: {
+		DUK__CASE(DUK_OP_LABEL) {
 			duk_activation *act;
 			duk_catcher *cat;
 			duk_small_uint_fast_t bc = DUK_DEC_BC(ins);
@@ -78365,10 +80580,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			                     (long) cat->idx_base, (duk_heaphdr *) cat->h_varname, (long) DUK_CAT_GET_LABEL(cat)));
 
 			curr_pc += 2;  /* skip jump slots */
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_ENDLABEL: {
+		DUK__CASE(DUK_OP_ENDLABEL) {
 			duk_activation *act;
 #if (defined(DUK_USE_DEBUG_LEVEL) && (DUK_USE_DEBUG_LEVEL >= 2)) || defined(DUK_USE_ASSERTIONS)
 			duk_small_uint_fast_t bc = DUK_DEC_BC(ins);
@@ -78384,10 +80599,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			duk_hthread_catcher_unwind_nolexenv_norz(thr, act);
 
 			/* no need to unwind callstack */
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_BREAK: {
+		DUK__CASE(DUK_OP_BREAK) {
 			duk_small_uint_fast_t bc = DUK_DEC_BC(ins);
 
 			DUK__SYNC_AND_NULL_CURR_PC();
@@ -78395,7 +80610,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			goto restart_execution;
 		}
 
-		case DUK_OP_CONTINUE: {
+		DUK__CASE(DUK_OP_CONTINUE) {
 			duk_small_uint_fast_t bc = DUK_DEC_BC(ins);
 
 			DUK__SYNC_AND_NULL_CURR_PC();
@@ -78404,23 +80619,23 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		}
 
 		/* XXX: move to helper, too large to be inline here */
-		case DUK_OP_TRYCATCH: {
+		DUK__CASE(DUK_OP_TRYCATCH) {
 			duk__handle_op_trycatch(thr, ins, curr_pc);
 			curr_pc += 2;  /* skip jump slots */
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_ENDTRY: {
+		DUK__CASE(DUK_OP_ENDTRY) {
 			curr_pc = duk__handle_op_endtry(thr, ins);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_ENDCATCH: {
+		DUK__CASE(DUK_OP_ENDCATCH) {
 			duk__handle_op_endcatch(thr, ins);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_ENDFIN: {
+		DUK__CASE(DUK_OP_ENDFIN) {
 			/* Sync and NULL early. */
 			DUK__SYNC_AND_NULL_CURR_PC();
 
@@ -78432,7 +80647,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			goto restart_execution;
 		}
 
-		case DUK_OP_THROW: {
+		DUK__CASE(DUK_OP_THROW) {
 			duk_small_uint_fast_t bc = DUK_DEC_BC(ins);
 
 			/* Note: errors are augmented when they are created, not
@@ -78463,10 +80678,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK_ASSERT(thr->heap->lj.jmpbuf_ptr != NULL);  /* always in executor */
 			duk_err_longjmp(thr);
 			DUK_UNREACHABLE();
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_CSREG: {
+		DUK__CASE(DUK_OP_CSREG) {
 			/*
 			 *  Assuming a register binds to a variable declared within this
 			 *  function (a declarative binding), the 'this' for the call
@@ -78502,7 +80717,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK_TVAL_DECREF(thr, &tv_tmp1);
 			DUK_TVAL_DECREF(thr, &tv_tmp2);
 #endif
-			break;
+			DUK__NEXT();
 		}
 
 
@@ -78512,14 +80727,14 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 		 * stack resize would be large).
 		 */
 
-		case DUK_OP_CALL0:
-		case DUK_OP_CALL1:
-		case DUK_OP_CALL2:
-		case DUK_OP_CALL3:
-		case DUK_OP_CALL4:
-		case DUK_OP_CALL5:
-		case DUK_OP_CALL6:
-		case DUK_OP_CALL7: {
+		DUK__CASE(DUK_OP_CALL0)
+		DUK__CASE(DUK_OP_CALL1)
+		DUK__CASE(DUK_OP_CALL2)
+		DUK__CASE(DUK_OP_CALL3)
+		DUK__CASE(DUK_OP_CALL4)
+		DUK__CASE(DUK_OP_CALL5)
+		DUK__CASE(DUK_OP_CALL6)
+		DUK__CASE(DUK_OP_CALL7) {
 			/* Opcode packs 4 flag bits: 1 for indirect, 3 map
 			 * 1:1 to three lowest call handling flags.
 			 *
@@ -78563,17 +80778,17 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			 * status after returning.  This is now handled by call handling
 			 * and heap->dbg_force_restart.
 			 */
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_CALL8:
-		case DUK_OP_CALL9:
-		case DUK_OP_CALL10:
-		case DUK_OP_CALL11:
-		case DUK_OP_CALL12:
-		case DUK_OP_CALL13:
-		case DUK_OP_CALL14:
-		case DUK_OP_CALL15: {
+		DUK__CASE(DUK_OP_CALL8)
+		DUK__CASE(DUK_OP_CALL9)
+		DUK__CASE(DUK_OP_CALL10)
+		DUK__CASE(DUK_OP_CALL11)
+		DUK__CASE(DUK_OP_CALL12)
+		DUK__CASE(DUK_OP_CALL13)
+		DUK__CASE(DUK_OP_CALL14)
+		DUK__CASE(DUK_OP_CALL15) {
 			/* Indirect variant. */
 			duk_uint_fast_t nargs;
 			duk_idx_t idx;
@@ -78600,10 +80815,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			fun = DUK__FUN();
 #endif
 			duk_set_top_unsafe(thr, (duk_idx_t) fun->nregs);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_NEWOBJ: {
+		DUK__CASE(DUK_OP_NEWOBJ) {
 			duk_push_object(thr);
 #if defined(DUK_USE_ASSERTIONS)
 			{
@@ -78622,7 +80837,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__REPLACE_TOP_BC_BREAK();
 		}
 
-		case DUK_OP_NEWARR: {
+		DUK__CASE(DUK_OP_NEWARR) {
 			duk_push_array(thr);
 #if defined(DUK_USE_ASSERTIONS)
 			{
@@ -78649,8 +80864,8 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			DUK__REPLACE_TOP_BC_BREAK();
 		}
 
-		case DUK_OP_MPUTOBJ:
-		case DUK_OP_MPUTOBJI: {
+		DUK__CASE(DUK_OP_MPUTOBJ)
+		DUK__CASE(DUK_OP_MPUTOBJI) {
 			duk_idx_t obj_idx;
 			duk_uint_fast_t idx, idx_end;
 			duk_small_uint_fast_t count;
@@ -78702,17 +80917,17 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 				                           DUK_DEFPROP_SET_CONFIGURABLE);
 				idx += 2;
 			} while (idx < idx_end);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_INITSET:
-		case DUK_OP_INITGET: {
+		DUK__CASE(DUK_OP_INITSET)
+		DUK__CASE(DUK_OP_INITGET) {
 			duk__handle_op_initset_initget(thr, ins);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_MPUTARR:
-		case DUK_OP_MPUTARRI: {
+		DUK__CASE(DUK_OP_MPUTARR)
+		DUK__CASE(DUK_OP_MPUTARRI) {
 			duk_idx_t obj_idx;
 			duk_uint_fast_t idx, idx_end;
 			duk_small_uint_fast_t count;
@@ -78780,10 +80995,10 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			 * 'arr_idx' type.
 			 */
 			duk_set_length(thr, obj_idx, (duk_size_t) (duk_uarridx_t) arr_idx);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_SETALEN: {
+		DUK__CASE(DUK_OP_SETALEN) {
 			duk_tval *tv1;
 			duk_hobject *h;
 			duk_uint32_t len;
@@ -78802,26 +81017,26 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			len = (duk_uint32_t) DUK_TVAL_GET_NUMBER(tv1);
 #endif
 			((duk_harray *) h)->length = len;
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_INITENUM: {
+		DUK__CASE(DUK_OP_INITENUM) {
 			duk__handle_op_initenum(thr, ins);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_NEXTENUM: {
+		DUK__CASE(DUK_OP_NEXTENUM) {
 			curr_pc += duk__handle_op_nextenum(thr, ins);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_INVLHS: {
+		DUK__CASE(DUK_OP_INVLHS) {
 			DUK_ERROR_REFERENCE(thr, DUK_STR_INVALID_LVALUE);
 			DUK_WO_NORETURN(return;);
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_DEBUGGER: {
+		DUK__CASE(DUK_OP_DEBUGGER) {
 			/* Opcode only emitted by compiler when debugger
 			 * support is enabled.  Ignore it silently without
 			 * debugger support, in case it has been loaded
@@ -78840,24 +81055,24 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 #else
 			DUK_D(DUK_DPRINT("DEBUGGER statement ignored, no debugger support"));
 #endif
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_NOP: {
+		DUK__CASE(DUK_OP_NOP) {
 			/* Nop, ignored, but ABC fields may carry a value e.g.
 			 * for indirect opcode handling.
 			 */
-			break;
+			DUK__NEXT();
 		}
 
-		case DUK_OP_INVALID: {
+		DUK__CASE(DUK_OP_INVALID) {
 			DUK_ERROR_FMT1(thr, DUK_ERR_ERROR, "INVALID opcode (%ld)", (long) DUK_DEC_ABC(ins));
 			DUK_WO_NORETURN(return;);
-			break;
+			DUK__NEXT();
 		}
 
 #if defined(DUK_USE_ES6)
-		case DUK_OP_NEWTARGET: {
+		DUK__CASE(DUK_OP_NEWTARGET) {
 			duk_push_new_target(thr);
 			DUK__REPLACE_TOP_BC_BREAK();
 		}
@@ -78865,65 +81080,71 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 
 #if !defined(DUK_USE_EXEC_PREFER_SIZE)
 #if !defined(DUK_USE_ES7_EXP_OPERATOR)
-		case DUK_OP_EXP_RR:
-		case DUK_OP_EXP_CR:
-		case DUK_OP_EXP_RC:
-		case DUK_OP_EXP_CC:
+		DUK__CASE(DUK_OP_EXP_RR)
+		DUK__CASE(DUK_OP_EXP_CR)
+		DUK__CASE(DUK_OP_EXP_RC)
+		DUK__CASE(DUK_OP_EXP_CC)
 #endif
 #if !defined(DUK_USE_ES6)
-		case DUK_OP_NEWTARGET:
+		DUK__CASE(DUK_OP_NEWTARGET)
 #endif
 #if !defined(DUK_USE_VERBOSE_ERRORS)
-		case DUK_OP_GETPROPC_RR:
-		case DUK_OP_GETPROPC_CR:
-		case DUK_OP_GETPROPC_RC:
-		case DUK_OP_GETPROPC_CC:
-#endif
-		case DUK_OP_UNUSED207:
-		case DUK_OP_UNUSED212:
-		case DUK_OP_UNUSED213:
-		case DUK_OP_UNUSED214:
-		case DUK_OP_UNUSED215:
-		case DUK_OP_UNUSED216:
-		case DUK_OP_UNUSED217:
-		case DUK_OP_UNUSED218:
-		case DUK_OP_UNUSED219:
-		case DUK_OP_UNUSED220:
-		case DUK_OP_UNUSED221:
-		case DUK_OP_UNUSED222:
-		case DUK_OP_UNUSED223:
-		case DUK_OP_UNUSED224:
-		case DUK_OP_UNUSED225:
-		case DUK_OP_UNUSED226:
-		case DUK_OP_UNUSED227:
-		case DUK_OP_UNUSED228:
-		case DUK_OP_UNUSED229:
-		case DUK_OP_UNUSED230:
-		case DUK_OP_UNUSED231:
-		case DUK_OP_UNUSED232:
-		case DUK_OP_UNUSED233:
-		case DUK_OP_UNUSED234:
-		case DUK_OP_UNUSED235:
-		case DUK_OP_UNUSED236:
-		case DUK_OP_UNUSED237:
-		case DUK_OP_UNUSED238:
-		case DUK_OP_UNUSED239:
-		case DUK_OP_UNUSED240:
-		case DUK_OP_UNUSED241:
-		case DUK_OP_UNUSED242:
-		case DUK_OP_UNUSED243:
-		case DUK_OP_UNUSED244:
-		case DUK_OP_UNUSED245:
-		case DUK_OP_UNUSED246:
-		case DUK_OP_UNUSED247:
-		case DUK_OP_UNUSED248:
-		case DUK_OP_UNUSED249:
-		case DUK_OP_UNUSED250:
-		case DUK_OP_UNUSED251:
-		case DUK_OP_UNUSED252:
-		case DUK_OP_UNUSED253:
-		case DUK_OP_UNUSED254:
-		case DUK_OP_UNUSED255:
+		DUK__CASE(DUK_OP_GETPROPC_RR)
+		DUK__CASE(DUK_OP_GETPROPC_CR)
+		DUK__CASE(DUK_OP_GETPROPC_RC)
+		DUK__CASE(DUK_OP_GETPROPC_CC)
+#endif
+#if !defined(DUK_USE_REGEXP_SUPPORT)
+		DUK__CASE(DUK_OP_REGEXP_RR)
+		DUK__CASE(DUK_OP_REGEXP_CR)
+		DUK__CASE(DUK_OP_REGEXP_RC)
+		DUK__CASE(DUK_OP_REGEXP_CC)
+#endif
+		DUK__CASE(DUK_OP_DELPROP_CR_UNUSED)
+		DUK__CASE(DUK_OP_DELPROP_CC_UNUSED)
+		DUK__CASE(DUK_OP_UNUSED207)
+		DUK__CASE(DUK_OP_UNUSED214)
+		DUK__CASE(DUK_OP_UNUSED215)
+		DUK__CASE(DUK_OP_UNUSED216)
+		DUK__CASE(DUK_OP_UNUSED217)
+		DUK__CASE(DUK_OP_UNUSED218)
+		DUK__CASE(DUK_OP_UNUSED219)
+		DUK__CASE(DUK_OP_UNUSED220)
+		DUK__CASE(DUK_OP_UNUSED221)
+		DUK__CASE(DUK_OP_UNUSED222)
+		DUK__CASE(DUK_OP_UNUSED223)
+		DUK__CASE(DUK_OP_UNUSED224)
+		DUK__CASE(DUK_OP_UNUSED225)
+		DUK__CASE(DUK_OP_UNUSED226)
+		DUK__CASE(DUK_OP_UNUSED227)
+		DUK__CASE(DUK_OP_UNUSED228)
+		DUK__CASE(DUK_OP_UNUSED229)
+		DUK__CASE(DUK_OP_UNUSED230)
+		DUK__CASE(DUK_OP_UNUSED231)
+		DUK__CASE(DUK_OP_UNUSED232)
+		DUK__CASE(DUK_OP_UNUSED233)
+		DUK__CASE(DUK_OP_UNUSED234)
+		DUK__CASE(DUK_OP_UNUSED235)
+		DUK__CASE(DUK_OP_UNUSED236)
+		DUK__CASE(DUK_OP_UNUSED237)
+		DUK__CASE(DUK_OP_UNUSED238)
+		DUK__CASE(DUK_OP_UNUSED239)
+		DUK__CASE(DUK_OP_UNUSED240)
+		DUK__CASE(DUK_OP_UNUSED241)
+		DUK__CASE(DUK_OP_UNUSED242)
+		DUK__CASE(DUK_OP_UNUSED243)
+		DUK__CASE(DUK_OP_UNUSED244)
+		DUK__CASE(DUK_OP_UNUSED245)
+		DUK__CASE(DUK_OP_UNUSED246)
+		DUK__CASE(DUK_OP_UNUSED247)
+		DUK__CASE(DUK_OP_UNUSED248)
+		DUK__CASE(DUK_OP_UNUSED249)
+		DUK__CASE(DUK_OP_UNUSED250)
+		DUK__CASE(DUK_OP_UNUSED251)
+		DUK__CASE(DUK_OP_UNUSED252)
+		DUK__CASE(DUK_OP_UNUSED253)
+		DUK__CASE(DUK_OP_UNUSED254)
+		DUK__CASE(DUK_OP_UNUSED255)
 		/* Force all case clauses to map to an actual handler
 		 * so that the compiler can emit a jump without a bounds
 		 * check: the switch argument is a duk_uint8_t so that
@@ -78938,7 +81159,7 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 			/* Default case catches invalid/unsupported opcodes. */
 			DUK_D(DUK_DPRINT("invalid opcode: %ld - %!I", (long) op, ins));
 			DUK__INTERNAL_ERROR("invalid opcode");
-			break;
+			DUK__NEXT();
 		}
 
 		}  /* end switch */
@@ -78974,7 +81195,9 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 #undef DUK__BYTEOFF_B
 #undef DUK__BYTEOFF_BC
 #undef DUK__BYTEOFF_C
+#undef DUK__CASE
 #undef DUK__COMPARE_BODY
+#undef DUK__COMPUTED_GOTO
 #undef DUK__CONST
 #undef DUK__CONSTP
 #undef DUK__CONSTP_A
@@ -79004,7 +81227,13 @@ DUK_LOCAL DUK_NOINLINE DUK_HOT void duk__js_execute_bytecode_inner(duk_hthread *
 #undef DUK__MASK_BC
 #undef DUK__MASK_C
 #undef DUK__NEQ_BODY
+#undef DUK__NEXT
 #undef DUK__NOINLINE_PERF
+#undef DUK__OPLABEL
+#undef DUK__PROPCACHE_GET
+#undef DUK__PROPCACHE_PUT
+#undef DUK__PROPCACHE_SLOT
+#undef DUK__PROPCACHE_UPDATE
 #undef DUK__PUTPROP_BODY
 #undef DUK__RCBIT_B
 #undef DUK__RCBIT_C
@@ -80380,6 +82609,27 @@ DUK_INTERNAL duk_small_uint_t duk_js_typeof_stridx(duk_tval *tv_x) {
 	return stridx;
 }
 
+/*
+ *  Switch table hash
+ *
+ *  Hashes a string for the DUK_OP_SWITCHSTR dispatch table.  Unlike the
+ *  string table hash this is seedless, because the compiler computes it
+ *  for the case strings and the table may then be dumped and loaded into
+ *  another heap.  FNV-1a over at most 32 bytes, sampled from the end like
+ *  the string table hash, so long strings don't make dispatch slow.
+ */
+
+DUK_INTERNAL duk_uint32_t duk_js_switch_hash(const duk_uint8_t *str, duk_size_t blen) {
+	duk_uint32_t hash = 2166136261UL ^ (duk_uint32_t) blen;
+	duk_size_t step = (blen >> 5) + 1;
+	duk_size_t off;
+
+	for (off = blen; off >= step; off -= step) {
+		hash = (hash ^ str[off - 1]) * 16777619UL;
+	}
+	return hash ^ (hash >> 16);
+}
+
 /*
  *  Array index and length
  *
@@ -88298,7 +90548,7 @@ DUK_INTERNAL void duk_regexp_create_instance(duk_hthread *thr) {
 
 	/* [ ... regexp_object escaped_source bytecode ] */
 
-	DUK_HOBJECT_SET_CLASS_NUMBER(h, DUK_HOBJECT_CLASS_REGEXP);
+	duk_heap_hobject_set_class(thr->heap, h, DUK_HOBJECT_CLASS_REGEXP);
 	DUK_HOBJECT_SET_PROTOTYPE_UPDREF(thr, h, thr->builtins[DUK_BIDX_REGEXP_PROTOTYPE]);
 
 	duk_xdef_prop_stridx_short(thr, -3, DUK_STRIDX_INT_BYTECODE, DUK_PROPDESC_FLAGS_NONE);
@@ -97455,6 +99705,59 @@ DUK_INTERNAL DUK_INLINE duk_small_int_t duk_memcmp(const void *s1, const void *s
 	return DUK_MEMCMP(s1, s2, (size_t) len);
 }
 #endif  /* DUK_USE_ALLOW_UNDEFINED_BEHAVIOR */
+
+/* Find the first occurrence of 'q' in 'p', returning NULL if there is none.
+ * Candidate positions are those where both the first and the last byte of
+ * 'q' match, which rules out most positions without a memcmp(); with SSE2,
+ * 16 positions are filtered at a time.
+ */
+DUK_INTERNAL const duk_uint8_t *duk_memmem(const duk_uint8_t *p, duk_size_t p_len, const duk_uint8_t *q, duk_size_t q_len) {
+	duk_uint8_t q_first;
+	duk_uint8_t q_last;
+	duk_size_t npos;  /* number of candidate positions */
+	duk_size_t i;
+
+	DUK_ASSERT(p != NULL);
+	DUK_ASSERT(q != NULL);
+	DUK_ASSERT(q_len > 0);
+
+	if (p_len < q_len) {
+		return NULL;
+	}
+	npos = p_len - q_len + 1;
+	q_first = q[0];
+	q_last = q[q_len - 1];
+	i = 0;
+
+#if defined(DUK_USE_SSE2) && !defined(DUK_USE_PREFER_SIZE)
+	{
+		__m128i v_first = _mm_set1_epi8((char) q_first);
+		__m128i v_last = _mm_set1_epi8((char) q_last);
+
+		for (; npos - i >= 16; i += 16) {
+			__m128i b_first = _mm_loadu_si128((const __m128i *) (const void *) (p + i));
+			__m128i b_last = _mm_loadu_si128((const __m128i *) (const void *) (p + i + q_len - 1));
+			duk_uint_t mask = (duk_uint_t) _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(b_first, v_first),
+			                                                               _mm_cmpeq_epi8(b_last, v_last)));
+			duk_small_uint_t j;
+
+			for (j = 0; mask != 0; j++, mask >>= 1) {
+				if ((mask & 1U) && duk_memcmp_unsafe((const void *) (p + i + j + 1), (const void *) (q + 1), q_len - 1) == 0) {
+					return p + i + j;
+				}
+			}
+		}
+	}
+#endif  /* DUK_USE_SSE2 && !DUK_USE_PREFER_SIZE */
+
+	for (; i < npos; i++) {
+		if (p[i] == q_first && p[i + q_len - 1] == q_last &&
+		    duk_memcmp_unsafe((const void *) (p + i + 1), (const void *) (q + 1), q_len - 1) == 0) {
+			return p + i;
+		}
+	}
+	return NULL;
+}
 /*
  *  A tiny random number generator used for Math.random() and other internals.
  *
@@ -226,6 +226,7 @@ struct duk_memory_functions;
 struct duk_function_list_entry;
 struct duk_number_list_entry;
 struct duk_time_components;
+struct duk_heap_stats;
 
 /* duk_context is now defined in duk_config.h because it may also be
  * referenced there by prototypes.
@@ -235,6 +236,8 @@ typedef struct duk_memory_functions duk_memory_functions;
 typedef struct duk_function_list_entry duk_function_list_entry;
 typedef struct duk_number_list_entry duk_number_list_entry;
 typedef struct duk_time_components duk_time_components;
+typedef struct duk_heap_stats duk_heap_stats;
+typedef struct duk_callstack_frame duk_callstack_frame;
 
 typedef duk_ret_t (*duk_c_function)(duk_context *ctx);
 typedef void *(*duk_alloc_function) (void *udata, duk_size_t size);
@@ -251,6 +254,8 @@ typedef void (*duk_debug_read_flush_function) (void *udata);
 typedef void (*duk_debug_write_flush_function) (void *udata);
 typedef duk_idx_t (*duk_debug_request_function) (duk_context *ctx, void *udata, duk_idx_t nvalues);
 typedef void (*duk_debug_detached_function) (duk_context *ctx, void *udata);
+typedef void (*duk_interrupt_function) (duk_context *ctx, void *udata);
+typedef void (*duk_gc_pause_function) (void *udata, duk_uint_t flags, duk_double_t duration_ms);
 
 struct duk_thread_state {
 	/* XXX: Enough space to hold internal suspend/resume structure.
@@ -289,6 +294,47 @@ struct duk_time_components {
 	duk_double_t weekday;       /* weekday: 0-6, 0=Sunday, 1=Monday, ..., 6=Saturday */
 };
 
+/* Live heap counters, maintained on allocation and free (no heap walk).
+ * Objects are indexed by internal class number; their bytes cover the
+ * object structure and its property table.
+ */
+#define DUK_HEAP_STATS_NUM_CLASSES        32
+
+struct duk_heap_stats {
+	duk_size_t object_count[DUK_HEAP_STATS_NUM_CLASSES];
+	duk_size_t object_bytes[DUK_HEAP_STATS_NUM_CLASSES];
+	duk_size_t string_count;
+	duk_size_t string_bytes;
+	duk_size_t buffer_count;    /* plain buffers, including function bytecode */
+	duk_size_t buffer_bytes;    /* headers and data, except external data */
+	duk_size_t strtab_size;     /* string table slots */
+	duk_size_t litcache_hit;    /* literal cache lookups, cumulative */
+	duk_size_t litcache_miss;
+	duk_size_t propcache_hit;   /* GETPROP/PUTPROP own data property cache, cumulative */
+	duk_size_t propcache_miss;  /* only lookups which the cache could have served */
+	duk_size_t refzero_free_count;  /* heap objects freed by refcount, cumulative */
+	duk_size_t ms_free_count;       /* heap objects freed by mark-and-sweep, cumulative */
+	duk_size_t ms_count;            /* mark-and-sweep runs, cumulative */
+	duk_size_t valstack_used;       /* value stack entries in use by the calling thread */
+	duk_size_t valstack_reserved;   /* value stack entries allocated for the calling thread */
+	duk_size_t callstack_depth;     /* activations of the calling thread */
+	duk_size_t callstack_peak;      /* deepest activation count seen on any thread */
+};
+
+/* One activation of the calling thread, as read by duk_get_callstack_frames().
+ * The strings point into the heap and aren't NUL terminated; they're only
+ * valid until the next call into Duktape.
+ */
+struct duk_callstack_frame {
+	void *function;             /* heap pointer of the called function, NULL for a lightfunc */
+	const char *name;           /* own 'name' data property, NULL if none */
+	duk_size_t name_len;
+	const char *file_name;      /* own 'fileName' data property, NULL if none */
+	duk_size_t file_name_len;
+	duk_uint_t start_line;      /* line of the function's first instruction, 0 if unknown */
+	duk_bool_t is_native;       /* native function or lightfunc */
+};
+
 /*
  *  Constants
  */
@@ -371,6 +417,7 @@ struct duk_time_components {
 #define DUK_COMPILE_STRLEN                (1U << 10)   /* (internal) take strlen() of src_buffer (avoids double evaluation in macro) */
 #define DUK_COMPILE_NOFILENAME            (1U << 11)   /* (internal) no filename on stack */
 #define DUK_COMPILE_FUNCEXPR              (1U << 12)   /* (internal) source is a function expression (used for Function constructor) */
+#define DUK_COMPILE_OPTIMIZE              (1U << 13)   /* run the bytecode optimizer (slower compile, for code that is cached or run often) */
 
 /* Flags for duk_def_prop() and its variants; base flags + a lot of convenience shorthands */
 #define DUK_DEFPROP_WRITABLE              (1U << 0)    /* set writable (effective if DUK_DEFPROP_HAVE_WRITABLE set) */
@@ -519,6 +566,10 @@ DUK_EXTERNAL_DECL void duk_free(duk_context *ctx, void *ptr);
 DUK_EXTERNAL_DECL void *duk_realloc(duk_context *ctx, void *ptr, duk_size_t size);
 DUK_EXTERNAL_DECL void duk_get_memory_functions(duk_context *ctx, duk_memory_functions *out_funcs);
 DUK_EXTERNAL_DECL void duk_gc(duk_context *ctx, duk_uint_t flags);
+DUK_EXTERNAL_DECL void duk_set_gc_trigger(duk_context *ctx, duk_int_t mult, duk_int_t add);
+DUK_EXTERNAL_DECL void duk_set_gc_pause_handler(duk_context *ctx, duk_gc_pause_function func, void *udata);
+DUK_EXTERNAL_DECL void duk_get_heap_stats(duk_context *ctx, duk_heap_stats *out_stats);
+DUK_EXTERNAL_DECL void duk_set_interrupt_handler(duk_context *ctx, duk_interrupt_function func, void *udata, duk_int_t interval);
 
 /*
  *  Error handling
@@ -1126,6 +1177,7 @@ DUK_EXTERNAL_DECL duk_bool_t duk_put_global_heapptr(duk_context *ctx, void *ptr)
 
 DUK_EXTERNAL_DECL void duk_inspect_value(duk_context *ctx, duk_idx_t idx);
 DUK_EXTERNAL_DECL void duk_inspect_callstack_entry(duk_context *ctx, duk_int_t level);
+DUK_EXTERNAL_DECL duk_int_t duk_get_callstack_frames(duk_context *ctx, duk_callstack_frame *out_frames, duk_int_t max_frames);
 
 /*
  *  Object prototype
@@ -7,7 +7,14 @@
  #error "Incorrect use of JUCE cpp file"
 #endif
 
-#include "daw_duktape.h"
+#include "squarepine_duktape.h"
+
+/* Duktape is compiled inside the namespace below, so the intrinsics header its
+   config includes for SSE2 targets must have been included at global scope first.
+*/
+#if defined (__SSE2__) || defined (_M_X64) || defined (_M_AMD64) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2))
+ #include <emmintrin.h>
+#endif
 
 namespace duktape
 {
@@ -40,4 +47,7 @@ namespace duktape
 
 	#include "core/ECMAScriptEngine_Duktape.cpp"
 	#include "core/ECMAScriptEngine.cpp"
+	#include "core/ECMAScriptModuleResolver.cpp"
+	#include "core/ECMAScriptProfile.cpp"
+	#include "core/ECMAScriptLogSink.cpp"
 }
@@ -18,6 +18,97 @@
 //==============================================================================
 #include <juce_events/juce_events.h>
 
+//==============================================================================
+/** Config: SQUAREPINE_DUKTAPE_USE_FASTINT
+
+    Enables Duktape's fastint support (DUK_USE_FASTINT), where integer values are
+    stored and operated on as 48-bit integers instead of going through doubles.
+    This helps integer-heavy scripts (indexing, bit manipulation, counters) at the
+    cost of a few extra checks on floating point arithmetic.
+
+    Requires 64-bit integer support; this is silently ignored on compilers without it.
+*/
+#ifndef SQUAREPINE_DUKTAPE_USE_FASTINT
+ #define SQUAREPINE_DUKTAPE_USE_FASTINT 0
+#endif
+
+/** Config: SQUAREPINE_DUKTAPE_USE_JSON_FASTLANE
+
+    Moves large data-only arrays and objects between vars and the engine as a single
+    JSON document instead of one API call per property, and enables Duktape's
+    JSON.stringify() fast path (DUK_USE_JSON_STRINGIFY_FASTPATH) which backs it.
+
+    @see ECMAScriptEngine::setBulkTransferThreshold
+*/
+#ifndef SQUAREPINE_DUKTAPE_USE_JSON_FASTLANE
+ #define SQUAREPINE_DUKTAPE_USE_JSON_FASTLANE 1
+#endif
+
+/** Config: SQUAREPINE_DUKTAPE_ENABLE_PROFILER
+
+    Enables Duktape's opcode interrupt counter (DUK_USE_INTERRUPT_COUNTER) in release
+    builds so that the sampling profiler can be used. Debug builds always have it.
+    The counter costs a decrement and a branch per executed opcode.
+
+    @see ECMAScriptEngine::startProfiling
+*/
+#ifndef SQUAREPINE_DUKTAPE_ENABLE_PROFILER
+ #define SQUAREPINE_DUKTAPE_ENABLE_PROFILER 0
+#endif
+
+/** Config: SQUAREPINE_DUKTAPE_USE_EXTERNAL_STRINGS
+
+    Enables Duktape's external string data (DUK_USE_HSTRING_EXTDATA), so that strings
+    registered with ECMAScriptEngine::registerExternalString() point at the native text
+    instead of being copied into each engine's string table. This saves the memory of
+    large embedded resources, at the cost of a flag check on string data accesses.
+
+    @see ECMAScriptEngine::registerExternalString
+*/
+#ifndef SQUAREPINE_DUKTAPE_USE_EXTERNAL_STRINGS
+ #define SQUAREPINE_DUKTAPE_USE_EXTERNAL_STRINGS 0
+#endif
+
+/** Config: SQUAREPINE_DUKTAPE_USE_PROPERTY_CACHE
+
+    Gives each property access in a script a small cache of where it last found its
+    property, so that reading and writing fields of objects built the same way skips
+    the property table search. References to global variables (including registered
+    natives) from global code and top level functions are cached the same way, which
+    skips the scope chain lookup. Costs about 2 KB per engine.
+
+    @see ECMAScriptEngine::HeapStatistics::propertyCacheHitRate
+*/
+#ifndef SQUAREPINE_DUKTAPE_USE_PROPERTY_CACHE
+ #define SQUAREPINE_DUKTAPE_USE_PROPERTY_CACHE 1
+#endif
+
+/** Config: SQUAREPINE_DUKTAPE_USE_COMPUTED_GOTO
+
+    Experimental: makes the bytecode interpreter dispatch opcodes through a table of
+    label addresses (DUK_USE_EXEC_COMPUTED_GOTO) instead of its switch statement.
+    Whether that helps depends on the CPU's branch predictor and the compiler, and it
+    can be slower; measure it with the interpreter benchmarks before turning it on.
+    This needs the labels-as-values extension of GCC and Clang; other compilers keep
+    using the switch.
+*/
+#ifndef SQUAREPINE_DUKTAPE_USE_COMPUTED_GOTO
+ #define SQUAREPINE_DUKTAPE_USE_COMPUTED_GOTO 0
+#endif
+
+/** Config: SQUAREPINE_DUKTAPE_OPTIMIZE_BYTECODE
+
+    Runs Duktape's bytecode optimizer (DUK_COMPILE_OPTIMIZE) over modules loaded with
+    require(). It threads jumps, folds constant expressions and removes redundant
+    register moves and unreachable code, which makes compiling slower but the code a
+    little smaller and faster. Modules are compiled once and their bytecode is kept,
+    so the cost is paid once per module; evaluated code is left as it is.
+*/
+#ifndef SQUAREPINE_DUKTAPE_OPTIMIZE_BYTECODE
+ #define SQUAREPINE_DUKTAPE_OPTIMIZE_BYTECODE 1
+#endif
+
+#include <string_view>
 #include <unordered_map>
 
 //==============================================================================
@@ -25,6 +116,9 @@ namespace duktape
 {
     using namespace juce;
 
+    #include "core/ECMAScriptModuleResolver.h"
+    #include "core/ECMAScriptProfile.h"
+    #include "core/ECMAScriptLogSink.h"
     #include "core/ECMAScriptEngine.h"
 }
 